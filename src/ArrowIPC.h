@@ -0,0 +1,1081 @@
+#ifndef ARROWIPC_H
+#define ARROWIPC_H
+
+#include <array>
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstring>
+#include <cstdint>
+#include <cstdio>
+#include <algorithm>
+
+#include "Employee.h"
+#include "RoleRegistry.h"
+#include "ColumnSnapshot.h"
+#include "RosterIO.h"
+#include "AsyncIO.h"
+#include "ShardedStore.h"
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#error "ArrowIPC 按小端字节序写出缓冲区"
+#endif
+
+/**
+ * 列式导出/导入 (ArrowIPC)
+ * - 以 .arrow 结尾的路径按 Apache Arrow IPC 文件格式（Feather V2，未压缩）读写，
+ *   pyarrow / DuckDB / Polars 等可直接 mmap 读取，无需解析文本
+ * - 列：id(int32)、name(utf8)、role(字典编码 utf8)、level(int32)、gender(字典编码 utf8)、
+ *   birthday(date32，空生日为 null)、managerId(int32，无上级为 null)，
+ *   以及各岗位 kParamKeys 的并集（float64，岗位不使用的列为 null），
+ *   数值按 double 原样保存，不经过两位小数的文本格式
+ * - 导出直接把列式快照 (ColumnSnapshot) 的数组作为 Arrow 缓冲区写出，不逐行调用 toCSV()；
+ *   参数列每行只取一次 getParams()
+ * - 元数据是手写的最小 FlatBuffers 编码（Schema / DictionaryBatch / RecordBatch / Footer），不依赖 Arrow 库；
+ *   导入时校验所有偏移与长度，损坏的文件返回 Corrupt 而不会越界读取
+ * - 导入按行区间并行构造员工对象；接受任意列顺序、多个记录批次，字符串列可以是普通或字典编码
+ */
+namespace arrow_ipc {
+
+inline bool isArrowPath(const std::string& path) {
+    return path.size() > 6 && path.compare(path.size() - 6, 6, ".arrow") == 0;
+}
+
+namespace detail {
+
+static constexpr char kMagic[] = "ARROW1";       // 文件首尾各一份，文件头另补 2 字节对齐到 8
+static constexpr int16_t kMetadataV5 = 4;
+static constexpr size_t kBodyAlignment = 64;  // 缓冲区在消息体内按 64 字节对齐，便于 SIMD 读取
+
+// Arrow Schema.fbs / Message.fbs 中用到的枚举值
+enum TypeId : uint8_t { kTypeInt = 2, kTypeFloatingPoint = 3, kTypeBinary = 4, kTypeUtf8 = 5, kTypeBool = 6,
+                        kTypeDecimal = 7, kTypeDate = 8, kTypeTime = 9, kTypeTimestamp = 10, kTypeInterval = 11,
+                        kTypeFixedSizeBinary = 15, kTypeDuration = 18, kTypeLargeBinary = 19, kTypeLargeUtf8 = 20 };
+enum HeaderType : uint8_t { kHeaderSchema = 1, kHeaderDictionaryBatch = 2, kHeaderRecordBatch = 3 };
+static constexpr int16_t kPrecisionDouble = 2;
+static constexpr int16_t kDateUnitDay = 0;
+
+// ========== 日期 <-> 1970-01-01 起的天数 ==========
+
+inline int32_t daysFromCivil(int y, unsigned m, unsigned d) {
+    y -= m <= 2;
+    const int era = (y >= 0 ? y : y - 399) / 400;
+    const unsigned yoe = static_cast<unsigned>(y - era * 400);
+    const unsigned doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<int32_t>(doe) - 719468;
+}
+
+inline void civilFromDays(int32_t z, int& y, unsigned& m, unsigned& d) {
+    z += 719468;
+    const int era = (z >= 0 ? z : z - 146096) / 146097;
+    const unsigned doe = static_cast<unsigned>(z - era * 146097);
+    const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    y = static_cast<int>(yoe) + era * 400;
+    const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const unsigned mp = (5 * doy + 2) / 153;
+    d = doy - (153 * mp + 2) / 5 + 1;
+    m = mp < 10 ? mp + 3 : mp - 9;
+    y += m <= 2;
+}
+
+// yyyymmdd -> 天数；日历上不存在的日期（如 2 月 31 日）返回 false
+inline bool dateCodeToDays(int32_t code, int32_t& days) {
+    int y = code / 10000;
+    unsigned m = static_cast<unsigned>(code / 100 % 100), d = static_cast<unsigned>(code % 100);
+    days = daysFromCivil(y, m, d);
+    int y2;
+    unsigned m2, d2;
+    civilFromDays(days, y2, m2, d2);
+    return y2 == y && m2 == m && d2 == d;
+}
+
+inline std::string daysToDate(int32_t days) {
+    int y;
+    unsigned m, d;
+    civilFromDays(days, y, m, d);
+    char buf[48];
+    std::snprintf(buf, sizeof(buf), "%04d-%02u-%02u", y, m, d);
+    return buf;
+}
+
+// ========== FlatBuffers 编码 ==========
+
+// 从后往前构建的 FlatBuffers 缓冲区（与官方实现的布局规则相同）：
+// 子对象先于引用它的表写入，偏移以“距缓冲区末尾的字节数”记录
+class FlatBuilder {
+public:
+    uint32_t size() const { return static_cast<uint32_t>(buf_.size() - head_); }
+
+    // 填充到：再写入 additional 字节后，已写入的总长度是 alignment 的倍数
+    void prep(size_t alignment, size_t additional) {
+        minAlign_ = std::max(minAlign_, alignment);
+        size_t padding = (~(static_cast<size_t>(size()) + additional) + 1) & (alignment - 1);
+        static const char zeros[16] = {};
+        pushBytes(zeros, padding);
+    }
+
+    template <typename T>
+    void push(T value) {
+        prep(sizeof(T), 0);
+        pushBytes(&value, sizeof(T));
+    }
+
+    void pushOffset(uint32_t target) {
+        prep(4, 0);
+        uint32_t value = size() + 4 - target;
+        pushBytes(&value, 4);
+    }
+
+    uint32_t string(const std::string& s) {
+        prep(4, s.size() + 1);
+        pushBytes("", 1);
+        pushBytes(s.data(), s.size());
+        uint32_t length = static_cast<uint32_t>(s.size());
+        pushBytes(&length, 4);
+        return size();
+    }
+
+    uint32_t offsetVector(const std::vector<uint32_t>& targets) {
+        prep(4, 4 * targets.size());
+        for (size_t i = targets.size(); i-- > 0;) pushOffset(targets[i]);
+        uint32_t count = static_cast<uint32_t>(targets.size());
+        pushBytes(&count, 4);
+        return size();
+    }
+
+    // 结构体数组：elements 为 count 个紧密排列、按 alignment 对齐的结构体
+    uint32_t structVector(const void* elements, size_t count, size_t elementSize, size_t alignment) {
+        prep(4, elementSize * count);
+        prep(alignment, elementSize * count);
+        pushBytes(elements, elementSize * count);
+        uint32_t n = static_cast<uint32_t>(count);
+        pushBytes(&n, 4);
+        return size();
+    }
+
+    void startTable() {
+        fields_.clear();
+        tableStart_ = size();
+    }
+
+    template <typename T>
+    void addScalar(int slot, T value) {
+        push(value);
+        fields_.push_back(FieldLoc{slot, size()});
+    }
+
+    void addOffset(int slot, uint32_t target) {
+        pushOffset(target);
+        fields_.push_back(FieldLoc{slot, size()});
+    }
+
+    uint32_t endTable() {
+        push<int32_t>(0);  // 指向 vtable 的偏移，vtable 写好后回填
+        uint32_t table = size();
+        int slots = 0;
+        for (const FieldLoc& f : fields_) slots = std::max(slots, f.slot + 1);
+        std::vector<uint16_t> vtable(static_cast<size_t>(slots), 0);
+        for (const FieldLoc& f : fields_) vtable[static_cast<size_t>(f.slot)] = static_cast<uint16_t>(table - f.loc);
+        for (size_t i = vtable.size(); i-- > 0;) push<uint16_t>(vtable[i]);
+        push<uint16_t>(static_cast<uint16_t>(table - tableStart_));
+        push<uint16_t>(static_cast<uint16_t>((slots + 2) * 2));
+        int32_t toVtable = static_cast<int32_t>(size()) - static_cast<int32_t>(table);
+        std::memcpy(&buf_[buf_.size() - table], &toVtable, 4);
+        return table;
+    }
+
+    std::string finish(uint32_t root) {
+        prep(minAlign_, 4);
+        pushOffset(root);
+        return std::string(buf_.begin() + static_cast<std::ptrdiff_t>(head_), buf_.end());
+    }
+
+private:
+    struct FieldLoc { int slot; uint32_t loc; };
+
+    std::vector<char> buf_ = std::vector<char>(1024);
+    size_t head_ = 1024;
+    size_t minAlign_ = 1;
+    uint32_t tableStart_ = 0;
+    std::vector<FieldLoc> fields_;
+
+    void pushBytes(const void* data, size_t n) {
+        if (head_ < n) {
+            size_t used = buf_.size() - head_;
+            size_t capacity = std::max(buf_.size() * 2, used + n);
+            std::vector<char> grown(capacity);
+            std::memcpy(grown.data() + capacity - used, buf_.data() + head_, used);
+            buf_.swap(grown);
+            head_ = capacity - used;
+        }
+        head_ -= n;
+        if (n) std::memcpy(&buf_[head_], data, n);
+    }
+};
+
+// 只读的 FlatBuffers 视图：所有读取都做边界检查，越界时置 bad 并返回零值
+struct FlatView {
+    const uint8_t* data;
+    size_t size;
+    mutable bool bad = false;
+
+    template <typename T>
+    T read(size_t pos) const {
+        T value{};
+        if (pos > size || size - pos < sizeof(T)) {
+            bad = true;
+            return value;
+        }
+        std::memcpy(&value, data + pos, sizeof(T));
+        return value;
+    }
+
+    // pos 处的 uoffset 指向的位置
+    size_t deref(size_t pos) const {
+        size_t target = pos + read<uint32_t>(pos);
+        if (target >= size) bad = true;
+        return target;
+    }
+};
+
+class Table {
+public:
+    Table() = default;
+    Table(const FlatView* view, size_t pos) : view_(view), pos_(pos) {
+        int32_t toVtable = view->read<int32_t>(pos);
+        long long vtable = static_cast<long long>(pos) - toVtable;
+        if (vtable < 0 || static_cast<size_t>(vtable) >= view->size) {
+            view->bad = true;
+            view_ = nullptr;
+            return;
+        }
+        vtable_ = static_cast<size_t>(vtable);
+        vtableSize_ = view->read<uint16_t>(vtable_);
+    }
+
+    bool valid() const { return view_ != nullptr; }
+
+    template <typename T>
+    T scalar(int slot, T fallback) const {
+        size_t offset = fieldOffset(slot);
+        return offset ? view_->read<T>(pos_ + offset) : fallback;
+    }
+
+    Table table(int slot) const {
+        size_t offset = fieldOffset(slot);
+        return offset ? Table(view_, view_->deref(pos_ + offset)) : Table();
+    }
+
+    // 数组：返回元素起始位置与个数；字段缺失时返回 false
+    bool vector(int slot, size_t& elements, uint32_t& count) const {
+        size_t offset = fieldOffset(slot);
+        if (!offset) return false;
+        size_t pos = view_->deref(pos_ + offset);
+        count = view_->read<uint32_t>(pos);
+        elements = pos + 4;
+        return !view_->bad;
+    }
+
+    std::string string(int slot) const {
+        size_t elements;
+        uint32_t length;
+        if (!vector(slot, elements, length)) return std::string();
+        if (elements + length > view_->size) {
+            view_->bad = true;
+            return std::string();
+        }
+        return std::string(reinterpret_cast<const char*>(view_->data + elements), length);
+    }
+
+    // 表数组中的第 i 个元素
+    Table element(size_t elements, uint32_t i) const {
+        return Table(view_, view_->deref(elements + 4 * static_cast<size_t>(i)));
+    }
+
+private:
+    const FlatView* view_ = nullptr;
+    size_t pos_ = 0;
+    size_t vtable_ = 0;
+    uint16_t vtableSize_ = 0;
+
+    size_t fieldOffset(int slot) const {
+        if (!view_) return 0;
+        size_t entry = 4 + 2 * static_cast<size_t>(slot);
+        return entry + 2 <= vtableSize_ ? view_->read<uint16_t>(vtable_ + entry) : 0;
+    }
+};
+
+// ========== Arrow 消息结构 ==========
+
+struct FieldNode { int64_t length; int64_t nullCount; };
+struct BufferSpec { int64_t offset; int64_t length; };
+struct Block { int64_t offset; int32_t metaDataLength; int32_t padding; int64_t bodyLength; };
+
+// 导出时的一列
+struct ColumnOut {
+    enum Kind { Int32, Utf8, Float64, Date32, DictUtf8 };
+    ColumnOut(Kind k, const std::string& n) : kind(k), name(n) {}
+
+    Kind kind;
+    std::string name;
+    bool nullable = false;
+    int64_t dictionaryId = -1;
+    int64_t nullCount = 0;
+    // 消息体中的缓冲区（按 Arrow 规定的顺序：有效位图、数据/偏移、字符）
+    std::vector<std::pair<const void*, size_t>> buffers;
+};
+
+inline uint32_t buildIntType(FlatBuilder& b, int32_t bitWidth, bool isSigned) {
+    b.startTable();
+    b.addScalar<int32_t>(0, bitWidth);
+    b.addScalar<uint8_t>(1, isSigned ? 1 : 0);
+    return b.endTable();
+}
+
+inline uint32_t buildField(FlatBuilder& b, const ColumnOut& c) {
+    uint32_t name = b.string(c.name);
+    uint8_t typeId = kTypeUtf8;
+    b.startTable();
+    switch (c.kind) {
+        case ColumnOut::Int32:
+            b.addScalar<int32_t>(0, 32);
+            b.addScalar<uint8_t>(1, 1);
+            typeId = kTypeInt;
+            break;
+        case ColumnOut::Float64:
+            b.addScalar<int16_t>(0, kPrecisionDouble);
+            typeId = kTypeFloatingPoint;
+            break;
+        case ColumnOut::Date32:
+            b.addScalar<int16_t>(0, kDateUnitDay);
+            typeId = kTypeDate;
+            break;
+        case ColumnOut::Utf8:
+        case ColumnOut::DictUtf8:
+            break;
+    }
+    uint32_t type = b.endTable();
+    uint32_t dictionary = 0;
+    if (c.kind == ColumnOut::DictUtf8) {
+        uint32_t indexType = buildIntType(b, 8, true);
+        b.startTable();
+        b.addScalar<int64_t>(0, c.dictionaryId);
+        b.addOffset(1, indexType);
+        b.addScalar<uint8_t>(2, 0);
+        dictionary = b.endTable();
+    }
+    uint32_t children = b.offsetVector({});
+
+    b.startTable();
+    b.addOffset(0, name);
+    b.addScalar<uint8_t>(1, c.nullable ? 1 : 0);
+    b.addScalar<uint8_t>(2, typeId);
+    b.addOffset(3, type);
+    if (dictionary) b.addOffset(4, dictionary);
+    b.addOffset(5, children);
+    return b.endTable();
+}
+
+inline uint32_t buildSchema(FlatBuilder& b, const std::vector<ColumnOut>& columns) {
+    std::vector<uint32_t> fields;
+    for (const ColumnOut& c : columns) fields.push_back(buildField(b, c));
+    uint32_t vec = b.offsetVector(fields);
+    b.startTable();
+    b.addScalar<int16_t>(0, 0);  // 小端
+    b.addOffset(1, vec);
+    return b.endTable();
+}
+
+inline size_t alignUp(size_t n, size_t alignment) { return (n + alignment - 1) / alignment * alignment; }
+
+// 计算一组列在消息体中的布局，返回消息体长度
+inline int64_t layoutBody(const std::vector<const ColumnOut*>& columns, std::vector<BufferSpec>& buffers) {
+    size_t offset = 0;
+    for (const ColumnOut* c : columns) {
+        for (const auto& buf : c->buffers) {
+            buffers.push_back(BufferSpec{static_cast<int64_t>(offset), static_cast<int64_t>(buf.second)});
+            offset = alignUp(offset + buf.second, kBodyAlignment);
+        }
+    }
+    return static_cast<int64_t>(offset);
+}
+
+inline uint32_t buildRecordBatch(FlatBuilder& b, int64_t length, const std::vector<FieldNode>& nodes,
+                                 const std::vector<BufferSpec>& buffers) {
+    uint32_t nodeVec = b.structVector(nodes.data(), nodes.size(), sizeof(FieldNode), 8);
+    uint32_t bufferVec = b.structVector(buffers.data(), buffers.size(), sizeof(BufferSpec), 8);
+    b.startTable();
+    b.addScalar<int64_t>(0, length);
+    b.addOffset(1, nodeVec);
+    b.addOffset(2, bufferVec);
+    return b.endTable();
+}
+
+inline std::string buildMessage(FlatBuilder& b, uint8_t headerType, uint32_t header, int64_t bodyLength) {
+    b.startTable();
+    b.addScalar<int16_t>(0, kMetadataV5);
+    b.addScalar<uint8_t>(1, headerType);
+    b.addOffset(2, header);
+    b.addScalar<int64_t>(3, bodyLength);
+    return b.finish(b.endTable());
+}
+
+// 按 Arrow IPC 文件格式顺序写出，并记录各消息的位置
+class FileOut {
+public:
+    explicit FileOut(async_io::FileWriter& out) : out_(out) {}
+
+    void write(const void* data, size_t size) {
+        out_.write(static_cast<const char*>(data), size);
+        offset_ += size;
+    }
+
+    void zeros(size_t n) {
+        static const char zero[kBodyAlignment] = {};
+        for (; n > 0; n -= std::min(n, kBodyAlignment)) write(zero, std::min(n, kBodyAlignment));
+    }
+
+    // 写出一条封装消息（0xFFFFFFFF、元数据长度、FlatBuffers 元数据、消息体），返回其位置
+    // 元数据补齐到使消息体从 64 字节边界开始，mmap 后各缓冲区在内存中同样对齐
+    Block message(const std::string& metadata, const std::vector<const ColumnOut*>& columns, int64_t bodyLength) {
+        Block block{static_cast<int64_t>(offset_), 0, 0, bodyLength};
+        uint32_t continuation = 0xFFFFFFFFu;
+        size_t bodyStart = alignUp(offset_ + 8 + metadata.size(), kBodyAlignment);
+        int32_t length = static_cast<int32_t>(bodyStart - offset_ - 8);
+        write(&continuation, 4);
+        write(&length, 4);
+        write(metadata.data(), metadata.size());
+        zeros(bodyStart - offset_);
+        block.metaDataLength = 8 + length;
+        for (const ColumnOut* c : columns) {
+            for (const auto& buf : c->buffers) {
+                write(buf.first, buf.second);
+                zeros(bodyStart + alignUp(offset_ - bodyStart, kBodyAlignment) - offset_);
+            }
+        }
+        return block;
+    }
+
+    uint64_t offset() const { return offset_; }
+
+private:
+    async_io::FileWriter& out_;
+    uint64_t offset_ = 0;
+};
+
+// 有效位图（LSB 在前）；全部有效时返回空位图
+inline std::vector<uint8_t> validityBitmap(size_t n, const std::vector<bool>& valid, int64_t& nullCount) {
+    nullCount = 0;
+    std::vector<uint8_t> bits(alignUp((n + 7) / 8, 8), 0);
+    for (size_t i = 0; i < n; ++i) {
+        if (valid[i]) bits[i >> 3] |= static_cast<uint8_t>(1u << (i & 7));
+        else ++nullCount;
+    }
+    if (nullCount == 0) bits.clear();
+    return bits;
+}
+
+// 各岗位参数列名的并集（按岗位登记顺序、列序），以及 (岗位, 参数列) -> 列序号
+struct ParamColumns {
+    std::vector<std::string> names;
+    std::array<std::array<int, 3>, roles::kCount> index;
+
+    ParamColumns() {
+        for (uint8_t r = 0; r < roles::kCount; ++r) {
+            for (int j = 0; j < 3; ++j) {
+                const char* key = roles::paramKeys(r)[j];
+                index[r][j] = -1;
+                if (!key) continue;
+                auto it = std::find(names.begin(), names.end(), key);
+                index[r][j] = static_cast<int>(it - names.begin());
+                if (it == names.end()) names.push_back(key);
+            }
+        }
+    }
+};
+
+} // namespace detail
+
+/**
+ * 把全部员工写成 Arrow IPC 文件（经 async_io 先写临时文件、fsync 后替换目标）
+ * columns 须是 employees 的当前快照（行号一一对应）
+ */
+inline bool write(const std::string& path, const ColumnSnapshot& columns,
+                  const std::vector<std::unique_ptr<Employee>>& employees, uint64_t* bytesWritten = nullptr) {
+    using detail::ColumnOut;
+    const size_t n = columns.rows();
+
+    // 字典：role 的编码即 RoleRegistry 登记顺序，快照里的岗位编码可直接作为字典下标
+    std::vector<std::string> roleNames;
+    for (uint8_t r = 0; r < roles::kCount; ++r) roleNames.emplace_back(roles::name(r));
+    static_assert(roles::kCount < 128, "岗位编码须能作为 int8 字典下标");
+    const std::vector<std::string> genderNames = {"男", "女"};  // 与 ColumnSnapshot::GenderCode 一致
+
+    std::vector<bool> valid(n);
+    auto bitmap = [&](ColumnOut& c, std::vector<uint8_t>& storage) {
+        storage = detail::validityBitmap(n, valid, c.nullCount);
+        c.nullable = true;
+        c.buffers.emplace_back(storage.data(), storage.size());
+    };
+
+    std::vector<ColumnOut> out;
+    out.reserve(7 + 8);
+    auto column = [&](ColumnOut::Kind kind, const std::string& name) -> ColumnOut& {
+        out.push_back(ColumnOut{kind, name});
+        return out.back();
+    };
+
+    ColumnOut& id = column(ColumnOut::Int32, "id");
+    id.buffers = {{nullptr, 0}, {columns.id.data(), n * 4}};
+
+    ColumnOut& name = column(ColumnOut::Utf8, "name");
+    static_assert(sizeof(columns.nameOffset[0]) == 4, "姓名偏移按 int32 写出");
+    name.buffers = {{nullptr, 0}, {columns.nameOffset.data(), (n + 1) * 4}, {columns.namePool.data(), columns.namePool.size()}};
+
+    std::vector<uint8_t> roleValidity;
+    ColumnOut& role = column(ColumnOut::DictUtf8, "role");
+    role.dictionaryId = 0;
+    for (size_t i = 0; i < n; ++i) valid[i] = columns.role[i] < roles::kCount;
+    bitmap(role, roleValidity);
+    role.buffers.emplace_back(columns.role.data(), n);
+
+    ColumnOut& level = column(ColumnOut::Int32, "level");
+    level.buffers = {{nullptr, 0}, {columns.level.data(), n * 4}};
+
+    std::vector<uint8_t> genderValidity;
+    ColumnOut& gender = column(ColumnOut::DictUtf8, "gender");
+    gender.dictionaryId = 1;
+    for (size_t i = 0; i < n; ++i) valid[i] = columns.gender[i] < genderNames.size();
+    bitmap(gender, genderValidity);
+    gender.buffers.emplace_back(columns.gender.data(), n);
+
+    // 生日：yyyymmdd -> 天数；空生日与日历上不存在的日期为 null
+    std::vector<int32_t> days(n, 0);
+    std::vector<uint8_t> birthdayValidity;
+    for (size_t i = 0; i < n; ++i) {
+        valid[i] = columns.birthday[i] != 0 && detail::dateCodeToDays(columns.birthday[i], days[i]);
+        if (!valid[i]) days[i] = 0;
+    }
+    ColumnOut& birthday = column(ColumnOut::Date32, "birthday");
+    bitmap(birthday, birthdayValidity);
+    birthday.buffers.emplace_back(days.data(), n * 4);
+
+    // 上级编号：快照中无上级为 0，写出为 null（数据缓冲区直接使用快照数组）
+    std::vector<uint8_t> managerValidity;
+    for (size_t i = 0; i < n; ++i) valid[i] = columns.managerId[i] != 0;
+    ColumnOut& manager = column(ColumnOut::Int32, "managerId");
+    bitmap(manager, managerValidity);
+    manager.buffers.emplace_back(columns.managerId.data(), n * 4);
+
+    // 参数列：每行取一次 getParams()，按岗位的 kParamKeys 分到对应列
+    static const detail::ParamColumns params;
+    std::vector<std::vector<double>> paramValues(params.names.size(), std::vector<double>(n, 0.0));
+    std::vector<std::vector<bool>> paramValid(params.names.size(), std::vector<bool>(n, false));
+    for (size_t i = 0; i < n; ++i) {
+        uint8_t r = columns.role[i];
+        if (r >= roles::kCount) continue;
+        std::array<double, 3> p = employees[i]->getParams();
+        for (int j = 0; j < 3; ++j) {
+            int c = params.index[r][static_cast<size_t>(j)];
+            if (c < 0) continue;
+            paramValues[static_cast<size_t>(c)][i] = p[static_cast<size_t>(j)];
+            paramValid[static_cast<size_t>(c)][i] = true;
+        }
+    }
+    std::vector<std::vector<uint8_t>> paramValidity(params.names.size());
+    for (size_t c = 0; c < params.names.size(); ++c) {
+        ColumnOut& col = column(ColumnOut::Float64, params.names[c]);
+        valid = paramValid[c];
+        bitmap(col, paramValidity[c]);
+        col.buffers.emplace_back(paramValues[c].data(), n * 8);
+    }
+
+    // 字典批次的内容
+    auto dictionaryColumn = [](const std::vector<std::string>& values, std::vector<int32_t>& offsets, std::string& chars) {
+        offsets.assign(1, 0);
+        chars.clear();
+        for (const std::string& v : values) {
+            chars += v;
+            offsets.push_back(static_cast<int32_t>(chars.size()));
+        }
+        ColumnOut c{ColumnOut::Utf8, "dictionary"};
+        c.buffers = {{nullptr, 0}, {offsets.data(), offsets.size() * 4}, {chars.data(), chars.size()}};
+        return c;
+    };
+    std::vector<int32_t> roleOffsets, genderOffsets;
+    std::string roleChars, genderChars;
+    ColumnOut roleDictionary = dictionaryColumn(roleNames, roleOffsets, roleChars);
+    ColumnOut genderDictionary = dictionaryColumn(genderNames, genderOffsets, genderChars);
+
+    async_io::FileWriter file;
+    if (!file.open(path)) return false;
+    detail::FileOut fout(file);
+    fout.write("ARROW1\0\0", 8);
+
+    detail::FlatBuilder schemaBuilder;
+    uint32_t schema = detail::buildSchema(schemaBuilder, out);
+    fout.message(detail::buildMessage(schemaBuilder, detail::kHeaderSchema, schema, 0), {}, 0);
+
+    std::vector<detail::Block> dictionaryBlocks;
+    const std::pair<int64_t, const ColumnOut*> dictionaries[] = {{0, &roleDictionary}, {1, &genderDictionary}};
+    for (const auto& dict : dictionaries) {
+        std::vector<detail::BufferSpec> buffers;
+        int64_t body = detail::layoutBody({dict.second}, buffers);
+        int64_t count = static_cast<int64_t>(dict.second->buffers[1].second / 4 - 1);
+        detail::FlatBuilder b;
+        uint32_t batch = detail::buildRecordBatch(b, count, {detail::FieldNode{count, 0}}, buffers);
+        b.startTable();
+        b.addScalar<int64_t>(0, dict.first);
+        b.addOffset(1, batch);
+        b.addScalar<uint8_t>(2, 0);
+        uint32_t header = b.endTable();
+        dictionaryBlocks.push_back(fout.message(detail::buildMessage(b, detail::kHeaderDictionaryBatch, header, body),
+                                                {dict.second}, body));
+    }
+
+    std::vector<const ColumnOut*> all;
+    std::vector<detail::FieldNode> nodes;
+    for (const ColumnOut& c : out) {
+        all.push_back(&c);
+        nodes.push_back(detail::FieldNode{static_cast<int64_t>(n), c.nullCount});
+    }
+    std::vector<detail::BufferSpec> buffers;
+    int64_t body = detail::layoutBody(all, buffers);
+    detail::FlatBuilder b;
+    uint32_t batch = detail::buildRecordBatch(b, static_cast<int64_t>(n), nodes, buffers);
+    std::vector<detail::Block> batchBlocks = {
+        fout.message(detail::buildMessage(b, detail::kHeaderRecordBatch, batch, body), all, body)};
+
+    // 流结束标记，之后是文件尾：Footer、Footer 长度、魔数
+    const uint32_t endOfStream[2] = {0xFFFFFFFFu, 0};
+    fout.write(endOfStream, 8);
+    detail::FlatBuilder f;
+    uint32_t footerSchema = detail::buildSchema(f, out);
+    uint32_t dictVec = f.structVector(dictionaryBlocks.data(), dictionaryBlocks.size(), sizeof(detail::Block), 8);
+    uint32_t batchVec = f.structVector(batchBlocks.data(), batchBlocks.size(), sizeof(detail::Block), 8);
+    f.startTable();
+    f.addScalar<int16_t>(0, detail::kMetadataV5);
+    f.addOffset(1, footerSchema);
+    f.addOffset(2, dictVec);
+    f.addOffset(3, batchVec);
+    std::string footer = f.finish(f.endTable());
+    fout.write(footer.data(), footer.size());
+    int32_t footerLength = static_cast<int32_t>(footer.size());
+    fout.write(&footerLength, 4);
+    fout.write(detail::kMagic, 6);
+
+    if (bytesWritten) *bytesWritten = fout.offset();
+    return file.commit();
+}
+
+namespace detail {
+
+// 导入时的一列
+struct ColumnIn {
+    std::string name;
+    uint8_t type = 0;
+    int32_t bitWidth = 0;        // Int 的位宽 / 字典下标位宽
+    int16_t precision = -1;      // FloatingPoint
+    int16_t dateUnit = -1;       // Date
+    int64_t dictionaryId = -1;   // >= 0 表示字典编码
+    int buffers = 0;             // 该列在记录批次中占用的缓冲区个数
+
+    // 当前记录批次中的数据
+    const uint8_t* validity = nullptr;
+    const uint8_t* values = nullptr;
+    size_t valuesBytes = 0;
+    const uint8_t* chars = nullptr;
+    size_t charsBytes = 0;
+    const std::vector<std::string>* dictionary = nullptr;
+
+    bool isValid(size_t i) const { return !validity || (validity[i >> 3] >> (i & 7) & 1); }
+
+    int64_t integer(size_t i) const {
+        switch (bitWidth) {
+            case 8: return static_cast<int8_t>(values[i]);
+            case 16: { int16_t v; std::memcpy(&v, values + 2 * i, 2); return v; }
+            case 32: { int32_t v; std::memcpy(&v, values + 4 * i, 4); return v; }
+            default: { int64_t v; std::memcpy(&v, values + 8 * i, 8); return v; }
+        }
+    }
+
+    double real(size_t i) const {
+        double v;
+        std::memcpy(&v, values + 8 * i, 8);
+        return v;
+    }
+
+    // 字符串列（普通或字典编码）的第 i 个值；非法时返回 false
+    bool text(size_t i, const char*& data, size_t& size) const {
+        if (dictionary) {
+            int64_t index = integer(i);
+            if (index < 0 || static_cast<size_t>(index) >= dictionary->size()) return false;
+            data = (*dictionary)[static_cast<size_t>(index)].data();
+            size = (*dictionary)[static_cast<size_t>(index)].size();
+            return true;
+        }
+        int32_t begin, end;
+        std::memcpy(&begin, values + 4 * i, 4);
+        std::memcpy(&end, values + 4 * (i + 1), 4);
+        if (begin < 0 || end < begin || static_cast<size_t>(end) > charsBytes) return false;
+        data = reinterpret_cast<const char*>(chars) + begin;
+        size = static_cast<size_t>(end - begin);
+        return true;
+    }
+};
+
+inline bool isStringType(uint8_t type) { return type == kTypeUtf8 || type == kTypeBinary; }
+
+// 读取 Schema 中的列定义；遇到嵌套或不支持的类型时返回 false
+inline bool readSchema(const Table& schema, std::vector<ColumnIn>& columns, std::string& error) {
+    size_t elements;
+    uint32_t count;
+    if (!schema.valid() || !schema.vector(1, elements, count)) {
+        error = "缺少 Schema";
+        return false;
+    }
+    for (uint32_t i = 0; i < count; ++i) {
+        Table field = schema.element(elements, i);
+        if (!field.valid()) return false;
+        ColumnIn c;
+        c.name = field.string(0);
+        c.type = field.scalar<uint8_t>(2, 0);
+        Table type = field.table(3);
+        size_t childElements;
+        uint32_t children = 0;
+        if (field.vector(5, childElements, children) && children > 0) {
+            error = "不支持嵌套列: " + c.name;
+            return false;
+        }
+        switch (c.type) {
+            case kTypeInt:
+                c.bitWidth = type.scalar<int32_t>(0, 0);
+                c.buffers = 2;
+                break;
+            case kTypeFloatingPoint:
+                c.precision = type.scalar<int16_t>(0, 0);
+                c.buffers = 2;
+                break;
+            case kTypeDate:
+                c.dateUnit = type.scalar<int16_t>(0, 1);
+                c.buffers = 2;
+                break;
+            case kTypeBool: case kTypeDecimal: case kTypeTime: case kTypeTimestamp:
+            case kTypeInterval: case kTypeFixedSizeBinary: case kTypeDuration:
+                c.buffers = 2;
+                break;
+            case kTypeUtf8: case kTypeBinary: case kTypeLargeUtf8: case kTypeLargeBinary:
+                c.buffers = 3;
+                break;
+            default:
+                error = "不支持的列类型: " + c.name;
+                return false;
+        }
+        Table dictionary = field.table(4);
+        if (dictionary.valid()) {
+            c.dictionaryId = dictionary.scalar<int64_t>(0, 0);
+            c.bitWidth = dictionary.table(1).valid() ? dictionary.table(1).scalar<int32_t>(0, 32) : 32;
+            c.buffers = 2;
+        }
+        columns.push_back(std::move(c));
+    }
+    return true;
+}
+
+} // namespace detail
+
+namespace detail {
+
+// 一条封装消息：FlatBuffers 元数据与消息体
+struct MessageIn {
+    FlatView view{nullptr, 0};
+    Table table;
+    const uint8_t* body = nullptr;
+    size_t bodyLength = 0;
+};
+
+inline bool readMessage(const uint8_t* data, size_t size, const Block& block, MessageIn& m) {
+    if (block.offset < 8 || block.metaDataLength < 8 || block.bodyLength < 0 ||
+        static_cast<uint64_t>(block.offset) + static_cast<uint64_t>(block.metaDataLength) +
+                static_cast<uint64_t>(block.bodyLength) > size) {
+        return false;
+    }
+    const uint8_t* p = data + block.offset;
+    uint32_t first;
+    std::memcpy(&first, p, 4);
+    size_t prefix = first == 0xFFFFFFFFu ? 8 : 4;  // 旧格式没有 0xFFFFFFFF 前缀
+    m.view = FlatView{p + prefix, static_cast<size_t>(block.metaDataLength) - prefix};
+    m.table = Table(&m.view, m.view.deref(0));
+    m.body = p + block.metaDataLength;
+    m.bodyLength = static_cast<size_t>(block.bodyLength);
+    return m.table.valid() && !m.view.bad;
+}
+
+// 记录批次：行数、各列节点与缓冲区位置
+struct BatchIn {
+    int64_t length = 0;
+    std::vector<FieldNode> nodes;
+    std::vector<BufferSpec> buffers;
+    const uint8_t* body = nullptr;
+    size_t bodyLength = 0;
+
+    bool buffer(size_t k, const uint8_t*& p, size_t& bytes) const {
+        if (k >= buffers.size()) return false;
+        const BufferSpec& b = buffers[k];
+        if (b.offset < 0 || b.length < 0 ||
+            static_cast<uint64_t>(b.offset) + static_cast<uint64_t>(b.length) > bodyLength) {
+            return false;
+        }
+        p = body + b.offset;
+        bytes = static_cast<size_t>(b.length);
+        return true;
+    }
+};
+
+inline bool readBatch(const MessageIn& m, const Table& batch, BatchIn& out) {
+    out.length = batch.scalar<int64_t>(0, 0);
+    size_t elements;
+    uint32_t count;
+    if (!batch.vector(1, elements, count) || elements + count * sizeof(FieldNode) > m.view.size) return false;
+    out.nodes.resize(count);
+    if (count) std::memcpy(out.nodes.data(), m.view.data + elements, count * sizeof(FieldNode));
+    if (!batch.vector(2, elements, count) || elements + count * sizeof(BufferSpec) > m.view.size) return false;
+    out.buffers.resize(count);
+    if (count) std::memcpy(out.buffers.data(), m.view.data + elements, count * sizeof(BufferSpec));
+    out.body = m.body;
+    out.bodyLength = m.bodyLength;
+    return out.length >= 0 && !m.view.bad;
+}
+
+// 把列绑定到记录批次的缓冲区（从第 first 个缓冲区开始），并检查长度足够 n 行
+inline bool bindColumn(ColumnIn& c, const BatchIn& batch, size_t node, size_t first) {
+    const size_t n = static_cast<size_t>(batch.length);
+    const uint8_t* p;
+    size_t bytes;
+    c.validity = nullptr;
+    if (node >= batch.nodes.size() || !batch.buffer(first, p, bytes)) return false;
+    if (batch.nodes[node].nullCount > 0) {
+        if (bytes < (n + 7) / 8) return false;
+        c.validity = p;
+    }
+    if (!batch.buffer(first + 1, c.values, c.valuesBytes)) return false;
+    size_t width = 0;
+    if (c.dictionaryId >= 0 || c.type == kTypeInt) width = static_cast<size_t>(c.bitWidth) / 8;
+    else if (c.type == kTypeFloatingPoint) width = c.precision == kPrecisionDouble ? 8 : 4;
+    else if (c.type == kTypeDate) width = c.dateUnit == kDateUnitDay ? 4 : 8;
+    else if (isStringType(c.type)) width = 4;
+    if (isStringType(c.type) && c.dictionaryId < 0) {
+        if (c.valuesBytes < (n + 1) * 4 || !batch.buffer(first + 2, c.chars, c.charsBytes)) return false;
+    } else if (c.valuesBytes < n * width) {
+        return false;
+    }
+    return true;
+}
+
+// 列是否能按期望的类别读取
+enum class Want { Integer, Number, Text, Date };
+
+inline bool usable(const ColumnIn& c, Want want) {
+    bool dictionary = c.dictionaryId >= 0;
+    bool intWidth = c.bitWidth == 8 || c.bitWidth == 16 || c.bitWidth == 32 || c.bitWidth == 64;
+    switch (want) {
+        case Want::Integer: return !dictionary && c.type == kTypeInt && intWidth;
+        case Want::Number:
+            return !dictionary && ((c.type == kTypeInt && intWidth) ||
+                                   (c.type == kTypeFloatingPoint && (c.precision == 1 || c.precision == kPrecisionDouble)));
+        case Want::Text: return isStringType(c.type) && (!dictionary || intWidth);
+        case Want::Date: return !dictionary && c.type == kTypeDate;
+    }
+    return false;
+}
+
+inline double number(const ColumnIn& c, size_t i) {
+    if (c.type == kTypeInt) return static_cast<double>(c.integer(i));
+    if (c.precision == kPrecisionDouble) return c.real(i);
+    float v;
+    std::memcpy(&v, c.values + 4 * i, 4);
+    return v;
+}
+
+inline std::string birthdayAt(const ColumnIn& c, size_t i) {
+    if (c.dateUnit == kDateUnitDay) {
+        int32_t days;
+        std::memcpy(&days, c.values + 4 * i, 4);
+        return daysToDate(days);
+    }
+    int64_t ms;
+    std::memcpy(&ms, c.values + 8 * i, 8);
+    return daysToDate(static_cast<int32_t>(ms / 86400000));
+}
+
+} // namespace detail
+
+/**
+ * 读取 Arrow IPC 文件，按行构造员工对象（追加到 out）
+ * 必需列：id、role；缺失的其他列取默认值（姓名/性别/生日为空，级别为 1，参数为 0）
+ * failures 返回被跳过的行数（编号为空、岗位未登记等）
+ */
+inline roster_io::ReadStatus read(const std::string& path, std::vector<std::unique_ptr<Employee>>& out,
+                                  size_t* failures = nullptr, std::string* error = nullptr) {
+    using detail::ColumnIn;
+    using detail::Want;
+    roster_io::MappedRoster file;
+    roster_io::ReadStatus status = file.open(path, error);
+    if (status != roster_io::ReadStatus::Ok) return status;
+
+    auto corrupt = [&](const std::string& why) {
+        if (error) *error = why;
+        return roster_io::ReadStatus::Corrupt;
+    };
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(file.data());
+    const size_t size = file.size();
+    if (size < 8 + 10 || std::memcmp(data, detail::kMagic, 6) != 0 ||
+        std::memcmp(data + size - 6, detail::kMagic, 6) != 0) {
+        return corrupt("不是 Arrow IPC 文件");
+    }
+    int32_t footerLength;
+    std::memcpy(&footerLength, data + size - 10, 4);
+    if (footerLength <= 0 || static_cast<size_t>(footerLength) > size - 18) return corrupt("文件尾长度错误");
+
+    detail::FlatView footerView{data + size - 10 - footerLength, static_cast<size_t>(footerLength)};
+    detail::Table footer(&footerView, footerView.deref(0));
+    std::vector<ColumnIn> columns;
+    std::string reason;
+    if (!footer.valid() || !detail::readSchema(footer.table(1), columns, reason) || footerView.bad) {
+        return corrupt(reason.empty() ? "文件尾损坏" : reason);
+    }
+    auto readBlocks = [&](int slot, std::vector<detail::Block>& blocks) {
+        size_t elements;
+        uint32_t count;
+        if (!footer.vector(slot, elements, count)) return true;
+        if (elements + static_cast<size_t>(count) * sizeof(detail::Block) > footerView.size) return false;
+        blocks.resize(count);
+        if (count) std::memcpy(blocks.data(), footerView.data + elements, blocks.size() * sizeof(detail::Block));
+        return true;
+    };
+    std::vector<detail::Block> dictionaryBlocks, batchBlocks;
+    if (!readBlocks(2, dictionaryBlocks) || !readBlocks(3, batchBlocks)) return corrupt("文件尾损坏");
+
+    // 字典：编号 -> 取值
+    std::vector<std::pair<int64_t, std::vector<std::string>>> dictionaries;
+    for (const detail::Block& block : dictionaryBlocks) {
+        detail::MessageIn m;
+        detail::BatchIn batch;
+        if (!detail::readMessage(data, size, block, m) ||
+            m.table.scalar<uint8_t>(1, 0) != detail::kHeaderDictionaryBatch) {
+            return corrupt("字典消息损坏");
+        }
+        detail::Table header = m.table.table(2);
+        if (header.table(1).table(3).valid()) return corrupt("不支持压缩的消息体");
+        if (!header.valid() || !detail::readBatch(m, header.table(1), batch)) return corrupt("字典消息损坏");
+        ColumnIn values;
+        values.type = detail::kTypeUtf8;
+        if (!detail::bindColumn(values, batch, 0, 0)) return corrupt("字典消息损坏");
+        int64_t id = header.scalar<int64_t>(0, 0);
+        auto it = std::find_if(dictionaries.begin(), dictionaries.end(), [&](const auto& d) { return d.first == id; });
+        if (it == dictionaries.end()) {
+            dictionaries.emplace_back(id, std::vector<std::string>());
+            it = dictionaries.end() - 1;
+        }
+        if (!header.scalar<uint8_t>(2, 0)) it->second.clear();  // 非增量字典替换已有内容
+        for (size_t i = 0; i < static_cast<size_t>(batch.length); ++i) {
+            const char* s;
+            size_t n;
+            if (!values.text(i, s, n)) return corrupt("字典消息损坏");
+            it->second.emplace_back(s, n);
+        }
+    }
+    for (ColumnIn& c : columns) {
+        if (c.dictionaryId < 0) continue;
+        for (const auto& d : dictionaries) {
+            if (d.first == c.dictionaryId) c.dictionary = &d.second;
+        }
+        if (!c.dictionary) return corrupt("缺少字典: " + c.name);
+    }
+
+    // 按列名找到需要的列
+    auto find = [&](const std::string& name, Want want) -> ColumnIn* {
+        for (ColumnIn& c : columns) {
+            if (c.name == name) return detail::usable(c, want) ? &c : nullptr;
+        }
+        return nullptr;
+    };
+    ColumnIn* id = find("id", Want::Integer);
+    ColumnIn* role = find("role", Want::Text);
+    if (!id || !role) return corrupt("缺少 id 或 role 列");
+    ColumnIn* name = find("name", Want::Text);
+    ColumnIn* level = find("level", Want::Integer);
+    ColumnIn* gender = find("gender", Want::Text);
+    ColumnIn* birthday = find("birthday", Want::Date);
+    ColumnIn* manager = find("managerId", Want::Integer);
+    std::array<std::array<ColumnIn*, 3>, roles::kCount> params{};
+    for (uint8_t r = 0; r < roles::kCount; ++r) {
+        for (size_t j = 0; j < 3; ++j) {
+            const char* key = roles::paramKeys(r)[j];
+            params[r][j] = key ? find(key, Want::Number) : nullptr;
+        }
+    }
+
+    size_t skipped = 0;
+    for (const detail::Block& block : batchBlocks) {
+        detail::MessageIn m;
+        detail::BatchIn batch;
+        if (!detail::readMessage(data, size, block, m) ||
+            m.table.scalar<uint8_t>(1, 0) != detail::kHeaderRecordBatch) {
+            return corrupt("记录批次损坏");
+        }
+        if (m.table.table(2).table(3).valid()) return corrupt("不支持压缩的消息体");
+        if (!detail::readBatch(m, m.table.table(2), batch)) return corrupt("记录批次损坏");
+        size_t buffer = 0;
+        for (size_t k = 0; k < columns.size(); ++k) {
+            if (!detail::bindColumn(columns[k], batch, k, buffer)) return corrupt("记录批次损坏: " + columns[k].name);
+            buffer += static_cast<size_t>(columns[k].buffers);
+        }
+
+        // 按行区间并行构造员工对象，再按原顺序拼接
+        const size_t rows = static_cast<size_t>(batch.length);
+        constexpr size_t kRowsPerTask = 1 << 16;
+        size_t tasks = (rows + kRowsPerTask - 1) / kRowsPerTask;
+        std::vector<std::vector<std::unique_ptr<Employee>>> parts(tasks);
+        std::vector<size_t> partFailures(tasks, 0);
+        ShardedStore::forEachShardParallel(tasks, [&](size_t t) {
+            size_t begin = t * kRowsPerTask, end = std::min(rows, begin + kRowsPerTask);
+            parts[t].reserve(end - begin);
+            const char* s;
+            size_t n;
+            for (size_t i = begin; i < end; ++i) {
+                uint8_t code = id->isValid(i) && role->isValid(i) && role->text(i, s, n)
+                                   ? roles::code(std::string_view(s, n)) : roles::kUnknown;
+                std::unique_ptr<Employee> emp = roles::create(code);
+                if (!emp) {
+                    ++partFailures[t];
+                    continue;
+                }
+                emp->setId(static_cast<int>(id->integer(i)));
+                if (name && name->isValid(i) && name->text(i, s, n)) emp->setName(std::string(s, n));
+                if (level && level->isValid(i)) emp->setLevel(static_cast<int>(level->integer(i)));
+                if (gender && gender->isValid(i) && gender->text(i, s, n)) emp->setGender(std::string(s, n));
+                if (birthday && birthday->isValid(i)) emp->setBirthday(detail::birthdayAt(*birthday, i));
+                if (manager && manager->isValid(i)) emp->setManagerId(static_cast<int>(manager->integer(i)));
+                std::array<double, 3> p{};
+                for (size_t j = 0; j < 3; ++j) {
+                    const ColumnIn* c = params[code][j];
+                    if (c && c->isValid(i)) p[j] = detail::number(*c, i);
+                }
+                emp->setParams(p);
+                parts[t].push_back(std::move(emp));
+            }
+        });
+        for (size_t t = 0; t < tasks; ++t) {
+            for (auto& emp : parts[t]) out.push_back(std::move(emp));
+            skipped += partFailures[t];
+        }
+    }
+    if (failures) *failures = skipped;
+    return roster_io::ReadStatus::Ok;
+}
+
+} // namespace arrow_ipc
+
+#endif // ARROWIPC_H
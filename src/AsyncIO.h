@@ -0,0 +1,667 @@
+#ifndef ASYNCIO_H
+#define ASYNCIO_H
+
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <algorithm>
+#include <initializer_list>
+
+#ifndef _WIN32
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#define HR_HAVE_IO_URING 1
+#endif
+#endif
+
+/**
+ * 大块异步文件读写 (AsyncIO)
+ * - Linux 上直接通过系统调用使用 io_uring（不依赖 liburing）：读取时同时挂起 kDepth 个 1MB 的
+ *   对齐读请求，按文件顺序把完成的块交给调用方解析，解析期间其余请求仍在进行；
+ *   写入时把数据攒成 1MB 的块，以注册缓冲区 (WRITE_FIXED) 批量提交，最多 kDepth 个同时在途
+ * - 内核不支持 io_uring（或被禁用）时退回 pread/pwrite：后台线程按块 pread，调用方线程同时解析；
+ *   写入以 1MB 为单位 pwrite。Windows 上以文件流按块读写
+ * - 写入先写到“目标路径.tmp”，全部完成后 fsync 再 rename 覆盖目标，中途失败不会损坏原文件
+ * - 环境变量 HR_IO_BACKEND=pread 可强制使用回退实现（用于对比与排查）
+ */
+namespace async_io {
+
+static constexpr size_t kBlockSize = 1 << 20;
+static constexpr unsigned kDepth = 4;
+static constexpr size_t kAlignment = 4096;
+
+enum class Status { Ok, NotFound, Failed };
+
+namespace detail {
+
+// 按 kAlignment 对齐的块缓冲区
+class AlignedBuffer {
+public:
+    AlignedBuffer() = default;
+    AlignedBuffer(const AlignedBuffer&) = delete;
+    AlignedBuffer& operator=(const AlignedBuffer&) = delete;
+    ~AlignedBuffer() { release(); }
+
+    bool allocate(size_t size) {
+        release();
+#ifdef _WIN32
+        data_ = static_cast<char*>(_aligned_malloc(size, kAlignment));
+#else
+        void* p = nullptr;
+        data_ = ::posix_memalign(&p, kAlignment, size) == 0 ? static_cast<char*>(p) : nullptr;
+#endif
+        return data_ != nullptr;
+    }
+
+    char* data() const { return data_; }
+
+private:
+    char* data_ = nullptr;
+
+    void release() {
+#ifdef _WIN32
+        _aligned_free(data_);
+#else
+        std::free(data_);
+#endif
+        data_ = nullptr;
+    }
+};
+
+inline bool forcePread() {
+    const char* backend = std::getenv("HR_IO_BACKEND");
+    return backend && std::strcmp(backend, "pread") == 0;
+}
+
+#ifdef HR_HAVE_IO_URING
+
+// 最小的 io_uring 封装：单线程使用，提交队列与完成队列各一
+class Ring {
+public:
+    Ring() = default;
+    Ring(const Ring&) = delete;
+    Ring& operator=(const Ring&) = delete;
+    ~Ring() { close(); }
+
+    bool init(unsigned entries) {
+        close();
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        fd_ = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+        if (fd_ < 0) return false;
+
+        sqRingSize_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cqRingSize_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        bool single = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (single) sqRingSize_ = cqRingSize_ = std::max(sqRingSize_, cqRingSize_);
+
+        sqRing_ = ::mmap(nullptr, sqRingSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQ_RING);
+        if (sqRing_ == MAP_FAILED) return fail();
+        cqRing_ = single ? sqRing_
+                         : ::mmap(nullptr, cqRingSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_CQ_RING);
+        if (cqRing_ == MAP_FAILED) return fail();
+        sqesSize_ = params.sq_entries * sizeof(io_uring_sqe);
+        void* sqes = ::mmap(nullptr, sqesSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQES);
+        if (sqes == MAP_FAILED) return fail();
+        sqes_ = static_cast<io_uring_sqe*>(sqes);
+
+        char* sq = static_cast<char*>(sqRing_);
+        sqHead_ = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+        sqTail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sqMask_ = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sqArray_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        sqEntries_ = params.sq_entries;
+        char* cq = static_cast<char*>(cqRing_);
+        cqHead_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cqTail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cqMask_ = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+        return true;
+    }
+
+    void close() {
+        if (sqes_) ::munmap(sqes_, sqesSize_);
+        if (cqRing_ && cqRing_ != MAP_FAILED && cqRing_ != sqRing_) ::munmap(cqRing_, cqRingSize_);
+        if (sqRing_ && sqRing_ != MAP_FAILED) ::munmap(sqRing_, sqRingSize_);
+        if (fd_ >= 0) ::close(fd_);
+        sqes_ = nullptr;
+        sqRing_ = cqRing_ = nullptr;
+        fd_ = -1;
+        localTail_ = 0;
+    }
+
+    bool registerBuffers(const iovec* iov, unsigned count) {
+        return ::syscall(__NR_io_uring_register, fd_, IORING_REGISTER_BUFFERS, iov, count) == 0;
+    }
+
+    // 内核是否支持给定的操作（IORING_REGISTER_PROBE 自 5.6 起可用，更早的内核视为不支持）
+    bool supports(std::initializer_list<unsigned> ops) {
+        std::vector<char> storage(sizeof(io_uring_probe) + 256 * sizeof(io_uring_probe_op), 0);
+        io_uring_probe* probe = reinterpret_cast<io_uring_probe*>(storage.data());
+        if (::syscall(__NR_io_uring_register, fd_, IORING_REGISTER_PROBE, probe, 256) != 0) return false;
+        for (unsigned op : ops) {
+            if (op > probe->last_op || !(probe->ops[op].flags & IO_URING_OP_SUPPORTED)) return false;
+        }
+        return true;
+    }
+
+    // 取一个空闲的提交项（已清零）；队列满时返回 nullptr
+    io_uring_sqe* next() {
+        unsigned head = __atomic_load_n(sqHead_, __ATOMIC_ACQUIRE);
+        if (localTail_ - head >= sqEntries_) return nullptr;
+        unsigned index = localTail_ & sqMask_;
+        io_uring_sqe* sqe = &sqes_[index];
+        std::memset(sqe, 0, sizeof(*sqe));
+        sqArray_[index] = index;
+        ++localTail_;
+        return sqe;
+    }
+
+    // 提交已准备的请求，并至少等待 waitFor 个完成事件
+    bool submit(unsigned waitFor) {
+        unsigned pending = localTail_ - __atomic_load_n(sqTail_, __ATOMIC_RELAXED);
+        __atomic_store_n(sqTail_, localTail_, __ATOMIC_RELEASE);
+        while (true) {
+            long r = ::syscall(__NR_io_uring_enter, fd_, pending, waitFor, waitFor ? IORING_ENTER_GETEVENTS : 0, nullptr, 0);
+            if (r >= 0) return true;
+            if (errno != EINTR) return false;
+            pending = 0;
+        }
+    }
+
+    // 取出一个完成事件；没有时返回 false
+    bool pop(uint64_t& userData, int& result) {
+        unsigned head = *cqHead_;
+        if (head == __atomic_load_n(cqTail_, __ATOMIC_ACQUIRE)) return false;
+        const io_uring_cqe& cqe = cqes_[head & cqMask_];
+        userData = cqe.user_data;
+        result = cqe.res;
+        __atomic_store_n(cqHead_, head + 1, __ATOMIC_RELEASE);
+        return true;
+    }
+
+    // 等待并取出一个完成事件
+    bool wait(uint64_t& userData, int& result) {
+        while (!pop(userData, result)) {
+            if (!submit(1)) return false;
+        }
+        return true;
+    }
+
+private:
+    int fd_ = -1;
+    void* sqRing_ = nullptr;
+    void* cqRing_ = nullptr;
+    size_t sqRingSize_ = 0, cqRingSize_ = 0, sqesSize_ = 0;
+    io_uring_sqe* sqes_ = nullptr;
+    unsigned* sqHead_ = nullptr;
+    unsigned* sqTail_ = nullptr;
+    unsigned* sqArray_ = nullptr;
+    unsigned sqMask_ = 0, sqEntries_ = 0, localTail_ = 0;
+    unsigned* cqHead_ = nullptr;
+    unsigned* cqTail_ = nullptr;
+    unsigned cqMask_ = 0;
+    io_uring_cqe* cqes_ = nullptr;
+
+    bool fail() {
+        close();
+        return false;
+    }
+};
+
+#endif // HR_HAVE_IO_URING
+
+// 用临时文件覆盖目标文件
+inline bool replaceFile(const std::string& tmp, const std::string& path) {
+#ifdef _WIN32
+    std::remove(path.c_str());  // Windows 上 rename 不覆盖已有文件
+#endif
+    return std::rename(tmp.c_str(), path.c_str()) == 0;
+}
+
+} // namespace detail
+
+// 当前进程实际使用的读写实现
+inline const char* backendName() {
+#ifdef HR_HAVE_IO_URING
+    static const bool uring = [] {
+        if (detail::forcePread()) return false;
+        detail::Ring ring;
+        return ring.init(kDepth) && ring.supports({IORING_OP_READ, IORING_OP_WRITE, IORING_OP_WRITE_FIXED});
+    }();
+    if (uring) return "io_uring";
+#endif
+#ifdef _WIN32
+    return "stream";
+#else
+    return "pread";
+#endif
+}
+
+/**
+ * 顺序读取整个文件，按文件顺序对每个块调用 fn(const char* data, size_t size)
+ * 块指针只在回调期间有效；fn 抛出异常时等待在途请求结束后再向外传播
+ */
+template <typename Fn>
+Status readFile(const std::string& path, Fn fn, std::string* error = nullptr) {
+#ifdef _WIN32
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) return Status::NotFound;
+    std::vector<char> block(kBlockSize);
+    while (in.read(block.data(), static_cast<std::streamsize>(block.size())) || in.gcount() > 0) {
+        fn(block.data(), static_cast<size_t>(in.gcount()));
+    }
+    return Status::Ok;
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return errno == ENOENT ? Status::NotFound : Status::Failed;
+    struct FdGuard {
+        int fd;
+        ~FdGuard() { ::close(fd); }
+    } guard{fd};
+    struct stat st;
+    if (::fstat(fd, &st) != 0) return Status::Failed;
+    uint64_t size = static_cast<uint64_t>(st.st_size);
+    if (size == 0) return Status::Ok;
+
+    detail::AlignedBuffer buffers[kDepth];
+    for (auto& b : buffers) {
+        if (!b.allocate(kBlockSize)) return Status::Failed;
+    }
+    uint64_t blocks = (size + kBlockSize - 1) / kBlockSize;
+    auto blockBytes = [&](uint64_t b) { return static_cast<size_t>(std::min<uint64_t>(kBlockSize, size - b * kBlockSize)); };
+
+#ifdef HR_HAVE_IO_URING
+    detail::Ring ring;
+    if (std::strcmp(backendName(), "io_uring") == 0 && ring.init(kDepth * 2)) {
+        // 槽 s 依次读取第 s, s+kDepth, s+2*kDepth... 块；filled[s] 为已读入的字节数
+        size_t filled[kDepth] = {};
+        unsigned inFlight = 0;
+        bool failed = false;
+        auto queueRead = [&](unsigned slot, uint64_t block) {
+            io_uring_sqe* sqe = ring.next();
+            sqe->opcode = IORING_OP_READ;
+            sqe->fd = fd;
+            sqe->off = block * kBlockSize + filled[slot];
+            sqe->addr = reinterpret_cast<uint64_t>(buffers[slot].data() + filled[slot]);
+            sqe->len = static_cast<unsigned>(blockBytes(block) - filled[slot]);
+            sqe->user_data = slot;
+            ++inFlight;
+        };
+        // 异常或出错退出前必须等在途请求结束，缓冲区才能释放
+        struct Drain {
+            detail::Ring& ring;
+            unsigned& inFlight;
+            ~Drain() {
+                uint64_t slot;
+                int res;
+                while (inFlight && ring.wait(slot, res)) --inFlight;
+            }
+        } drain{ring, inFlight};
+
+        for (unsigned s = 0; s < kDepth && s < blocks; ++s) queueRead(s, s);
+        if (!ring.submit(0)) return Status::Failed;
+        for (uint64_t block = 0; block < blocks && !failed; ++block) {
+            unsigned slot = static_cast<unsigned>(block % kDepth);
+            size_t want = blockBytes(block);
+            while (filled[slot] < want) {
+                uint64_t done;
+                int res;
+                if (!ring.wait(done, res)) {
+                    failed = true;
+                    break;
+                }
+                --inFlight;
+                if (res <= 0) {
+                    if (error) *error = res < 0 ? std::strerror(-res) : "文件被截断";
+                    failed = true;
+                    break;
+                }
+                filled[done] += static_cast<size_t>(res);
+                // 短读：补读剩余部分
+                uint64_t doneBlock = block + (done + kDepth - slot) % kDepth;
+                if (filled[done] < blockBytes(doneBlock)) {
+                    queueRead(static_cast<unsigned>(done), doneBlock);
+                    ring.submit(0);
+                }
+            }
+            if (failed) break;
+            fn(buffers[slot].data(), want);
+            filled[slot] = 0;
+            if (block + kDepth < blocks) {
+                queueRead(slot, block + kDepth);
+                ring.submit(0);
+            }
+        }
+        return failed ? Status::Failed : Status::Ok;
+    }
+#endif
+
+    // 回退实现：后台线程按块 pread，调用方线程同时处理已读入的块
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::deque<unsigned> ready;  // 已读入、待处理的槽
+    unsigned freeSlots = kDepth;
+    size_t lengths[kDepth] = {};
+    bool done = false, cancelled = false, failed = false;
+    std::thread reader([&] {
+        for (uint64_t block = 0; block < blocks; ++block) {
+            unsigned slot = static_cast<unsigned>(block % kDepth);
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                changed.wait(lock, [&] { return freeSlots > 0 || cancelled; });
+                if (cancelled) break;
+                --freeSlots;
+            }
+            size_t want = blockBytes(block), got = 0;
+            while (got < want) {
+                ssize_t n = ::pread(fd, buffers[slot].data() + got, want - got, static_cast<off_t>(block * kBlockSize + got));
+                if (n < 0 && errno == EINTR) continue;
+                if (n <= 0) break;
+                got += static_cast<size_t>(n);
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            if (got < want) {
+                failed = true;
+                break;
+            }
+            lengths[slot] = want;
+            ready.push_back(slot);
+            changed.notify_all();
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        done = true;
+        changed.notify_all();
+    });
+
+    try {
+        while (true) {
+            unsigned slot;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                changed.wait(lock, [&] { return !ready.empty() || done; });
+                if (ready.empty()) break;
+                slot = ready.front();
+                ready.pop_front();
+            }
+            fn(buffers[slot].data(), lengths[slot]);
+            std::lock_guard<std::mutex> lock(mutex);
+            ++freeSlots;
+            changed.notify_all();
+        }
+    } catch (...) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            cancelled = true;
+            changed.notify_all();
+        }
+        reader.join();
+        throw;
+    }
+    reader.join();
+    if (failed && error) *error = "读取失败";
+    return failed ? Status::Failed : Status::Ok;
+#endif
+}
+
+/**
+ * 顺序写入器：write() 攒块并异步提交，commit() 等待全部完成、fsync 后 rename 到目标路径
+ * 未 commit 即析构（或任一步失败）时删除临时文件，目标文件保持原样
+ */
+class FileWriter {
+public:
+    FileWriter() = default;
+    FileWriter(const FileWriter&) = delete;
+    FileWriter& operator=(const FileWriter&) = delete;
+    ~FileWriter() { abort(); }
+
+    bool open(const std::string& path) {
+        abort();
+        path_ = path;
+        tmp_ = path + ".tmp";
+        failed_ = false;
+        offset_ = 0;
+        used_ = 0;
+#ifdef _WIN32
+        out_.open(tmp_, std::ios::binary | std::ios::trunc);
+        if (!out_.is_open()) return false;
+        buffer_.assign(kBlockSize, '\0');
+#else
+        fd_ = ::open(tmp_.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd_ < 0) return false;
+        for (auto& b : buffers_) {
+            if (!b.allocate(kBlockSize)) return fail();
+        }
+        for (unsigned s = 0; s < kDepth; ++s) freeSlots_[s] = kDepth - 1 - s;
+        freeCount_ = kDepth;
+        current_ = freeSlots_[--freeCount_];
+#ifdef HR_HAVE_IO_URING
+        uring_ = std::strcmp(backendName(), "io_uring") == 0 && ring_.init(kDepth * 2);
+        if (uring_) {
+            iovec iov[kDepth];
+            for (unsigned s = 0; s < kDepth; ++s) iov[s] = iovec{buffers_[s].data(), kBlockSize};
+            // 注册失败（如 RLIMIT_MEMLOCK 过小）时改用普通 WRITE
+            fixed_ = ring_.registerBuffers(iov, kDepth);
+        }
+#endif
+#endif
+        open_ = true;
+        return true;
+    }
+
+    void write(const char* data, size_t size) {
+        if (!open_ || failed_) return;
+        while (size > 0) {
+            size_t n = std::min(size, kBlockSize - used_);
+            std::memcpy(block() + used_, data, n);
+            used_ += n;
+            data += n;
+            size -= n;
+            if (used_ == kBlockSize) flushBlock();
+        }
+    }
+
+    void write(const std::string& s) { write(s.data(), s.size()); }
+
+    // 完成写入：等待全部请求、fsync、rename；返回是否成功
+    bool commit() {
+        if (!open_) return false;
+        if (used_ > 0) flushBlock();
+#ifdef _WIN32
+        out_.close();
+        bool ok = !failed_ && !out_.fail();
+#else
+        waitAll();
+        bool ok = !failed_ && ::fsync(fd_) == 0;
+        ok = ::close(fd_) == 0 && ok;
+        fd_ = -1;
+#endif
+        open_ = false;
+        if (ok) ok = detail::replaceFile(tmp_, path_);
+        if (!ok) std::remove(tmp_.c_str());
+        releaseRing();
+        return ok;
+    }
+
+    // 放弃写入并删除临时文件
+    void abort() {
+        if (!open_) return;
+#ifdef _WIN32
+        out_.close();
+#else
+        waitAll();
+        ::close(fd_);
+        fd_ = -1;
+#endif
+        open_ = false;
+        std::remove(tmp_.c_str());
+        releaseRing();
+    }
+
+    uint64_t bytesWritten() const { return offset_ + used_; }
+
+private:
+    std::string path_, tmp_;
+    bool open_ = false;
+    bool failed_ = false;
+    uint64_t offset_ = 0;  // 已提交的字节数
+    size_t used_ = 0;      // 当前块已填充的字节数
+#ifdef _WIN32
+    std::ofstream out_;
+    std::string buffer_;
+
+    char* block() { return &buffer_[0]; }
+
+    void flushBlock() {
+        out_.write(buffer_.data(), static_cast<std::streamsize>(used_));
+        if (!out_) failed_ = true;
+        offset_ += used_;
+        used_ = 0;
+    }
+
+    void releaseRing() {}
+#else
+    int fd_ = -1;
+    detail::AlignedBuffer buffers_[kDepth];
+    unsigned freeSlots_[kDepth] = {};
+    unsigned freeCount_ = 0;
+    unsigned current_ = 0;
+    // 在途请求：槽 -> (文件偏移, 已写入字节, 总字节)
+    struct Pending { uint64_t offset; size_t done; size_t size; };
+    Pending pending_[kDepth] = {};
+    unsigned inFlight_ = 0;
+#ifdef HR_HAVE_IO_URING
+    detail::Ring ring_;
+    bool uring_ = false;
+    bool fixed_ = false;
+#endif
+
+    char* block() { return buffers_[current_].data(); }
+
+    void flushBlock() {
+        unsigned slot = current_;
+        pending_[slot] = Pending{offset_, 0, used_};
+        offset_ += used_;
+        used_ = 0;
+#ifdef HR_HAVE_IO_URING
+        if (uring_) {
+            queueWrite(slot);
+            ++inFlight_;
+            if (!ring_.submit(0)) failed_ = true;
+            // 取下一个空闲槽，全部在途时等待最早完成的一个
+            while (freeCount_ == 0 && !failed_) reapOne();
+            if (failed_) {
+                waitAll();
+                freeCount_ = 0;
+                for (unsigned s = 0; s < kDepth; ++s) freeSlots_[freeCount_++] = s;
+            }
+            current_ = freeSlots_[--freeCount_];
+            return;
+        }
+#endif
+        // 回退实现：整块 pwrite，缓冲区立即可复用
+        const Pending& p = pending_[slot];
+        size_t done = 0;
+        while (done < p.size) {
+            ssize_t n = ::pwrite(fd_, buffers_[slot].data() + done, p.size - done, static_cast<off_t>(p.offset + done));
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) {
+                failed_ = true;
+                break;
+            }
+            done += static_cast<size_t>(n);
+        }
+        current_ = slot;
+    }
+
+#ifdef HR_HAVE_IO_URING
+    void queueWrite(unsigned slot) {
+        const Pending& p = pending_[slot];
+        io_uring_sqe* sqe = ring_.next();
+        sqe->opcode = fixed_ ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE;
+        sqe->fd = fd_;
+        sqe->off = p.offset + p.done;
+        sqe->addr = reinterpret_cast<uint64_t>(buffers_[slot].data() + p.done);
+        sqe->len = static_cast<unsigned>(p.size - p.done);
+        if (fixed_) sqe->buf_index = static_cast<uint16_t>(slot);
+        sqe->user_data = slot;
+    }
+
+    // 等待一个写请求完成；短写时补写剩余部分
+    void reapOne() {
+        uint64_t slot;
+        int res;
+        if (!ring_.wait(slot, res)) {
+            failed_ = true;
+            return;
+        }
+        Pending& p = pending_[slot];
+        if (res <= 0) {
+            failed_ = true;
+        } else {
+            p.done += static_cast<size_t>(res);
+            if (p.done < p.size) {
+                queueWrite(static_cast<unsigned>(slot));
+                if (ring_.submit(0)) return;
+                failed_ = true;
+            }
+        }
+        --inFlight_;
+        freeSlots_[freeCount_++] = static_cast<unsigned>(slot);
+    }
+#endif
+
+    void waitAll() {
+#ifdef HR_HAVE_IO_URING
+        while (inFlight_ > 0) {
+            uint64_t slot;
+            int res;
+            if (failed_) {
+                // 出错后只需回收在途请求
+                if (!ring_.wait(slot, res)) break;
+                --inFlight_;
+                continue;
+            }
+            reapOne();
+        }
+#endif
+    }
+
+    void releaseRing() {
+#ifdef HR_HAVE_IO_URING
+        ring_.close();
+        uring_ = fixed_ = false;
+#endif
+        inFlight_ = 0;
+    }
+
+    bool fail() {
+        ::close(fd_);
+        fd_ = -1;
+        std::remove(tmp_.c_str());
+        return false;
+    }
+#endif
+};
+
+} // namespace async_io
+
+#endif // ASYNCIO_H
@@ -0,0 +1,102 @@
+#ifndef BACKGROUNDLOADER_H
+#define BACKGROUNDLOADER_H
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <future>
+#include <chrono>
+#include <iomanip>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "EmployeeManager.h"
+
+/**
+ * 后台加载器 (BackgroundLoader)
+ * - 程序启动即在后台线程执行 EmployeeManager::load()，与登录输入等交互重叠
+ * - 加载期间的提示信息先写入缓冲，首次 wait() 完成时原样输出，输出顺序与同步加载一致
+ * - 菜单操作前调用 wait()：已加载完成时立即返回，否则在终端上显示进度（已解析行数与耗时）直到完成
+ * - 加载期间主线程不得访问管理器的数据；只有 wait() 返回后才可以调用其他成员函数
+ */
+class BackgroundLoader {
+private:
+    EmployeeManager& manager_;
+    std::ostringstream log_;
+    std::future<void> done_;
+    std::chrono::steady_clock::time_point start_;
+    bool finished_ = false;
+
+    static bool stdoutIsTerminal() {
+#ifdef _WIN32
+        return _isatty(_fileno(stdout)) != 0;
+#else
+        return isatty(STDOUT_FILENO) != 0;
+#endif
+    }
+
+    double elapsedSeconds() const {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count();
+    }
+
+    // 每 100ms 刷新一行进度，完成后擦除该行
+    void showProgress() {
+        static const char kSpinner[] = {'|', '/', '-', '\\'};
+        size_t width = 0;
+        for (unsigned tick = 0; done_.wait_for(std::chrono::milliseconds(100)) != std::future_status::ready; ++tick) {
+            std::ostringstream line;
+            line << "\r正在加载数据 " << kSpinner[tick % 4] << " 已解析 " << manager_.loadedRows()
+                 << " 条，" << std::fixed << std::setprecision(1) << elapsedSeconds() << " 秒";
+            std::string text = line.str();
+            width = std::max(width, text.size());
+            std::cout << text << std::flush;
+        }
+        std::cout << '\r' << std::string(width, ' ') << '\r' << std::flush;
+    }
+
+public:
+    explicit BackgroundLoader(EmployeeManager& manager) : manager_(manager) {}
+
+    // 启动后台加载（只调用一次）
+    void start() {
+        manager_.setLog(&log_);
+        start_ = std::chrono::steady_clock::now();
+        done_ = std::async(std::launch::async, [this] { manager_.load(); });
+    }
+
+    // 最多等待 timeout，返回加载是否已完成
+    template <typename Duration>
+    bool waitFor(Duration timeout) const {
+        return finished_ || done_.wait_for(timeout) == std::future_status::ready;
+    }
+
+    bool ready() const { return waitFor(std::chrono::seconds(0)); }
+
+    // 等待加载完成并输出加载期间的提示信息；加载中抛出的异常在此重新抛出
+    void wait() {
+        if (finished_) return;
+        if (!ready() && stdoutIsTerminal()) showProgress();
+        done_.wait();
+        finished_ = true;
+        manager_.setLog(&std::cout);
+        std::cout << log_.str() << std::flush;
+        done_.get();
+    }
+
+    // 以 code 结束程序。加载尚未完成时不再等待：此时还没有任何修改，直接结束进程即可
+    int finish(int code) {
+        if (finished_ || ready()) return code;
+        std::cout.flush();
+        std::fflush(stdout);
+        std::_Exit(code);
+    }
+};
+
+#endif // BACKGROUNDLOADER_H
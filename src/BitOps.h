@@ -0,0 +1,74 @@
+#ifndef BITOPS_H
+#define BITOPS_H
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/**
+ * 位运算辅助 (BitOps)
+ * - 目标平台支持 POPCNT 指令时使用内建函数；否则用 SWAR 实现
+ *   （GCC 在未开启 -mpopcnt 时会把 __builtin_popcountll 编译成查表的库函数调用，反而更慢）
+ * - matchMask64 一次比较 64 个字节：有 SSE2 时每次 16 字节，否则按 8 字节一组 SWAR
+ */
+namespace bitops {
+
+inline int popcount64(uint64_t x) {
+#if defined(__POPCNT__)
+    return __builtin_popcountll(x);
+#else
+    x = x - ((x >> 1) & 0x5555555555555555ULL);
+    x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+    x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return static_cast<int>((x * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+// x 不能为 0
+inline int countTrailingZeros64(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(x);
+#else
+    int n = 0;
+    while (!(x & 1)) { x >>= 1; ++n; }
+    return n;
+#endif
+}
+
+// p 起 64 个字节中等于 a 或 b 的位置（第 i 位对应 p[i]）
+inline uint64_t matchMask64(const char* p, char a, char b) {
+#if defined(__SSE2__)
+    const __m128i va = _mm_set1_epi8(a);
+    const __m128i vb = _mm_set1_epi8(b);
+    uint64_t mask = 0;
+    for (int i = 0; i < 4; ++i) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16 * i));
+        __m128i eq = _mm_or_si128(_mm_cmpeq_epi8(v, va), _mm_cmpeq_epi8(v, vb));
+        mask |= static_cast<uint64_t>(static_cast<uint32_t>(_mm_movemask_epi8(eq))) << (16 * i);
+    }
+    return mask;
+#else
+    const uint64_t ones = 0x0101010101010101ULL;
+    const uint64_t low7 = 0x7F7F7F7F7F7F7F7FULL;
+    auto zeroBytes = [&](uint64_t x) {  // 值为 0 的字节置最高位（无误报）
+        return ~(((x & low7) + low7) | x | low7);
+    };
+    uint64_t mask = 0;
+    for (int i = 0; i < 8; ++i) {
+        uint64_t w;
+        std::memcpy(&w, p + 8 * i, 8);
+        uint64_t hits = zeroBytes(w ^ (ones * static_cast<uint8_t>(a))) | zeroBytes(w ^ (ones * static_cast<uint8_t>(b)));
+        // 把 8 个字节的最高位收拢成 8 位（小端字节序）
+        uint64_t bits = ((hits >> 7) * 0x0102040810204080ULL) >> 56;
+        mask |= bits << (8 * i);
+    }
+    return mask;
+#endif
+}
+
+} // namespace bitops
+
+#endif // BITOPS_H
@@ -0,0 +1,121 @@
+#ifndef BITMAPINDEX_H
+#define BITMAPINDEX_H
+
+#include <map>
+#include <vector>
+
+#include "Employee.h"
+#include "ColumnSnapshot.h"
+#include "RoaringBitmap.h"
+#include "Query.h"
+
+/**
+ * 位图二级索引 (BitmapIndex)
+ * - 按岗位、性别、级别为员工编号各建一组压缩位图（RoaringBitmap）
+ * - 由 EmployeeManager 在增删改、全员提级、加载时同步维护
+ * - 组合条件（如“兼职技术 且 女 且 3 级”）转化为位图求交：
+ *   计数只做按块位与 + popcount，列举只访问命中的编号
+ */
+class BitmapIndex {
+private:
+    RoaringBitmap roles_[roles::kCount];  // 按 ColumnSnapshot::RoleCode
+    RoaringBitmap genders_[3];            // 按 ColumnSnapshot::GenderCode
+    std::map<int, RoaringBitmap> levels_; // 级别 -> 编号集合
+
+    static uint32_t key(const Employee& emp) { return static_cast<uint32_t>(emp.getId()); }
+
+public:
+    void clear() {
+        for (auto& r : roles_) r.clear();
+        for (auto& g : genders_) g.clear();
+        levels_.clear();
+    }
+
+    void add(const Employee& emp) {
+        uint8_t role = ColumnSnapshot::roleCode(emp.getRoleName());
+        if (role < roles::kCount) roles_[role].add(key(emp));
+        genders_[ColumnSnapshot::genderCode(emp.getGender())].add(key(emp));
+        levels_[emp.getLevel()].add(key(emp));
+    }
+
+    void remove(const Employee& emp) {
+        uint8_t role = ColumnSnapshot::roleCode(emp.getRoleName());
+        if (role < roles::kCount) roles_[role].remove(key(emp));
+        genders_[ColumnSnapshot::genderCode(emp.getGender())].remove(key(emp));
+        auto it = levels_.find(emp.getLevel());
+        if (it != levels_.end()) {
+            it->second.remove(key(emp));
+            if (it->second.empty()) levels_.erase(it);
+        }
+    }
+
+    // 全员级别统一增加 delta：只需整体平移级别键
+    void shiftLevels(int delta) {
+        std::map<int, RoaringBitmap> shifted;
+        for (auto& kv : levels_) shifted.emplace(kv.first + delta, std::move(kv.second));
+        levels_.swap(shifted);
+    }
+
+    const RoaringBitmap& role(uint8_t code) const { return roles_[code]; }
+    const RoaringBitmap& gender(uint8_t code) const { return genders_[code]; }
+
+    // 满足 level op value 的各级别位图
+    std::vector<const RoaringBitmap*> levels(query::CmpOp op, int value) const {
+        std::vector<const RoaringBitmap*> result;
+        for (const auto& kv : levels_) {
+            int l = kv.first;
+            bool hit = false;
+            switch (op) {
+                case query::CmpOp::Eq: hit = l == value; break;
+                case query::CmpOp::Ne: hit = l != value; break;
+                case query::CmpOp::Lt: hit = l < value; break;
+                case query::CmpOp::Le: hit = l <= value; break;
+                case query::CmpOp::Gt: hit = l > value; break;
+                case query::CmpOp::Ge: hit = l >= value; break;
+            }
+            if (hit) result.push_back(&kv.second);
+        }
+        return result;
+    }
+
+    size_t memoryBytes() const {
+        size_t bytes = 0;
+        for (const auto& r : roles_) bytes += r.memoryBytes();
+        for (const auto& g : genders_) bytes += g.memoryBytes();
+        for (const auto& kv : levels_) bytes += kv.second.memoryBytes();
+        return bytes;
+    }
+
+    // 用索引求查询的命中集合。查询含索引外的字段或运算时返回 false，调用方改用列扫描
+    // 交集的各输入放入 sets；级别区间跨多个级别时先求并集，存放在 scratch 中
+    bool plan(const query::CompiledQuery& q, std::vector<const RoaringBitmap*>& sets,
+              std::vector<RoaringBitmap>& scratch) const {
+        const std::vector<query::CompiledQuery::IndexTerm>* terms = q.indexTerms();
+        if (!terms) return false;
+
+        static const RoaringBitmap kEmpty;
+        sets.clear();
+        scratch.clear();
+        scratch.reserve(terms->size());  // 保证 scratch 元素地址稳定
+        for (const auto& t : *terms) {
+            if (t.field == query::Field::Role) {
+                sets.push_back(&roles_[t.value]);
+            } else if (t.field == query::Field::Gender) {
+                sets.push_back(&genders_[t.value]);
+            } else {
+                std::vector<const RoaringBitmap*> parts = levels(t.op, t.value);
+                if (parts.empty()) {
+                    sets.push_back(&kEmpty);
+                } else if (parts.size() == 1) {
+                    sets.push_back(parts[0]);
+                } else {
+                    scratch.push_back(RoaringBitmap::unite(parts));
+                    sets.push_back(&scratch.back());
+                }
+            }
+        }
+        return true;
+    }
+};
+
+#endif // BITMAPINDEX_H
@@ -0,0 +1,350 @@
+#ifndef CHANGEFEED_H
+#define CHANGEFEED_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <fstream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <algorithm>
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "Employee.h"
+
+/**
+ * 变更数据捕获 (ChangeFeed)
+ * - EmployeeManager 每次增删改、全员提级都发布一条带序号的事件，下游据此只处理增量
+ * - 日志为只追加的 JSON Lines 文件，每行一条事件：
+ *     {"seq":12,"ts":1760000000000,"op":"update","id":7,"before":{...},"after":{...}}
+ *   op 为 insert / update / delete（before、after 为员工 JSON，不存在的一侧为 null），
+ *   或 promote_all（只记 delta，表示全员级别加 delta，无需逐人记录）
+ * - 序号从 1 开始连续递增，重新打开日志时接着最后一条事件的序号继续
+ * - 发布方只复制员工对象并入队（修改前的对象直接移交，不复制）；
+ *   序列化与写文件在后台线程批量进行，不阻塞增删改
+ * - 可另指定 Unix 域数据报套接字，每条事件同时以一个数据报推送给正在监听的消费者；
+ *   无人监听时丢弃，消费者以日志为准，按序号补齐缺口（Windows 上不支持套接字）
+ * - ChangeLogReader 供消费者从指定序号起读取日志，按序号二分定位起点，可持续跟随新事件
+ */
+class ChangeFeed {
+public:
+    enum class Op { Insert, Update, Delete, PromoteAll };
+
+    static const char* opName(Op op) {
+        static const char* const names[] = {"insert", "update", "delete", "promote_all"};
+        return names[static_cast<int>(op)];
+    }
+
+    ChangeFeed() = default;
+    ChangeFeed(const ChangeFeed&) = delete;
+    ChangeFeed& operator=(const ChangeFeed&) = delete;
+    ~ChangeFeed() { close(); }
+
+    // 打开（或新建）日志并启动写线程；socketPath 非空时同时推送到该套接字
+    bool open(const std::string& logPath, const std::string& socketPath = "", std::string* error = nullptr) {
+        close();
+        uint64_t last = lastSequence(logPath);
+        out_ = std::fopen(logPath.c_str(), "ab+");
+        if (!out_) {
+            if (error) *error = "无法打开变更日志: " + logPath;
+            return false;
+        }
+        // 上次写到一半的行单独成行，新事件从新行开始
+        if (std::fseek(out_, -1, SEEK_END) == 0 && std::fgetc(out_) != '\n') {
+            std::fseek(out_, 0, SEEK_END);
+            std::fputc('\n', out_);
+        }
+        std::fseek(out_, 0, SEEK_END);
+        if (!socketPath.empty() && !openSocket(socketPath, error)) {
+            std::fclose(out_);
+            out_ = nullptr;
+            return false;
+        }
+        nextSeq_ = last + 1;
+        stopping_ = false;
+        writer_ = std::thread([this] { writeLoop(); });
+        return true;
+    }
+
+    // 写完已入队的事件后停止写线程
+    void close() {
+        if (writer_.joinable()) {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                stopping_ = true;
+            }
+            wake_.notify_one();
+            writer_.join();
+        }
+        if (out_) {
+            std::fclose(out_);
+            out_ = nullptr;
+        }
+#ifndef _WIN32
+        if (socket_ >= 0) {
+            ::close(socket_);
+            socket_ = -1;
+        }
+#endif
+    }
+
+    bool isOpen() const { return out_ != nullptr; }
+
+    // 发布一条事件并返回其序号；before / after 为修改前后的独立对象（不存在的一侧传 nullptr）
+    uint64_t publish(Op op, int id, std::unique_ptr<const Employee> before,
+                     std::unique_ptr<const Employee> after, int delta = 0) {
+        Event event;
+        event.op = op;
+        event.id = id;
+        event.delta = delta;
+        event.timeMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        event.before = std::move(before);
+        event.after = std::move(after);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        event.seq = nextSeq_++;
+        pending_.push_back(std::move(event));
+        if (pending_.size() == 1) wake_.notify_one();
+        return nextSeq_ - 1;
+    }
+
+    // 已分配的最后一个序号
+    uint64_t lastPublished() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return nextSeq_ - 1;
+    }
+
+    // 阻塞到目前已发布的事件全部写入日志
+    void flush() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        uint64_t target = nextSeq_ - 1;
+        flushed_.wait(lock, [&] { return writtenSeq_ >= target || !writer_.joinable(); });
+    }
+
+    // 读取日志最后一条事件的序号（日志不存在或为空时返回 0）
+    static uint64_t lastSequence(const std::string& logPath) {
+        std::ifstream in(logPath, std::ios::binary | std::ios::ate);
+        if (!in.is_open()) return 0;
+        std::streamoff size = in.tellg();
+        std::streamoff start = std::max<std::streamoff>(0, size - 64 * 1024);
+        std::string tail(static_cast<size_t>(size - start), '\0');
+        in.seekg(start);
+        in.read(&tail[0], static_cast<std::streamsize>(tail.size()));
+
+        // 从后往前找最后一条完整且可解析的事件（写到一半的行会被跳过）
+        size_t end = tail.size();
+        while (end > 0) {
+            size_t begin = tail.rfind('\n', end - 1);
+            begin = (begin == std::string::npos) ? 0 : begin + 1;
+            uint64_t seq = 0;
+            if (begin < end && parseSequence(tail.data() + begin, end - begin, seq)) return seq;
+            if (begin == 0) break;
+            end = begin - 1;
+        }
+        return 0;
+    }
+
+    // 解析事件行开头的 {"seq":N；不以 } 结尾的行（写到一半中断）视为无效
+    static bool parseSequence(const char* line, size_t length, uint64_t& seq) {
+        static const char kPrefix[] = "{\"seq\":";
+        const size_t prefixLength = sizeof(kPrefix) - 1;
+        if (length <= prefixLength || std::memcmp(line, kPrefix, prefixLength) != 0) return false;
+        if (line[length - 1] != '}') return false;
+        size_t i = prefixLength;
+        if (line[i] < '0' || line[i] > '9') return false;
+        seq = 0;
+        while (i < length && line[i] >= '0' && line[i] <= '9') seq = seq * 10 + static_cast<uint64_t>(line[i++] - '0');
+        return i < length && line[i] == ',';
+    }
+
+private:
+    struct Event {
+        uint64_t seq = 0;
+        long long timeMs = 0;
+        Op op = Op::Insert;
+        int id = 0;
+        int delta = 0;
+        std::unique_ptr<const Employee> before;
+        std::unique_ptr<const Employee> after;
+    };
+
+    std::FILE* out_ = nullptr;
+#ifndef _WIN32
+    int socket_ = -1;
+    sockaddr_un peer_{};
+#endif
+    std::thread writer_;
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable flushed_;
+    std::vector<Event> pending_;
+    uint64_t nextSeq_ = 1;
+    uint64_t writtenSeq_ = 0;
+    bool stopping_ = false;
+
+    bool openSocket(const std::string& path, std::string* error) {
+#ifndef _WIN32
+        if (path.size() >= sizeof(peer_.sun_path)) {
+            if (error) *error = "套接字路径过长: " + path;
+            return false;
+        }
+        socket_ = ::socket(AF_UNIX, SOCK_DGRAM, 0);
+        if (socket_ < 0) {
+            if (error) *error = "无法创建套接字";
+            return false;
+        }
+        ::fcntl(socket_, F_SETFL, ::fcntl(socket_, F_GETFL) | O_NONBLOCK);
+        peer_ = sockaddr_un{};
+        peer_.sun_family = AF_UNIX;
+        std::strncpy(peer_.sun_path, path.c_str(), sizeof(peer_.sun_path) - 1);
+        return true;
+#else
+        (void)path;
+        if (error) *error = "当前平台不支持 Unix 域套接字";
+        return false;
+#endif
+    }
+
+    static std::string format(const Event& e) {
+        std::string line = "{\"seq\":" + std::to_string(e.seq) + ",\"ts\":" + std::to_string(e.timeMs)
+                         + ",\"op\":\"" + opName(e.op) + "\"";
+        if (e.op == Op::PromoteAll) {
+            line += ",\"delta\":" + std::to_string(e.delta);
+        } else {
+            line += ",\"id\":" + std::to_string(e.id);
+            line += ",\"before\":";
+            line += e.before ? e.before->toJSON() : "null";
+            line += ",\"after\":";
+            line += e.after ? e.after->toJSON() : "null";
+        }
+        line += "}\n";
+        return line;
+    }
+
+    // 每次取走队列中的全部事件，序列化后一次写出
+    void writeLoop() {
+        std::vector<Event> batch;
+        std::string buffer;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                wake_.wait(lock, [this] { return !pending_.empty() || stopping_; });
+                if (pending_.empty() && stopping_) break;
+                batch.swap(pending_);
+            }
+
+            buffer.clear();
+            for (const Event& e : batch) {
+                std::string line = format(e);
+#ifndef _WIN32
+                if (socket_ >= 0) {
+                    // 无人监听或接收方缓冲区已满时丢弃，消费者从日志补齐
+                    ::sendto(socket_, line.data(), line.size(), 0,
+                             reinterpret_cast<const sockaddr*>(&peer_), sizeof(peer_));
+                }
+#endif
+                buffer += line;
+            }
+            std::fwrite(buffer.data(), 1, buffer.size(), out_);
+            std::fflush(out_);
+
+            uint64_t last = batch.back().seq;
+            batch.clear();
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                writtenSeq_ = last;
+            }
+            flushed_.notify_all();
+        }
+        flushed_.notify_all();
+    }
+};
+
+/**
+ * 变更日志读取器 (ChangeLogReader)
+ * - seek(seq) 按文件偏移二分查找第一条序号 >= seq 的事件，无需从头扫描
+ * - poll() 读出当前可读的全部完整事件；写到一半的行留到下次再读，可反复调用以跟随日志
+ */
+class ChangeLogReader {
+public:
+    bool open(const std::string& path) {
+        path_ = path;
+        offset_ = 0;
+        std::ifstream in(path, std::ios::binary);
+        return in.is_open();
+    }
+
+    // 定位到第一条序号 >= seq 的事件
+    void seek(uint64_t seq) {
+        offset_ = 0;
+        skipBelow_ = seq;
+        std::ifstream in(path_, std::ios::binary | std::ios::ate);
+        if (!in.is_open()) return;
+        std::streamoff lo = 0, hi = in.tellg();
+        // 不变式：lo 为某行行首且该行之前的事件序号都 < seq
+        while (hi - lo > 4096) {
+            std::streamoff mid = lo + (hi - lo) / 2;
+            std::streamoff lineStart;
+            uint64_t found;
+            if (!firstEventAfter(in, mid, lineStart, found) || lineStart >= hi) {
+                hi = mid;
+            } else if (found < seq) {
+                lo = lineStart;
+            } else {
+                hi = mid;
+            }
+        }
+        offset_ = lo;
+    }
+
+    // 对每条新的完整事件调用 fn(uint64_t seq, const std::string& line)，返回读到的事件数
+    template <typename Fn>
+    size_t poll(Fn fn) {
+        std::ifstream in(path_, std::ios::binary);
+        if (!in.is_open()) return 0;
+        in.seekg(offset_);
+        size_t count = 0;
+        std::string line;
+        while (std::getline(in, line)) {
+            if (in.eof()) break;  // 最后一行没有换行符，写入尚未完成
+            offset_ += static_cast<std::streamoff>(line.size()) + 1;
+            uint64_t seq;
+            if (!ChangeFeed::parseSequence(line.data(), line.size(), seq) || seq < skipBelow_) continue;
+            fn(seq, line);
+            ++count;
+        }
+        return count;
+    }
+
+private:
+    std::string path_;
+    std::streamoff offset_ = 0;
+    uint64_t skipBelow_ = 0;
+
+    // 从 pos 之后的下一个行首开始找第一条可解析的事件
+    static bool firstEventAfter(std::ifstream& in, std::streamoff pos, std::streamoff& lineStart, uint64_t& seq) {
+        in.clear();
+        in.seekg(pos);
+        std::string line;
+        if (pos > 0 && !std::getline(in, line)) return false;  // 跳过残行
+        while (true) {
+            lineStart = in.tellg();
+            if (!std::getline(in, line)) return false;
+            if (ChangeFeed::parseSequence(line.data(), line.size(), seq)) return true;
+        }
+    }
+};
+
+#endif // CHANGEFEED_H
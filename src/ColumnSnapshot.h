@@ -0,0 +1,124 @@
+#ifndef COLUMNSNAPSHOT_H
+#define COLUMNSNAPSHOT_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+#include "RoleRegistry.h"
+
+/**
+ * 列式快照 (ColumnSnapshot)
+ * - 把员工对象的各字段按列展开为连续数组，供条件查询等批量扫描使用，
+ *   扫描时不再调用虚函数、不拷贝字符串
+ * - 行号与构建时 employees_ 的下标一一对应
+ * - 岗位、性别编码为小整数；生日编码为 yyyymmdd 整数，缺失或非法时为 0；上级编号为 0 表示无上级
+ */
+struct ColumnSnapshot {
+    // 岗位编码（即 RoleRegistry 中的登记顺序）
+    enum RoleCode : uint8_t {
+        kManager = roles::codeOf<Manager>(),
+        kTech = roles::codeOf<PartTimeTechnician>(),
+        kSalesManager = roles::codeOf<SalesManager>(),
+        kSales = roles::codeOf<PartTimeSalesperson>(),
+        kUnknownRole = roles::kUnknown
+    };
+    // 性别编码
+    enum GenderCode : uint8_t { kMale = 0, kFemale = 1, kOtherGender = 2 };
+
+    std::vector<int32_t> id;
+    std::vector<int32_t> level;
+    std::vector<int32_t> birthday;
+    std::vector<int32_t> managerId;
+    std::vector<uint8_t> role;
+    std::vector<uint8_t> gender;
+    std::vector<double> salary;
+    std::vector<double> sales;   // 销售额（非销售岗位为 0）
+    std::vector<double> rate;    // 提成比例（非销售岗位为 0）
+    std::vector<double> hours;   // 工时（非兼职技术为 0）
+    std::vector<double> base;    // 固定月薪 / 时薪
+    std::string namePool;              // 所有姓名首尾相接
+    std::vector<uint32_t> nameOffset;  // 第 i 个姓名位于 [nameOffset[i], nameOffset[i+1])
+
+    size_t rows() const { return id.size(); }
+
+    std::string name(size_t row) const {
+        return namePool.substr(nameOffset[row], nameOffset[row + 1] - nameOffset[row]);
+    }
+
+    static uint8_t roleCode(const std::string& role) { return roles::code(role); }
+
+    static uint8_t genderCode(const std::string& gender) {
+        if (gender == "男") return kMale;
+        if (gender == "女") return kFemale;
+        return kOtherGender;
+    }
+
+    // 日期编码为 yyyymmdd，非法时返回 0
+    static int32_t dateCode(const std::string& date) {
+        if (!Employee::isValidDate(date)) return 0;
+        return std::stoi(date.substr(0, 4)) * 10000 + std::stoi(date.substr(5, 2)) * 100 +
+               std::stoi(date.substr(8, 2));
+    }
+
+    void build(const std::vector<std::unique_ptr<Employee>>& employees) {
+        size_t n = employees.size();
+        id.resize(n);
+        level.resize(n);
+        birthday.resize(n);
+        managerId.resize(n);
+        role.resize(n);
+        gender.resize(n);
+        salary.resize(n);
+        sales.assign(n, 0.0);
+        rate.assign(n, 0.0);
+        hours.assign(n, 0.0);
+        base.assign(n, 0.0);
+        namePool.clear();
+        nameOffset.resize(n + 1);
+
+        for (size_t i = 0; i < n; ++i) {
+            const Employee* emp = employees[i].get();
+            id[i] = emp->getId();
+            level[i] = emp->getLevel();
+            birthday[i] = dateCode(emp->getBirthday());
+            managerId[i] = emp->getManagerId();
+            role[i] = roleCode(emp->getRoleName());
+            gender[i] = genderCode(emp->getGender());
+            salary[i] = emp->calculateSalary();
+            nameOffset[i] = static_cast<uint32_t>(namePool.size());
+            namePool += emp->getName();
+
+            switch (role[i]) {
+                case kManager:
+                    base[i] = static_cast<const Manager*>(emp)->getFixedSalary();
+                    break;
+                case kTech: {
+                    auto* t = static_cast<const PartTimeTechnician*>(emp);
+                    base[i] = t->getHourlyRate();
+                    hours[i] = t->getHoursWorked();
+                    break;
+                }
+                case kSalesManager: {
+                    auto* m = static_cast<const SalesManager*>(emp);
+                    base[i] = m->getFixedSalary();
+                    rate[i] = m->getCommissionRate();
+                    sales[i] = m->getSalesAmount();
+                    break;
+                }
+                case kSales: {
+                    auto* p = static_cast<const PartTimeSalesperson*>(emp);
+                    rate[i] = p->getCommissionRate();
+                    sales[i] = p->getSalesAmount();
+                    break;
+                }
+                default:
+                    break;
+            }
+        }
+        nameOffset[n] = static_cast<uint32_t>(namePool.size());
+    }
+};
+
+#endif // COLUMNSNAPSHOT_H
@@ -2,14 +2,30 @@
 #define EMPLOYEE_H
 
 #include <string>
+#include <vector>
+#include <array>
+#include <memory>
 #include <iostream>
 #include <sstream>
 #include <iomanip>
+#include <cstdint>
+
+#include "JsonUtil.h"
+#include "Metrics.h"
+
+// CSV 参数列的合理取值范围（闭区间）
+struct ParamRange {
+    double min;
+    double max;
+};
 
 /**
  * 员工基类 (抽象类)
- * - 包含所有员工的公共属性：编号、姓名、性别、级别
+ * - 包含所有员工的公共属性：编号、姓名、性别、级别、生日、上级编号（汇报关系，0 表示无上级）
  * - 定义纯虚函数：计算月薪、显示信息、获取角色名、序列化/反序列化
+ * - 支持延迟解码（EmployeeManager 的延迟加载模式）：对象只带编号与原始 CSV 行，
+ *   公共属性在首次访问时解码，岗位特有属性在首次计算薪资、显示或序列化时解码。
+ *   解码会修改对象，延迟模式下的对象不能被多个线程同时读取
  */
 class Employee {
 protected:
@@ -18,8 +34,18 @@ protected:
     std::string gender_;  // "男" 或 "女"
     int level_;
     std::string birthday_; // 生日，格式：YYYY-MM-DD
+    int managerId_ = 0;    // 直接上级的编号，0 表示无上级（CSV 末列 managerId）
+
+private:
+    const char* rawRow_ = nullptr;  // 尚未解码的原始 CSV 行（不含换行），全部解码后置空
+    uint32_t rawLength_ = 0;
+    bool basicPending_ = false;     // 公共属性（编号除外）尚未解码
+    bool specificPending_ = false;  // 岗位特有属性尚未解码
 
 public:
+    // CSV 列：id,name,role,level,gender,birthday,param1,param2,param3,managerId（末列可省略，视为 0）
+    static constexpr size_t kManagerColumn = 9;
+
     Employee() : id_(0), level_(1) {}
     Employee(int id, const std::string& name, const std::string& gender, int level)
         : id_(id), name_(name), gender_(gender), level_(level) {}
@@ -30,17 +56,59 @@ public:
     int getId() const { return id_; }
     void setId(int id) { id_ = id; }
     
-    std::string getName() const { return name_; }
-    void setName(const std::string& name) { name_ = name; }
+    std::string getName() const { ensureBasic(); return name_; }
+    void setName(const std::string& name) { ensureBasic(); name_ = name; }
     
-    std::string getGender() const { return gender_; }
-    void setGender(const std::string& gender) { gender_ = gender; }
+    std::string getGender() const { ensureBasic(); return gender_; }
+    void setGender(const std::string& gender) { ensureBasic(); gender_ = gender; }
     
-    int getLevel() const { return level_; }
-    void setLevel(int level) { level_ = level; }
+    int getLevel() const { ensureBasic(); return level_; }
+    void setLevel(int level) { ensureBasic(); level_ = level; }
     
-    std::string getBirthday() const { return birthday_; }
-    void setBirthday(const std::string& birthday) { birthday_ = birthday; }
+    std::string getBirthday() const { ensureBasic(); return birthday_; }
+    void setBirthday(const std::string& birthday) { ensureBasic(); birthday_ = birthday; }
+
+    int getManagerId() const { ensureBasic(); return managerId_; }
+    void setManagerId(int managerId) { ensureBasic(); managerId_ = managerId; }
+
+    // 解析 CSV 末列的上级编号：缺列或为空时为 0，格式错误时为 0 并计入解析失败
+    static int parseManagerId(const std::vector<std::string>& cols) {
+        if (cols.size() <= kManagerColumn || cols[kManagerColumn].empty()) return 0;
+        try {
+            int managerId = std::stoi(cols[kManagerColumn]);
+            if (managerId >= 0) return managerId;
+        } catch (...) {}
+        HR_METRIC_ADD(ParseFailures, 1);
+        return 0;
+    }
+
+    // ========== 延迟解码 ==========
+
+    // 绑定原始 CSV 行，其余属性留待首次访问时解码；行内存须保持有效直到 materialize()
+    void deferRow(const char* row, size_t length) {
+        rawRow_ = row;
+        rawLength_ = static_cast<uint32_t>(length);
+        basicPending_ = specificPending_ = true;
+    }
+
+    bool isMaterialized() const { return !basicPending_ && !specificPending_; }
+
+    // 立即解码全部属性，之后不再引用原始行
+    void materialize() const {
+        ensureBasic();
+        ensureSpecific();
+    }
+
+    // 按逗号拆分一行 CSV（与加载时的拆分规则一致）
+    static std::vector<std::string> splitCSV(const std::string& line) {
+        std::vector<std::string> cols;
+        std::stringstream ss(line);
+        std::string token;
+        while (std::getline(ss, token, ',')) {
+            cols.push_back(token);
+        }
+        return cols;
+    }
 
     // ========== 纯虚函数（派生类必须实现） ==========
     
@@ -62,16 +130,30 @@ public:
     // 从 CSV 列向量解析特有属性（公共属性由工厂处理）
     virtual void parseCSV(const std::vector<std::string>& cols) = 0;
 
+    // 序列化为 JSON 对象（服务模式输出）
+    virtual std::string toJSON() const = 0;
+
+    // 复制出一个已完全解码的独立对象（变更数据捕获用来保存修改前后的状态）
+    virtual std::unique_ptr<Employee> clone() const = 0;
+
+    // CSV 参数列 param1..param3 的数值（含义见各岗位的 kParamKeys，未使用的列为 0）
+    virtual std::array<double, 3> getParams() const = 0;
+
+    // 按参数列设置岗位特有属性（列式导入使用，未使用的列忽略）
+    virtual void setParams(const std::array<double, 3>& params) = 0;
+
     // ========== 通用方法 ==========
     
     // 提升级别
     void promote(int increment = 1) {
+        ensureBasic();
         level_ += increment;
         std::cout << name_ << " 级别提升到 " << level_ << std::endl;
     }
 
     // 输入公共属性（姓名、性别）
     void inputBasicInfo() {
+        ensureBasic();
         std::cout << "姓名: ";
         std::cout.flush();
         std::getline(std::cin, name_);
@@ -121,22 +203,84 @@ public:
     }
 
 protected:
+    // 延迟解码：读写公共属性前调用 ensureBasic，派生类读写特有属性前调用 ensureSpecific
+    void ensureBasic() const {
+        if (basicPending_) const_cast<Employee*>(this)->decodeBasic();
+    }
+
+    void ensureSpecific() const {
+        if (specificPending_) const_cast<Employee*>(this)->decodeSpecific();
+    }
+
     // 辅助：生成公共属性的 CSV 部分
     std::string basicToCSV() const {
+        ensureBasic();
         std::ostringstream oss;
         oss << id_ << "," << name_ << "," << getRoleName() << ","
             << level_ << "," << gender_ << "," << birthday_;
         return oss.str();
     }
 
+    // 辅助：生成参数列之后的上级编号列（含前导逗号）
+    std::string managerToCSV() const {
+        ensureBasic();
+        return "," + std::to_string(managerId_);
+    }
+
+    // 辅助：生成公共属性及当月工资的 JSON 部分（不含结尾的 '}'）
+    std::string basicToJSON() const {
+        ensureBasic();
+        std::ostringstream oss;
+        oss << "{\"id\":" << id_
+            << ",\"name\":" << json::quote(name_)
+            << ",\"role\":" << json::quote(getRoleName())
+            << ",\"level\":" << level_
+            << ",\"gender\":" << json::quote(gender_)
+            << ",\"birthday\":" << json::quote(birthday_)
+            << ",\"managerId\":" << managerId_
+            << ",\"salary\":" << std::fixed << std::setprecision(2) << calculateSalary();
+        return oss.str();
+    }
+
     // 辅助：显示公共属性
     void displayBasic() const {
+        ensureBasic();
         std::cout << "编号: " << id_ << "\n"
                   << "姓名: " << name_ << "\n"
                   << "性别: " << gender_ << "\n"
                   << "级别: " << level_ << "\n"
                   << "生日: " << (birthday_.empty() ? "未设置" : birthday_) << "\n"
                   << "岗位: " << getRoleName() << "\n";
+        if (managerId_) std::cout << "上级编号: " << managerId_ << "\n";
+    }
+
+private:
+    // 解码规则与 EmployeeManager::fromColumns 一致（编号与岗位在加载时已解析）
+    void decodeBasic() {
+        basicPending_ = false;
+        std::vector<std::string> cols = splitCSV(std::string(rawRow_, rawLength_));
+        name_ = cols.size() > 1 ? cols[1] : "";
+        level_ = 1;
+        if (cols.size() > 3) {
+            try { level_ = std::stoi(cols[3]); } catch (...) { HR_METRIC_ADD(ParseFailures, 1); }
+        }
+        gender_ = cols.size() > 4 ? cols[4] : "";
+        birthday_ = cols.size() > 5 ? cols[5] : "";
+        managerId_ = parseManagerId(cols);
+        releaseRow();
+    }
+
+    void decodeSpecific() {
+        specificPending_ = false;
+        parseCSV(splitCSV(std::string(rawRow_, rawLength_)));
+        releaseRow();
+    }
+
+    void releaseRow() {
+        if (isMaterialized()) {
+            rawRow_ = nullptr;
+            rawLength_ = 0;
+        }
     }
 };
 
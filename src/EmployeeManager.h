@@ -2,146 +2,962 @@
 #define EMPLOYEEMANAGER_H
 
 #include <vector>
+#include <array>
 #include <memory>
 #include <fstream>
 #include <sstream>
 #include <algorithm>
 #include <functional>
-
-#include "Employee.h"
-#include "Manager.h"
-#include "PartTimeTechnician.h"
-#include "PartTimeSalesperson.h"
-#include "SalesManager.h"
+#include <unordered_map>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <cstring>
+
+#include "RoleRegistry.h"
+#include "ShardedStore.h"
+#include "RosterIO.h"
+#include "Query.h"
+#include "BitmapIndex.h"
+#include "GroupBy.h"
+#include "SalaryRankIndex.h"
+#include "SalarySketch.h"
+#include "ReportingIndex.h"
+#include "RosterDiff.h"
+#include "ChangeFeed.h"
+#include "ArrowIPC.h"
 
 /**
  * 员工管理类 (EmployeeManager)
  * - 管理所有员工对象（使用智能指针）
  * - 提供 CRUD、检索、统计、排名、持久化等功能
+ * - 数据路径可以是单个 CSV 文件（.lz4 结尾时按 LZ4 压缩读写，见 RosterIO），
+ *   也可以是分片目录（见 ShardedStore）
+ * - 开启变更数据捕获（enableChangeFeed）后，增删改与全员提级都以带序号的事件写入变更日志
+ * - 夜间花名册可先与当前数据比对（见 RosterDiff），再用 applyChanges 原地应用变更集
+ * - 延迟加载模式（setLazy，仅单文件、单线程使用）：load() 只映射文件并解析编号与岗位，
+ *   其余字段在首次访问时解码；位图、排名、分布等二级索引推迟到首次使用时构建；
+ *   保存前解码全部员工并释放映射
+ * - load() 可在后台线程执行（见 BackgroundLoader）：提示信息写到 setLog 指定的流，进度由 loadedRows() 读取
+ * - 员工可登记上级编号，汇报关系由 ReportingIndex 维护；删除员工时其直接下属改为向其上级汇报
  */
 class EmployeeManager {
+public:
+    // 单个岗位的统计结果
+    struct RoleTotals {
+        int count = 0;
+        double total = 0.0;
+    };
+
+    // 工资统计结果（statistics() 与服务模式共用），byRole 按岗位编码（见 RoleRegistry）
+    struct SalaryStatistics {
+        size_t employees = 0;
+        double total = 0.0;
+        std::array<RoleTotals, roles::kCount> byRole;
+    };
+
 private:
     std::vector<std::unique_ptr<Employee>> employees_;
+    std::unordered_map<int, size_t> idIndex_;  // 编号 -> employees_ 下标
+    // 二级索引：延迟加载模式下首次使用时才构建，故为 mutable
+    mutable BitmapIndex bitmapIndex_;          // 岗位/性别/级别 -> 编号位图
+    mutable SalaryRankIndex salaryRank_;       // (月薪, 编号) 顺序统计树，全员及各岗位
+    mutable SalaryDistribution distribution_;  // 全员/岗位/级别的月薪分位数草图
+    mutable ReportingIndex reporting_;         // 汇报关系（欧拉序 Treap）
+    mutable bool indexesReady_ = true;
     int nextId_;
     std::string csvPath_;
+    bool verbose_;
+    std::ostream* log_ = &std::cout;  // load() 的提示信息输出位置
+    std::atomic<size_t> loadedRows_{0};  // load() 已解析的行数，供其他线程显示进度
+    bool lazy_ = false;
+    std::unique_ptr<ShardedStore> store_;  // 分片目录模式时非空
+    mutable std::unique_ptr<roster_io::MappedRoster> mapped_;  // 延迟加载模式下员工引用的原始行
+    std::unique_ptr<ChangeFeed> feed_;  // 变更数据捕获，未开启时为空
+
+    // 列式快照缓存：数据每次变化 version_ 加一，查询时发现版本过期才重建
+    uint64_t version_ = 0;
+    mutable std::mutex columnsMutex_;
+    mutable std::shared_ptr<const ColumnSnapshot> columns_;
+    mutable uint64_t columnsVersion_ = 0;
+
+    // 标记员工所在分片需要重写（单文件模式下无操作），并使列式快照失效
+    void markDirty(int id) {
+        ++version_;
+        if (store_) store_->markDirty(id);
+    }
+
+    // 逐行加载时每 64K 行发布一次进度
+    void reportProgress() {
+        if ((employees_.size() & 0xFFFF) == 0) loadedRows_.store(employees_.size(), std::memory_order_relaxed);
+    }
+
+    void rebuildIndex() {
+        loadedRows_.store(employees_.size(), std::memory_order_relaxed);
+        idIndex_.clear();
+        idIndex_.reserve(employees_.size());
+        for (size_t i = 0; i < employees_.size(); ++i) {
+            idIndex_[employees_[i]->getId()] = i;
+        }
+        indexesReady_ = false;
+        if (mapped_) return;
+        ensureIndexes();
+        size_t unresolved = reporting_.unresolved();
+        if (unresolved && verbose_) {
+            *log_ << "有 " << unresolved << " 名员工登记的上级不存在或会形成环，暂按最高层处理。" << std::endl;
+        }
+    }
+
+    // 构建位图、排名、分布、汇报关系等二级索引（已构建时无操作）
+    // 按 employees_ 顺序收集（编号重复时只取 idIndex_ 指向的那一行），汇报关系中的下属顺序与数据文件一致
+    void ensureIndexes() const {
+        if (indexesReady_) return;
+        indexesReady_ = true;
+        bitmapIndex_.clear();
+        std::vector<const Employee*> indexed;
+        indexed.reserve(idIndex_.size());
+        for (size_t i = 0; i < employees_.size(); ++i) {
+            if (idIndex_.at(employees_[i]->getId()) != i) continue;
+            bitmapIndex_.add(*employees_[i]);
+            indexed.push_back(employees_[i].get());
+        }
+        salaryRank_.build(indexed);
+        distribution_ = buildDistribution(indexed);
+        reporting_.build(indexed);
+    }
+
+    // 二级索引的增量维护：员工属性变化前调用 unindexEmployee，变化后调用 indexEmployee
+    // （索引尚未构建时无需维护，首次使用时按当时的数据构建）
+    void indexEmployee(const Employee& emp) {
+        if (!indexesReady_) return;
+        bitmapIndex_.add(emp);
+        salaryRank_.add(emp);
+        distribution_.add(ColumnSnapshot::roleCode(emp.getRoleName()), emp.getLevel(), emp.calculateSalary());
+        reporting_.set(emp.getId(), emp.getManagerId(), emp.calculateSalary());
+    }
+
+    // 汇报关系以编号为键原地更新，这里无需摘除；删除员工见 detachReports
+    void unindexEmployee(const Employee& emp) {
+        if (!indexesReady_) return;
+        bitmapIndex_.remove(emp);
+        salaryRank_.remove(emp);
+        distribution_.remove(ColumnSnapshot::roleCode(emp.getRoleName()), emp.getLevel(), emp.calculateSalary());
+    }
+
+    // 删除员工前调用：其直接下属改为向其上级汇报（无上级时成为最高层），下属数据随之修改并记入变更日志
+    void detachReports(int id) {
+        ensureIndexes();
+        int heir = 0;
+        for (int report : reporting_.erase(id, &heir)) {
+            auto it = idIndex_.find(report);
+            if (it == idIndex_.end()) continue;
+            Employee& emp = *employees_[it->second];
+            std::unique_ptr<Employee> before = feed_ ? emp.clone() : nullptr;
+            emp.setManagerId(heir);
+            markDirty(report);
+            publishChange(ChangeFeed::Op::Update, report, std::move(before), &emp);
+        }
+    }
+
+    // 发布变更事件（未开启变更数据捕获时无操作）；before 为已摘下的修改前对象，after 为修改后的对象
+    void publishChange(ChangeFeed::Op op, int id, std::unique_ptr<Employee> before, const Employee* after) {
+        if (!feed_) return;
+        if (before) before->materialize();  // 写线程读取时不能再引用映射的原始行
+        feed_->publish(op, id, std::move(before), after ? after->clone() : nullptr);
+    }
+
+    // 分段并行构建月薪分布草图后合并（每段不少于 64K 人）
+    static SalaryDistribution buildDistribution(const std::vector<const Employee*>& employees) {
+        constexpr size_t kRowsPerThread = 1 << 16;
+        size_t rows = employees.size();
+        size_t threads = std::max<size_t>(1, std::min<size_t>(std::thread::hardware_concurrency(),
+                                                              rows / kRowsPerThread));
+        std::vector<SalaryDistribution> partials(threads);
+        size_t per = (rows + threads - 1) / threads;
+        auto work = [&](size_t t) {
+            size_t begin = std::min(rows, t * per), end = std::min(rows, begin + per);
+            for (size_t i = begin; i < end; ++i) {
+                const Employee& emp = *employees[i];
+                partials[t].add(ColumnSnapshot::roleCode(emp.getRoleName()), emp.getLevel(), emp.calculateSalary());
+            }
+        };
+        if (threads == 1) {
+            work(0);
+        } else {
+            std::vector<std::thread> pool;
+            for (size_t t = 1; t < threads; ++t) pool.emplace_back(work, t);
+            work(0);
+            for (auto& th : pool) th.join();
+        }
+        for (size_t t = 1; t < threads; ++t) partials[0].merge(partials[t]);
+        return std::move(partials[0]);
+    }
 
 public:
     explicit EmployeeManager(const std::string& csvPath) 
-        : nextId_(1), csvPath_(csvPath) {}
+        : nextId_(1), csvPath_(csvPath), verbose_(true) {}
+
+    // 关闭后 load()/save() 不再输出提示信息（服务模式使用）
+    void setVerbose(bool verbose) { verbose_ = verbose; }
+
+    // 指定 load() 提示信息的输出位置（后台加载时先写入缓冲，完成后再显示）
+    void setLog(std::ostream* log) { log_ = log; }
+
+    // load() 目前已解析的员工数，可在其他线程读取；逐行解析的单文件每 64K 行更新一次，其余布局在加载结束时更新
+    size_t loadedRows() const { return loadedRows_.load(std::memory_order_relaxed); }
+
+    // 开启变更数据捕获：此后的增删改与全员提级追加到 logPath（socketPath 非空时同时推送），失败时返回 false
+    bool enableChangeFeed(const std::string& logPath, const std::string& socketPath = "", std::string* error = nullptr) {
+        std::unique_ptr<ChangeFeed> feed(new ChangeFeed());
+        if (!feed->open(logPath, socketPath, error)) return false;
+        feed_ = std::move(feed);
+        return true;
+    }
+
+    ChangeFeed* changeFeed() const { return feed_.get(); }
+
+    // 开启后 load() 延迟解析单文件花名册（分片目录仍全部解析）；不可与服务模式同用
+    void setLazy(bool lazy) { lazy_ = lazy; }
 
     // 从 CSV 文件加载
     void load() {
+        HR_METRIC_TIMER(Load);
+        ++version_;
         employees_.clear();
+        mapped_.reset();
+        rebuildIndex();
         nextId_ = 1;
+        store_.reset();
+        loadedRows_.store(0, std::memory_order_relaxed);
 
-        std::ifstream in(csvPath_);
-        if (!in.is_open()) {
-            std::cout << "数据文件不存在，将创建新文件: " << csvPath_ << std::endl;
+        if (ShardedStore::isShardedPath(csvPath_)) {
+            loadSharded();
+            return;
+        }
+        if (arrow_ipc::isArrowPath(csvPath_)) {
+            loadArrow();
+            return;
+        }
+        if (lazy_) {
+            loadLazy();
             return;
         }
 
-        std::string line;
         bool isHeader = true;
-        while (std::getline(in, line)) {
-            if (line.empty()) continue;
-            
-            // 解析 CSV 行
-            std::vector<std::string> cols;
-            std::stringstream ss(line);
-            std::string token;
-            while (std::getline(ss, token, ',')) {
-                cols.push_back(token);
-            }
+        std::string error;
+        roster_io::ReadStatus status = roster_io::forEachLine(csvPath_, [&](const std::string& line) {
+            if (line.empty()) return;
 
             // 跳过表头
-            if (isHeader && cols.size() > 0 && cols[0] == "id") {
+            if (isHeader && line.compare(0, 3, "id,") == 0) {
                 isHeader = false;
-                continue;
+                return;
             }
             isHeader = false;
 
-            if (cols.size() < 5) continue;
+            HR_METRIC_ADD(RowsParsed, 1);
+            std::unique_ptr<Employee> emp = parseCSVLine(line);
+            if (!emp) {
+                HR_METRIC_ADD(ParseFailures, 1);
+                return;
+            }
+
+            nextId_ = std::max(nextId_, emp->getId() + 1);
+            employees_.push_back(std::move(emp));
+            reportProgress();
+        }, &error);
 
-            // 解析公共属性
-            int id = 0;
-            try { id = std::stoi(cols[0]); } catch (...) { continue; }
-            std::string name = cols[1];
-            std::string role = cols[2];
-            int level = 1;
-            try { level = std::stoi(cols[3]); } catch (...) {}
-            std::string gender = cols[4];
-            std::string birthday = (cols.size() > 5) ? cols[5] : "";
-
-            // 根据角色创建对应的派生类对象
-            std::unique_ptr<Employee> emp = createEmployeeByRole(role);
-            if (!emp) continue;
-
-            emp->setId(id);
-            emp->setName(name);
-            emp->setGender(gender);
-            emp->setLevel(level);
-            emp->setBirthday(birthday);
-            emp->parseCSV(cols);
+        if (status == roster_io::ReadStatus::NotFound) {
+            if (verbose_) *log_ << "数据文件不存在，将创建新文件: " << csvPath_ << std::endl;
+            return;
+        }
+        if (status == roster_io::ReadStatus::Corrupt && verbose_) {
+            *log_ << "数据文件损坏（" << error << "），仅加载了可读部分。" << std::endl;
+        }
+        rebuildIndex();
 
+        if (verbose_) *log_ << "已加载 " << employees_.size() << " 条员工记录。" << std::endl;
+    }
+
+    // 延迟加载：映射整个文件，每行只解析编号与岗位并记录行位置
+    void loadLazy() {
+        std::string error;
+        mapped_.reset(new roster_io::MappedRoster());
+        roster_io::ReadStatus status = mapped_->open(csvPath_, &error);
+        if (status == roster_io::ReadStatus::NotFound) {
+            mapped_.reset();
+            if (verbose_) *log_ << "数据文件不存在，将创建新文件: " << csvPath_ << std::endl;
+            return;
+        }
+        if (status == roster_io::ReadStatus::Corrupt && verbose_) {
+            *log_ << "数据文件损坏（" << error << "），仅加载了可读部分。" << std::endl;
+        }
+
+        bool isHeader = true;
+        mapped_->forEachLine([&](const char* line, size_t length) {
+            if (length == 0) return;
+            if (isHeader && length >= 3 && std::memcmp(line, "id,", 3) == 0) {
+                isHeader = false;
+                return;
+            }
+            isHeader = false;
+
+            HR_METRIC_ADD(RowsParsed, 1);
+            std::unique_ptr<Employee> emp = parseDeferred(line, length);
+            if (!emp) {
+                HR_METRIC_ADD(ParseFailures, 1);
+                return;
+            }
+            nextId_ = std::max(nextId_, emp->getId() + 1);
             employees_.push_back(std::move(emp));
-            nextId_ = std::max(nextId_, id + 1);
+            reportProgress();
+        });
+        rebuildIndex();
+
+        if (verbose_) {
+            *log_ << "已加载 " << employees_.size() << " 条员工记录（延迟解析，"
+                      << mapped_->size() / 1024 << " KB 已映射）。" << std::endl;
+        }
+    }
+
+    // 只解析编号与岗位，其余列留待首次访问；取舍规则与 fromColumns 一致
+    static std::unique_ptr<Employee> parseDeferred(const char* line, size_t length) {
+        const char* end = line + length;
+        const char* comma[4];
+        const char* p = line;
+        for (int i = 0; i < 4; ++i) {
+            comma[i] = static_cast<const char*>(std::memchr(p, ',', end - p));
+            if (!comma[i]) return nullptr;
+            p = comma[i] + 1;
         }
+        if (p == end) return nullptr;  // 第 5 列为空且位于行尾：按逗号拆分只得 4 列
+
+        int id = 0;
+        try { id = std::stoi(std::string(line, comma[0])); } catch (...) { return nullptr; }
+        std::unique_ptr<Employee> emp = createEmployeeByRole(std::string(comma[1] + 1, comma[2]));
+        if (!emp) return nullptr;
+        emp->setId(id);
+        emp->deferRow(line, length);
+        return emp;
+    }
 
-        std::cout << "已加载 " << employees_.size() << " 条员工记录。" << std::endl;
+    // 解码全部员工并释放映射（保存前调用：写回同一文件会使映射内容失效）
+    void releaseMapping() const {
+        if (!mapped_) return;
+        for (const auto& emp : employees_) emp->materialize();
+        mapped_.reset();
+    }
+
+    // 加载 Arrow IPC 列式文件：映射后按列直接构造员工对象，不解析文本
+    void loadArrow() {
+        std::string error;
+        size_t failures = 0;
+        roster_io::ReadStatus status = arrow_ipc::read(csvPath_, employees_, &failures, &error);
+        if (status == roster_io::ReadStatus::NotFound) {
+            if (verbose_) *log_ << "数据文件不存在，将创建新文件: " << csvPath_ << std::endl;
+            return;
+        }
+        if (status == roster_io::ReadStatus::Corrupt && verbose_) {
+            *log_ << "数据文件损坏（" << error << "），仅加载了可读部分。" << std::endl;
+        }
+        HR_METRIC_ADD(RowsParsed, employees_.size() + failures);
+        HR_METRIC_ADD(ParseFailures, failures);
+        for (const auto& emp : employees_) {
+            nextId_ = std::max(nextId_, emp->getId() + 1);
+        }
+        rebuildIndex();
+
+        if (verbose_) *log_ << "已加载 " << employees_.size() << " 条员工记录。" << std::endl;
+    }
+
+    // 并行加载分片目录
+    void loadSharded() {
+        store_.reset(new ShardedStore());
+        if (!store_->open(csvPath_)) {
+            if (verbose_) *log_ << "分片清单格式错误: " << csvPath_ << std::endl;
+            store_.reset();
+            return;
+        }
+
+        employees_ = store_->loadAll([](const std::string& line) {
+            HR_METRIC_ADD(RowsParsed, 1);
+            std::unique_ptr<Employee> emp = parseCSVLine(line);
+            if (!emp) HR_METRIC_ADD(ParseFailures, 1);
+            return emp;
+        });
+        for (const auto& emp : employees_) {
+            nextId_ = std::max(nextId_, emp->getId() + 1);
+        }
+        rebuildIndex();
+
+        if (verbose_) {
+            *log_ << "已加载 " << employees_.size() << " 条员工记录（"
+                      << store_->shardCount() << " 个分片）。" << std::endl;
+        }
+    }
+
+    // 按逗号拆分一行 CSV
+    static std::vector<std::string> splitCSV(const std::string& line) {
+        return Employee::splitCSV(line);
+    }
+
+    // 解析一行 CSV，返回对应的派生类对象；格式不符时返回 nullptr
+    static std::unique_ptr<Employee> parseCSVLine(const std::string& line) {
+        return fromColumns(splitCSV(line));
+    }
+
+    // 由 CSV 列向量构造员工对象
+    static std::unique_ptr<Employee> fromColumns(const std::vector<std::string>& cols) {
+        if (cols.size() < 5) return nullptr;
+
+        // 解析公共属性
+        int id = 0;
+        try { id = std::stoi(cols[0]); } catch (...) { return nullptr; }
+        int level = 1;
+        try { level = std::stoi(cols[3]); } catch (...) { HR_METRIC_ADD(ParseFailures, 1); }
+
+        // 根据角色创建对应的派生类对象
+        std::unique_ptr<Employee> emp = createEmployeeByRole(cols[2]);
+        if (!emp) return nullptr;
+
+        emp->setId(id);
+        emp->setName(cols[1]);
+        emp->setGender(cols[4]);
+        emp->setLevel(level);
+        emp->setBirthday((cols.size() > 5) ? cols[5] : "");
+        emp->setManagerId(Employee::parseManagerId(cols));
+        emp->parseCSV(cols);
+        return emp;
     }
 
     // 保存到 CSV 文件
+    // 分片模式下只重写被修改过的分片
     void save() const {
-        std::ofstream out(csvPath_);
-        if (!out.is_open()) {
-            std::cout << "无法写入文件: " << csvPath_ << std::endl;
+        HR_METRIC_TIMER(Save);
+        if (store_) {
+            size_t written = store_->saveDirty(employees_);
+            if (verbose_) {
+                std::cout << "数据已保存（重写 " << written << "/" << store_->shardCount()
+                          << " 个分片）。" << std::endl;
+            }
+            return;
+        }
+
+        bool ok = arrow_ipc::isArrowPath(csvPath_) ? writeArrow(csvPath_) : writeCSV(csvPath_);
+        if (!ok) {
+            if (verbose_) std::cout << "无法写入文件: " << csvPath_ << std::endl;
             return;
         }
+        if (verbose_) std::cout << "数据已保存。" << std::endl;
+    }
+
+    // 将全部员工写入单个 CSV 文件（.lz4 结尾时压缩）
+    bool writeCSV(const std::string& path) const {
+        releaseMapping();
+        roster_io::RosterWriter out;
+        if (!out.open(path)) return false;
 
         // 写入表头
-        out << "id,name,role,level,gender,birthday,param1,param2,param3\n";
+        out.write(ShardedStore::kHeader);
         
         for (const auto& emp : employees_) {
-            out << emp->toCSV() << "\n";
+            out.write(emp->toCSV());
+            out.write("\n");
         }
+        bool ok = out.close();
+        HR_METRIC_ADD(BytesWritten, out.bytesWritten());
+        return ok;
+    }
 
-        std::cout << "数据已保存。" << std::endl;
+    // 将全部员工写成 Arrow IPC 列式文件（由列式快照直接写出）
+    bool writeArrow(const std::string& path) const {
+        uint64_t bytes = 0;
+        bool ok = arrow_ipc::write(path, *columns(), employees_, &bytes);
+        HR_METRIC_ADD(BytesWritten, bytes);
+        return ok;
     }
 
+    // ========== 布局迁移 ==========
 
-    static std::unique_ptr<Employee> createEmployeeByRole(const std::string& role) {
-        if (role == "Manager") {
-            return std::make_unique<Manager>();
-        } else if (role == "PartTimeTech") {
-            return std::make_unique<PartTimeTechnician>();
-        } else if (role == "PartTimeSales") {
-            return std::make_unique<PartTimeSalesperson>();
-        } else if (role == "SalesManager") {
-            return std::make_unique<SalesManager>();
+    // 将当前数据写成分片目录（range 分区按现有最大编号均分区间）
+    bool exportSharded(const std::string& dir, size_t shards, ShardedStore::Partition partition) const {
+        long long width = 0;
+        if (partition == ShardedStore::Partition::Range) {
+            long long maxId = std::max(1, nextId_ - 1);
+            width = (maxId + static_cast<long long>(shards) - 1) / static_cast<long long>(shards);
         }
-        return nullptr;
+        ShardedStore target;
+        if (!target.create(dir, shards, partition, width)) return false;
+        return target.saveAll(employees_) == shards;
     }
 
+    // 将当前数据写成单个 CSV 文件
+    bool exportCSV(const std::string& path) const {
+        return writeCSV(path);
+    }
+
+    // 将当前数据写成 Arrow IPC 列式文件
+    bool exportArrow(const std::string& path) const {
+        return writeArrow(path);
+    }
+
+
+    static std::unique_ptr<Employee> createEmployeeByRole(const std::string& role) {
+        return roles::create(roles::code(role));
+    }
+
+    // 新增员工菜单序号（从 1 开始，即岗位编码加一）
     static std::unique_ptr<Employee> createEmployeeByChoice(int choice) {
-        switch (choice) {
-            case 1: return std::make_unique<Manager>();
-            case 2: return std::make_unique<PartTimeTechnician>();
-            case 3: return std::make_unique<SalesManager>();
-            case 4: return std::make_unique<PartTimeSalesperson>();
-            default: return nullptr;
+        if (choice < 1 || choice > static_cast<int>(roles::kCount)) return nullptr;
+        return roles::create(static_cast<uint8_t>(choice - 1));
+    }
+
+    // ========== 非交互接口（菜单与服务模式共用） ==========
+
+    // 按编号查找，未找到返回 nullptr
+    const Employee* findById(int id) const {
+        HR_METRIC_SAMPLED_TIMER(FindById);
+        auto it = idIndex_.find(id);
+        return it == idIndex_.end() ? nullptr : employees_[it->second].get();
+    }
+
+    // 按姓名查找（允许重名）
+    std::vector<const Employee*> findByName(const std::string& name) const {
+        HR_METRIC_TIMER(FindByName);
+        std::vector<const Employee*> result;
+        for (const auto& emp : employees_) {
+            if (emp->getName() == name) result.push_back(emp.get());
+        }
+        return result;
+    }
+
+    // 插入员工：编号 <= 0 时自动分配；编号已存在时返回 false
+    bool insertEmployee(std::unique_ptr<Employee> emp) {
+        HR_METRIC_TIMER(Insert);
+        if (!emp) return false;
+        if (emp->getId() <= 0) emp->setId(nextId_);
+        if (idIndex_.count(emp->getId())) return false;
+
+        nextId_ = std::max(nextId_, emp->getId() + 1);
+        markDirty(emp->getId());
+        indexEmployee(*emp);
+        publishChange(ChangeFeed::Op::Insert, emp->getId(), nullptr, emp.get());
+        idIndex_[emp->getId()] = employees_.size();
+        employees_.push_back(std::move(emp));
+        return true;
+    }
+
+    // 按编号删除，返回是否删除成功
+    bool eraseEmployee(int id) {
+        HR_METRIC_TIMER(Erase);
+        auto it = idIndex_.find(id);
+        if (it == idIndex_.end()) return false;
+
+        size_t pos = it->second;
+        detachReports(id);
+        idIndex_.erase(it);
+        markDirty(id);
+        unindexEmployee(*employees_[pos]);
+        publishChange(ChangeFeed::Op::Delete, id, std::move(employees_[pos]), nullptr);
+        employees_.erase(employees_.begin() + pos);
+        for (size_t i = pos; i < employees_.size(); ++i) {
+            idIndex_[employees_[i]->getId()] = i;
+        }
+        return true;
+    }
+
+    // 用新对象整体替换指定编号的员工（允许更换岗位），返回是否成功
+    bool replaceEmployee(int id, std::unique_ptr<Employee> emp) {
+        HR_METRIC_TIMER(Replace);
+        auto it = idIndex_.find(id);
+        if (it == idIndex_.end() || !emp) return false;
+        emp->setId(id);
+        unindexEmployee(*employees_[it->second]);
+        indexEmployee(*emp);
+        publishChange(ChangeFeed::Op::Update, id, std::move(employees_[it->second]), emp.get());
+        employees_[it->second] = std::move(emp);
+        markDirty(id);
+        return true;
+    }
+
+    // 批量删除：逐个摘除索引后一次性压缩数组，代价与删除人数无关；返回实际删除的人数
+    size_t eraseEmployees(const std::vector<int>& ids) {
+        HR_METRIC_TIMER(Erase);
+        size_t first = employees_.size();
+        size_t erased = 0;
+        for (int id : ids) {
+            auto it = idIndex_.find(id);
+            if (it == idIndex_.end()) continue;
+            size_t pos = it->second;
+            detachReports(id);
+            idIndex_.erase(it);
+            markDirty(id);
+            unindexEmployee(*employees_[pos]);
+            publishChange(ChangeFeed::Op::Delete, id, std::move(employees_[pos]), nullptr);
+            employees_[pos].reset();
+            first = std::min(first, pos);
+            ++erased;
+        }
+        if (erased == 0) return 0;
+
+        auto end = std::remove(employees_.begin() + first, employees_.end(), nullptr);
+        employees_.erase(end, employees_.end());
+        for (size_t i = first; i < employees_.size(); ++i) {
+            idIndex_[employees_[i]->getId()] = i;
+        }
+        return erased;
+    }
+
+    // 变更集的应用结果
+    struct ApplyResult {
+        size_t removed = 0;
+        size_t changed = 0;
+        size_t added = 0;
+        size_t failed = 0;  // 行无法解析，或要删除的编号不存在
+    };
+
+    // 原地应用变更集（删除、变更、新增依次进行，索引增量维护，分片模式下只有涉及的分片变脏）
+    // 变更的员工不存在时按新增处理，新增的编号已存在时按变更处理；不自动保存
+    ApplyResult applyChanges(const roster_diff::ChangeSet& changes) {
+        HR_METRIC_TIMER(ApplyChanges);
+        ApplyResult result;
+        result.removed = eraseEmployees(changes.removed);
+        result.failed = changes.removed.size() - result.removed;
+
+        auto upsert = [&](const std::string& row, size_t& counter) {
+            HR_METRIC_ADD(RowsParsed, 1);
+            std::unique_ptr<Employee> emp = parseCSVLine(row);
+            if (!emp) {
+                HR_METRIC_ADD(ParseFailures, 1);
+                ++result.failed;
+                return;
+            }
+            int id = emp->getId();
+            if (idIndex_.count(id) ? replaceEmployee(id, std::move(emp)) : insertEmployee(std::move(emp))) {
+                ++counter;
+            } else {
+                ++result.failed;
+            }
+        };
+        for (const std::string& row : changes.changed) upsert(row, result.changed);
+        for (const std::string& row : changes.added) upsert(row, result.added);
+        return result;
+    }
+
+    // 计算工资统计
+    SalaryStatistics computeStatistics() const {
+        HR_METRIC_TIMER(Statistics);
+        SalaryStatistics st;
+        st.employees = employees_.size();
+
+        for (const auto& emp : employees_) {
+            double salary = emp->calculateSalary();
+            st.total += salary;
+
+            uint8_t role = roles::code(emp->getRoleName());
+            if (role < roles::kCount) {
+                st.byRole[role].total += salary;
+                st.byRole[role].count++;
+            }
+        }
+        return st;
+    }
+
+    // 按月薪从高到低取前 k 名（k 为 0 时返回全部），直接按排名索引顺序读取，无需排序
+    std::vector<const Employee*> topBySalary(size_t k = 0) const {
+        return rankingPage(1, k == 0 ? employees_.size() : k);
+    }
+
+    // ========== 月薪排名（顺序统计索引） ==========
+
+    // 单个员工的排名信息；百分位为月薪严格低于该员工的人数占比
+    struct RankInfo {
+        size_t rank = 0;
+        size_t total = 0;
+        double percentile = 0.0;
+        size_t roleRank = 0;
+        size_t roleTotal = 0;
+        double rolePercentile = 0.0;
+    };
+
+    // 查询员工的全员名次与岗位内名次，编号不存在时返回 false
+    bool rankOf(int id, RankInfo& info) const {
+        HR_METRIC_TIMER(Ranking);
+        ensureIndexes();
+        const Employee* emp = findById(id);
+        if (!emp) return false;
+        double salary = emp->calculateSalary();
+        int role = ColumnSnapshot::roleCode(emp->getRoleName());
+
+        info.rank = salaryRank_.rankOf(*emp);
+        info.total = salaryRank_.size();
+        info.percentile = 100.0 * (info.total - salaryRank_.countAtLeast(salary)) / info.total;
+        info.roleRank = salaryRank_.rankOf(*emp, role);
+        info.roleTotal = salaryRank_.size(role);
+        info.rolePercentile = info.roleTotal == 0 ? 0.0
+            : 100.0 * (info.roleTotal - salaryRank_.countAtLeast(salary, role)) / info.roleTotal;
+        return true;
+    }
+
+    // 第 rank 名（从 1 开始）的员工；role 为 ColumnSnapshot::RoleCode，-1 表示全员
+    const Employee* employeeAtRank(size_t rank, int role = -1) const {
+        HR_METRIC_TIMER(Ranking);
+        ensureIndexes();
+        if (rank == 0 || rank > salaryRank_.size(role)) return nullptr;
+        return findById(salaryRank_.at(rank, role).id);
+    }
+
+    // 月薪在 [low, high] 内的人数
+    size_t countSalaryBetween(double low, double high, int role = -1) const {
+        HR_METRIC_TIMER(Ranking);
+        ensureIndexes();
+        return salaryRank_.countBetween(low, high, role);
+    }
+
+    // 从第 first 名（从 1 开始）起按排名顺序取 count 人
+    std::vector<const Employee*> rankingPage(size_t first, size_t count, int role = -1) const {
+        HR_METRIC_TIMER(Ranking);
+        ensureIndexes();
+        std::vector<const Employee*> result;
+        for (const SalaryRankIndex::Key& key : salaryRank_.page(first, count, role)) {
+            result.push_back(employees_[idIndex_.at(key.id)].get());
+        }
+        return result;
+    }
+
+    // ========== 汇报关系（汇报关系索引） ==========
+
+    // 某人的汇报关系；下属为递归的全部下属，不含本人。汇报链与直接下属最多列出 kReportingListLimit 人
+    static constexpr size_t kReportingListLimit = 50;
+    struct ReportingInfo {
+        int declaredManager = 0;               // 登记的上级编号
+        std::vector<const Employee*> chain;    // 直接上级、上级的上级……
+        bool chainTruncated = false;
+        std::vector<const Employee*> direct;   // 直接下属
+        size_t directCount = 0;
+        size_t headcount = 0;
+        double payroll = 0.0;
+        std::vector<const Employee*> top;      // 下属中月薪最高的 k 人
+    };
+
+    // 查询汇报关系，编号不存在时返回 false
+    bool reportingOf(int id, size_t k, ReportingInfo& info) const {
+        HR_METRIC_TIMER(Reporting);
+        ensureIndexes();
+        const Employee* emp = findById(id);
+        if (!emp) return false;
+        info = ReportingInfo();
+        info.declaredManager = emp->getManagerId();
+        for (int m = reporting_.managerOf(id); m != 0; m = reporting_.managerOf(m)) {
+            if (info.chain.size() == kReportingListLimit) {
+                info.chainTruncated = true;
+                break;
+            }
+            info.chain.push_back(findById(m));
+        }
+        reporting_.forEachDirectReport(id, [&](int report) {
+            if (info.directCount++ < kReportingListLimit) info.direct.push_back(findById(report));
+        });
+        ReportingIndex::Totals totals = reporting_.totals(id);
+        info.headcount = totals.headcount;
+        info.payroll = totals.payroll;
+        for (const ReportingIndex::Entry& e : reporting_.topReports(id, k)) info.top.push_back(findById(e.id));
+        return true;
+    }
+
+    // id 能否向 managerId 汇报：0 表示无上级；否则上级须存在，且不能是本人或其下属（否则形成环）
+    bool canReportTo(int id, int managerId) const {
+        ensureIndexes();
+        return reporting_.canReportTo(id, managerId);
+    }
+
+    // 上级缺席或会形成环、暂按最高层处理的人数
+    size_t unresolvedManagers() const {
+        ensureIndexes();
+        return reporting_.unresolved();
+    }
+
+    // 查找 (month, day) 起未来 days 天内过生日的员工
+    std::vector<const Employee*> upcomingBirthdays(int currentMonth, int currentDay,
+                                                   int reminderDays) const {
+        HR_METRIC_TIMER(Birthday);
+        std::vector<const Employee*> result;
+
+        for (const auto& emp : employees_) {
+            std::string birthday = emp->getBirthday();
+            if (birthday.empty() || birthday.length() < 10) continue;
+
+            int birthMonth = 0, birthDay = 0;
+            try {
+                birthMonth = std::stoi(birthday.substr(5, 2));
+                birthDay = std::stoi(birthday.substr(8, 2));
+            } catch (...) {
+                continue;
+            }
+
+            // 简化逻辑：只比较月和日，计算天数差
+            int currentDayOfYear = currentMonth * 31 + currentDay;
+            int birthDayOfYear = birthMonth * 31 + birthDay;
+
+            // 如果生日已过今年，算作明年
+            if (birthDayOfYear < currentDayOfYear) {
+                birthDayOfYear += 365;
+            }
+
+            int daysUntilBirthday = birthDayOfYear - currentDayOfYear;
+
+            if (daysUntilBirthday >= 0 && daysUntilBirthday <= reminderDays) {
+                result.push_back(emp.get());
+            }
+        }
+        return result;
+    }
+
+    // ========== 条件查询 ==========
+
+    // 当前数据的列式快照（过期时重建；返回的快照在数据修改后仍可安全读取）
+    std::shared_ptr<const ColumnSnapshot> columns() const {
+        std::lock_guard<std::mutex> lock(columnsMutex_);
+        if (!columns_ || columnsVersion_ != version_) {
+            std::shared_ptr<ColumnSnapshot> snapshot(new ColumnSnapshot());
+            snapshot->build(employees_);
+            columns_ = std::move(snapshot);
+            columnsVersion_ = version_;
         }
+        return columns_;
+    }
+
+    // 执行已编译的查询，返回当前快照上的选择位图
+    query::Selection select(const query::CompiledQuery& q) const {
+        std::shared_ptr<const ColumnSnapshot> snapshot = columns();
+        HR_METRIC_TIMER(Query);
+        return q.evaluate(*snapshot);
+    }
+
+    // 符合查询的人数：条件均可由位图索引回答时只做位图求交计数，否则扫描列式快照
+    size_t countMatching(const query::CompiledQuery& q) const {
+        ensureIndexes();
+        std::vector<const RoaringBitmap*> sets;
+        std::vector<RoaringBitmap> scratch;
+        if (bitmapIndex_.plan(q, sets, scratch)) {
+            HR_METRIC_TIMER(Query);
+            return static_cast<size_t>(RoaringBitmap::andCardinality(sets));
+        }
+        return select(q).count();
+    }
+
+    // 符合查询的员工：走位图索引时只访问命中的编号（按编号升序）
+    std::vector<const Employee*> matchingEmployees(const query::CompiledQuery& q) const {
+        ensureIndexes();
+        std::vector<const RoaringBitmap*> sets;
+        std::vector<RoaringBitmap> scratch;
+        if (!bitmapIndex_.plan(q, sets, scratch)) return selectedEmployees(select(q));
+
+        HR_METRIC_TIMER(Query);
+        RoaringBitmap hits = RoaringBitmap::intersect(sets);
+        std::vector<const Employee*> result;
+        result.reserve(hits.count());
+        hits.forEach([&](uint32_t id) {
+            auto it = idIndex_.find(static_cast<int>(id));
+            if (it != idIndex_.end()) result.push_back(employees_[it->second].get());
+        });
+        return result;
+    }
+
+    const BitmapIndex& bitmapIndex() const {
+        ensureIndexes();
+        return bitmapIndex_;
+    }
+
+    // 在当前快照上生成透视表，filter 非空时只汇总符合条件的员工
+    void buildPivot(report::PivotTable& table, const query::CompiledQuery* filter = nullptr) const {
+        std::shared_ptr<const ColumnSnapshot> snapshot = columns();
+        HR_METRIC_TIMER(GroupBy);
+        if (filter) {
+            query::Selection sel = filter->evaluate(*snapshot);
+            table.build(*snapshot, &sel);
+        } else {
+            table.build(*snapshot);
+        }
+    }
+
+    // 选择位图对应的员工（位图须来自当前版本的快照）
+    std::vector<const Employee*> selectedEmployees(const query::Selection& sel) const {
+        std::vector<const Employee*> result;
+        result.reserve(sel.count());
+        sel.forEach([&](size_t row) { result.push_back(employees_[row].get()); });
+        return result;
+    }
+
+    // 只统计被选中的员工（直接读取快照中的岗位与月薪列）
+    SalaryStatistics computeStatistics(const query::Selection& sel) const {
+        std::shared_ptr<const ColumnSnapshot> snapshot = columns();
+        HR_METRIC_TIMER(Statistics);
+        SalaryStatistics st;
+        sel.forEach([&](size_t row) {
+            double salary = snapshot->salary[row];
+            st.employees++;
+            st.total += salary;
+            uint8_t role = snapshot->role[row];
+            if (role < roles::kCount) {
+                st.byRole[role].count++;
+                st.byRole[role].total += salary;
+            }
+        });
+        return st;
+    }
+
+    // 被选中员工按月薪从高到低的前 k 名（k 为 0 时返回全部）
+    std::vector<const Employee*> topBySalary(const query::Selection& sel, size_t k) const {
+        std::shared_ptr<const ColumnSnapshot> snapshot = columns();
+        HR_METRIC_TIMER(Ranking);
+        std::vector<std::pair<double, size_t>> keyed;
+        keyed.reserve(sel.count());
+        sel.forEach([&](size_t row) { keyed.emplace_back(snapshot->salary[row], row); });
+
+        auto byScoreDesc = [](const std::pair<double, size_t>& a, const std::pair<double, size_t>& b) {
+            return a.first > b.first;
+        };
+        if (k == 0 || k >= keyed.size()) {
+            std::sort(keyed.begin(), keyed.end(), byScoreDesc);
+        } else {
+            std::partial_sort(keyed.begin(), keyed.begin() + k, keyed.end(), byScoreDesc);
+            keyed.resize(k);
+        }
+
+        std::vector<const Employee*> result;
+        result.reserve(keyed.size());
+        for (const auto& kv : keyed) result.push_back(employees_[kv.second].get());
+        return result;
     }
 
     // ========== CRUD 操作 ==========
 
+    // 输入上级编号，非法时重新输入
+    void inputManagerId(Employee& emp) const {
+        while (true) {
+            std::cout << "上级编号(0 或直接回车表示无上级): ";
+            std::cout.flush();
+            std::string s;
+            std::getline(std::cin, s);
+            int managerId = s.empty() ? 0 : -1;
+            try { if (!s.empty()) managerId = std::stoi(s); } catch (...) {}
+            if (managerId >= 0 && canReportTo(emp.getId(), managerId)) {
+                emp.setManagerId(managerId);
+                return;
+            }
+            std::cout << "上级编号无效：须为已有员工的编号，且不能是本人或其下属，请重试。" << std::endl;
+        }
+    }
+
     // 添加员工
     void addEmployee() {
-        std::cout << "\n选择员工类型:\n"
-                  << "1. 经理 (固定月薪)\n"
-                  << "2. 兼职技术人员 (按工时计薪)\n"
-                  << "3. 销售经理 (固定月薪 + 销售提成)\n"
-                  << "4. 兼职推销员 (按销售提成)\n"
-                  << "请选择(1-4): ";
+        std::cout << "\n选择员工类型:\n";
+        for (uint8_t r = 0; r < roles::kCount; ++r) {
+            std::cout << (r + 1) << ". " << roles::fullLabel(r) << " (" << roles::salaryHint(r) << ")\n";
+        }
+        std::cout << "请选择(1-" << roles::kCount << "): ";
         std::cout.flush();
 
         std::string s;
@@ -155,14 +971,15 @@ public:
             return;
         }
 
-        emp->setId(nextId_++);
+        emp->setId(nextId_);
         emp->inputBasicInfo();
         emp->inputSpecificInfo();
+        inputManagerId(*emp);
 
         std::cout << "\n已添加员工，编号: " << emp->getId() << std::endl;
         emp->display();
 
-        employees_.push_back(std::move(emp));
+        insertEmployee(std::move(emp));
         save();
     }
 
@@ -175,11 +992,7 @@ public:
         int id = 0;
         try { id = std::stoi(s); } catch (...) {}
 
-        auto it = std::remove_if(employees_.begin(), employees_.end(),
-            [id](const std::unique_ptr<Employee>& e) { return e->getId() == id; });
-
-        if (it != employees_.end()) {
-            employees_.erase(it, employees_.end());
+        if (eraseEmployee(id)) {
             save();
             std::cout << "已删除编号为 " << id << " 的员工。" << std::endl;
         } else {
@@ -200,14 +1013,11 @@ public:
             std::string name;
             std::getline(std::cin, name);
 
-            bool found = false;
-            for (const auto& emp : employees_) {
-                if (emp->getName() == name) {
-                    emp->display();
-                    found = true;
-                }
+            std::vector<const Employee*> found = findByName(name);
+            for (const auto* emp : found) {
+                emp->display();
             }
-            if (!found) {
+            if (found.empty()) {
                 std::cout << "未检索到姓名为 \"" << name << "\" 的员工。" << std::endl;
             }
         } else if (s == "2") {
@@ -217,15 +1027,10 @@ public:
             int id = 0;
             try { id = std::stoi(s); } catch (...) {}
 
-            bool found = false;
-            for (const auto& emp : employees_) {
-                if (emp->getId() == id) {
-                    emp->display();
-                    found = true;
-                    break;
-                }
-            }
-            if (!found) {
+            const Employee* emp = findById(id);
+            if (emp) {
+                emp->display();
+            } else {
                 std::cout << "未检索到编号为 " << id << " 的员工。" << std::endl;
             }
         } else {
@@ -242,25 +1047,26 @@ public:
         int id = 0;
         try { id = std::stoi(s); } catch (...) {}
 
-        Employee* target = nullptr;
-        for (auto& emp : employees_) {
-            if (emp->getId() == id) {
-                target = emp.get();
-                break;
-            }
-        }
-
-        if (!target) {
+        auto it = idIndex_.find(id);
+        if (it == idIndex_.end()) {
             std::cout << "未找到编号为 " << id << " 的员工。" << std::endl;
             return;
         }
+        Employee* target = employees_[it->second].get();
 
         std::cout << "当前信息:" << std::endl;
         target->display();
 
         std::cout << "\n重新输入信息（按回车保留原值暂不支持，将覆盖）:\n";
+        ensureIndexes();  // 校验上级编号需要汇报关系索引，须在摘除索引之前构建
+        std::unique_ptr<Employee> before = feed_ ? target->clone() : nullptr;
+        unindexEmployee(*target);
         target->inputBasicInfo();
         target->inputSpecificInfo();
+        inputManagerId(*target);
+        indexEmployee(*target);
+        markDirty(id);
+        publishChange(ChangeFeed::Op::Update, id, std::move(before), target);
 
         save();
         std::cout << "修改完成。" << std::endl;
@@ -289,52 +1095,43 @@ public:
             return;
         }
 
-        double total = 0.0;
-        double managerTotal = 0.0;
-        double techTotal = 0.0;
-        double salesManagerTotal = 0.0;
-        double salespersonTotal = 0.0;
-
-        int managerCount = 0, techCount = 0, salesManagerCount = 0, salespersonCount = 0;
+        printStatistics(computeStatistics());
+    }
 
-        for (const auto& emp : employees_) {
-            double salary = emp->calculateSalary();
-            total += salary;
-
-            std::string role = emp->getRoleName();
-            if (role == "Manager") {
-                managerTotal += salary;
-                managerCount++;
-            } else if (role == "PartTimeTech") {
-                techTotal += salary;
-                techCount++;
-            } else if (role == "SalesManager") {
-                salesManagerTotal += salary;
-                salesManagerCount++;
-            } else if (role == "PartTimeSales") {
-                salespersonTotal += salary;
-                salespersonCount++;
-            }
-        }
+    // 输出工资统计报告（流式统计模式共用）
+    static void printStatistics(const SalaryStatistics& st) {
+        double total = st.total;
 
         std::cout << std::fixed << std::setprecision(2);
         std::cout << "\n========== 工资统计 ==========" << std::endl;
-        std::cout << "员工总数: " << employees_.size() << " 人" << std::endl;
+        std::cout << "员工总数: " << st.employees << " 人" << std::endl;
         std::cout << "工资总额: " << total << " 元" << std::endl;
         std::cout << std::endl;
 
         std::cout << "各类员工统计:" << std::endl;
-        std::cout << "  经理: " << managerCount << " 人, 工资合计 " << managerTotal 
-                  << " 元, 占比 " << (total > 0 ? managerTotal / total * 100 : 0) << "%" << std::endl;
-        std::cout << "  兼职技术: " << techCount << " 人, 工资合计 " << techTotal 
-                  << " 元, 占比 " << (total > 0 ? techTotal / total * 100 : 0) << "%" << std::endl;
-        std::cout << "  销售经理: " << salesManagerCount << " 人, 工资合计 " << salesManagerTotal 
-                  << " 元, 占比 " << (total > 0 ? salesManagerTotal / total * 100 : 0) << "%" << std::endl;
-        std::cout << "  兼职推销: " << salespersonCount << " 人, 工资合计 " << salespersonTotal 
-                  << " 元, 占比 " << (total > 0 ? salespersonTotal / total * 100 : 0) << "%" << std::endl;
+        for (uint8_t r = 0; r < roles::kCount; ++r) {
+            const RoleTotals& t = st.byRole[r];
+            std::cout << "  " << roles::label(r) << ": " << t.count << " 人, 工资合计 " << t.total
+                      << " 元, 占比 " << (total > 0 ? t.total / total * 100 : 0) << "%" << std::endl;
+        }
         std::cout << "==============================" << std::endl;
     }
 
+    // 月薪分布：全员、各岗位、各级别的中位数 / P90 / P99 与直方图
+    const SalaryDistribution& salaryDistribution() const {
+        ensureIndexes();
+        return distribution_;
+    }
+
+    void distributionReport() const {
+        if (employees_.empty()) {
+            std::cout << "当前没有员工记录。" << std::endl;
+            return;
+        }
+        HR_METRIC_TIMER(Statistics);
+        salaryDistribution().print(std::cout);
+    }
+
     // 全员提级
     void promoteAll() {
         if (employees_.empty()) {
@@ -342,8 +1139,16 @@ public:
             return;
         }
 
-        for (auto& emp : employees_) {
-            emp->promote(1);
+        {
+            HR_METRIC_TIMER(PromoteAll);
+            for (auto& emp : employees_) {
+                emp->promote(1);
+            }
+            if (store_) store_->markAllDirty();
+            bitmapIndex_.shiftLevels(1);
+            distribution_.shiftLevels(1);
+            ++version_;
+            if (feed_) feed_->publish(ChangeFeed::Op::PromoteAll, 0, nullptr, nullptr, 1);
         }
         save();
         std::cout << "全员已提升一级。" << std::endl;
@@ -356,27 +1161,21 @@ public:
             return;
         }
 
-        // 创建索引并排序
-        std::vector<size_t> indices(employees_.size());
-        for (size_t i = 0; i < indices.size(); ++i) {
-            indices[i] = i;
-        }
-
-        std::sort(indices.begin(), indices.end(), [this](size_t a, size_t b) {
-            return employees_[a]->calculateSalary() > employees_[b]->calculateSalary();
-        });
-
         std::cout << "\n========== 业绩排名 (按月薪) ==========" << std::endl;
         int rank = 1;
-        for (size_t idx : indices) {
-            const auto& emp = employees_[idx];
-            std::cout << "第 " << rank++ << " 名: "
-                      << emp->getName() << " (" << emp->getRoleName() << ") - "
-                      << std::fixed << std::setprecision(2) << emp->calculateSalary() << " 元" << std::endl;
+        for (const Employee* emp : topBySalary()) {
+            printRankingLine(rank++, emp->getName(), emp->getRoleName(), emp->calculateSalary());
         }
         std::cout << "=======================================" << std::endl;
     }
 
+    // 输出一行排名（流式统计模式共用）
+    static void printRankingLine(int rank, const std::string& name, const std::string& role, double salary) {
+        std::cout << "第 " << rank << " 名: "
+                  << name << " (" << role << ") - "
+                  << std::fixed << std::setprecision(2) << salary << " 元" << std::endl;
+    }
+
     // 生日提醒功能
     void birthdayReminder() const {
         if (employees_.empty()) {
@@ -395,7 +1194,6 @@ public:
             return;
         }
 
-        std::string currentMonthDay = currentDate.substr(5, 5); // MM-DD
         int currentMonth = 0, currentDay = 0;
         try {
             currentMonth = std::stoi(currentDate.substr(5, 2));
@@ -412,42 +1210,13 @@ public:
         int reminderDays = 7;
         try { reminderDays = std::stoi(daysStr); } catch (...) {}
 
-        std::vector<const Employee*> upcomingBirthdays;
-
-        for (const auto& emp : employees_) {
-            std::string birthday = emp->getBirthday();
-            if (birthday.empty() || birthday.length() < 10) continue;
+        std::vector<const Employee*> upcoming = upcomingBirthdays(currentMonth, currentDay, reminderDays);
 
-            std::string birthMonthDay = birthday.substr(5, 5); // MM-DD
-            int birthMonth = 0, birthDay = 0;
-            try {
-                birthMonth = std::stoi(birthday.substr(5, 2));
-                birthDay = std::stoi(birthday.substr(8, 2));
-            } catch (...) {
-                continue;
-            }
-
-            // 简化逻辑：只比较月和日，计算天数差
-            int currentDayOfYear = currentMonth * 31 + currentDay;
-            int birthDayOfYear = birthMonth * 31 + birthDay;
-            
-            // 如果生日已过今年，算作明年
-            if (birthDayOfYear < currentDayOfYear) {
-                birthDayOfYear += 365;
-            }
-
-            int daysUntilBirthday = birthDayOfYear - currentDayOfYear;
-            
-            if (daysUntilBirthday >= 0 && daysUntilBirthday <= reminderDays) {
-                upcomingBirthdays.push_back(emp.get());
-            }
-        }
-
-        if (upcomingBirthdays.empty()) {
+        if (upcoming.empty()) {
             std::cout << "\n未来 " << reminderDays << " 天内没有员工生日。" << std::endl;
         } else {
             std::cout << "\n========== 生日提醒 (未来" << reminderDays << "天内) ==========" << std::endl;
-            for (const auto* emp : upcomingBirthdays) {
+            for (const auto* emp : upcoming) {
                 std::string birthday = emp->getBirthday();
                 std::string birthMonthDay = birthday.substr(5, 5);
                 std::cout << "员工: " << emp->getName() 
@@ -459,10 +1228,313 @@ public:
         }
     }
 
+    // 条件查询：输入表达式，按需列出、统计或排名
+    void queryEmployees() const {
+        if (employees_.empty()) {
+            std::cout << "当前没有员工记录。" << std::endl;
+            return;
+        }
+
+        std::cout << "字段: id name role level gender birthday salary sales rate hours base\n"
+                  << "示例: role == SalesManager && level >= 4 && sales > 300000\n"
+                  << "输入查询条件: ";
+        std::cout.flush();
+        std::string text;
+        std::getline(std::cin, text);
+
+        query::CompiledQuery q;
+        std::string error;
+        if (!q.compile(text, &error)) {
+            std::cout << "查询条件有误，" << error << std::endl;
+            return;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        size_t matched = countMatching(q);
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "符合条件: " << matched << " 人 (共 " << employees_.size() << " 人, 用时 "
+                  << std::fixed << std::setprecision(3) << ms << " ms)" << std::endl;
+        if (matched == 0) return;
+
+        std::cout << "1. 列出  2. 工资统计  3. 月薪排名  (直接回车返回): ";
+        std::cout.flush();
+        std::string s;
+        std::getline(std::cin, s);
+
+        if (s == "1") {
+            for (const Employee* emp : matchingEmployees(q)) {
+                emp->display();
+            }
+        } else if (s == "2") {
+            printStatistics(computeStatistics(select(q)));
+        } else if (s == "3") {
+            std::cout << "\n========== 业绩排名 (按月薪) ==========" << std::endl;
+            int rank = 1;
+            for (const Employee* emp : topBySalary(select(q), 0)) {
+                printRankingLine(rank++, emp->getName(), emp->getRoleName(), emp->calculateSalary());
+            }
+            std::cout << "=======================================" << std::endl;
+        }
+    }
+
+    // 分组透视报表：按任意维度组合汇总月薪，输出到控制台、CSV 或 JSON
+    void pivotReport() const {
+        if (employees_.empty()) {
+            std::cout << "当前没有员工记录。" << std::endl;
+            return;
+        }
+
+        std::string rowText, columnText, aggText, filterText;
+        std::cout << "可用维度: role level gender year\n"
+                  << "行维度(逗号分隔，如 role,level): ";
+        std::cout.flush();
+        std::getline(std::cin, rowText);
+        std::cout << "列维度(直接回车不分列): ";
+        std::cout.flush();
+        std::getline(std::cin, columnText);
+        std::cout << "统计项 count,sum,avg,min,max (直接回车为 count,sum,avg): ";
+        std::cout.flush();
+        std::getline(std::cin, aggText);
+        std::cout << "过滤条件(同条件查询，直接回车不过滤): ";
+        std::cout.flush();
+        std::getline(std::cin, filterText);
+
+        std::vector<report::Dim> rowDims, columnDims;
+        std::vector<report::Agg> aggs;
+        if (!report::parseDimList(rowText, rowDims) || !report::parseDimList(columnText, columnDims) ||
+            columnDims.size() > 1) {
+            std::cout << "维度无效（列维度最多一个）。" << std::endl;
+            return;
+        }
+        if (!columnDims.empty() && std::find(rowDims.begin(), rowDims.end(), columnDims[0]) != rowDims.end()) {
+            std::cout << "列维度不能同时作为行维度。" << std::endl;
+            return;
+        }
+        if (!report::parseAggList(aggText.empty() ? "count,sum,avg" : aggText, aggs) || aggs.empty()) {
+            std::cout << "统计项无效。" << std::endl;
+            return;
+        }
+        query::CompiledQuery filter;
+        std::string error;
+        if (!filterText.empty() && !filter.compile(filterText, &error)) {
+            std::cout << "过滤条件有误，" << error << std::endl;
+            return;
+        }
+
+        report::PivotTable table(rowDims, !columnDims.empty(),
+                                 columnDims.empty() ? report::Dim::Role : columnDims[0], aggs);
+        buildPivot(table, filterText.empty() ? nullptr : &filter);
+
+        std::cout << "输出到 1.控制台 2.CSV 文件 3.JSON 文件: ";
+        std::cout.flush();
+        std::string s;
+        std::getline(std::cin, s);
+        if (s == "2" || s == "3") {
+            std::cout << "文件路径: ";
+            std::cout.flush();
+            std::string path;
+            std::getline(std::cin, path);
+            std::ofstream out(path);
+            if (!out.is_open()) {
+                std::cout << "无法写入文件: " << path << std::endl;
+                return;
+            }
+            if (s == "2") table.writeCSV(out);
+            else out << table.toJSON() << "\n";
+            std::cout << "报表已导出到 " << path << "（" << table.rowCount() << " 行）" << std::endl;
+        } else {
+            std::cout << std::endl;
+            table.printConsole(std::cout);
+        }
+    }
+
+    // 排名与分位查询（基于月薪排名索引，无需排序）
+    void rankQuery() const {
+        if (employees_.empty()) {
+            std::cout << "当前没有员工记录。" << std::endl;
+            return;
+        }
+        ensureIndexes();
+
+        std::cout << "1. 员工名次与百分位\n"
+                  << "2. 第 k 名员工\n"
+                  << "3. 月薪区间人数\n"
+                  << "4. 分页排名\n"
+                  << "请选择: ";
+        std::cout.flush();
+        std::string choice;
+        std::getline(std::cin, choice);
+
+        auto readLine = [](const std::string& prompt) {
+            std::cout << prompt;
+            std::cout.flush();
+            std::string s;
+            std::getline(std::cin, s);
+            return s;
+        };
+        // 岗位范围：直接回车为全员，否则为英文岗位名
+        auto readRole = [&](int& role) {
+            std::string s = readLine("岗位(" + roles::nameList("/") + "，直接回车为全员): ");
+            role = -1;
+            if (s.empty()) return true;
+            uint8_t code = ColumnSnapshot::roleCode(s);
+            if (code == ColumnSnapshot::kUnknownRole) {
+                std::cout << "未知岗位: " << s << std::endl;
+                return false;
+            }
+            role = code;
+            return true;
+        };
+
+        try {
+            if (choice == "1") {
+                int id = std::stoi(readLine("员工编号: "));
+                RankInfo info;
+                if (!rankOf(id, info)) {
+                    std::cout << "未找到编号为 " << id << " 的员工。" << std::endl;
+                    return;
+                }
+                const Employee* emp = findById(id);
+                std::cout << emp->getName() << " (" << emp->getRoleName() << ") 月薪 "
+                          << std::fixed << std::setprecision(2) << emp->calculateSalary() << " 元\n"
+                          << "全员排名: 第 " << info.rank << " / " << info.total
+                          << " 名，高于 " << info.percentile << "% 的员工\n"
+                          << "岗位内排名: 第 " << info.roleRank << " / " << info.roleTotal
+                          << " 名，高于 " << info.rolePercentile << "% 的同岗位员工" << std::endl;
+            } else if (choice == "2") {
+                size_t k = std::stoul(readLine("名次 k: "));
+                int role = -1;
+                if (!readRole(role)) return;
+                const Employee* emp = employeeAtRank(k, role);
+                if (!emp) {
+                    std::cout << "名次超出范围（共 " << salaryRank_.size(role) << " 人）。" << std::endl;
+                    return;
+                }
+                printRankingLine(static_cast<int>(k), emp->getName(), emp->getRoleName(), emp->calculateSalary());
+            } else if (choice == "3") {
+                double low = std::stod(readLine("月薪下限: "));
+                double high = std::stod(readLine("月薪上限: "));
+                int role = -1;
+                if (!readRole(role)) return;
+                std::cout << "月薪在 [" << std::fixed << std::setprecision(2) << low << ", " << high
+                          << "] 内的员工: " << countSalaryBetween(low, high, role) << " 人" << std::endl;
+            } else if (choice == "4") {
+                size_t pageSize = std::stoul(readLine("每页人数: "));
+                size_t page = std::stoul(readLine("页码(从 1 开始): "));
+                int role = -1;
+                if (!readRole(role)) return;
+                if (pageSize == 0 || page == 0) {
+                    std::cout << "每页人数与页码须大于 0。" << std::endl;
+                    return;
+                }
+                size_t total = salaryRank_.size(role);
+                size_t first = (page - 1) * pageSize + 1;
+                std::cout << "\n========== 业绩排名 第 " << page << "/" << (total + pageSize - 1) / pageSize
+                          << " 页 (共 " << total << " 人) ==========" << std::endl;
+                int rank = static_cast<int>(first);
+                for (const Employee* emp : rankingPage(first, pageSize, role)) {
+                    printRankingLine(rank++, emp->getName(), emp->getRoleName(), emp->calculateSalary());
+                }
+            } else {
+                std::cout << "无效选择。" << std::endl;
+            }
+        } catch (...) {
+            std::cout << "输入格式错误。" << std::endl;
+        }
+    }
+
+    // 汇报关系：汇报链、直接下属、全部下属的人数与月薪合计、下属月薪前 k 名
+    void reportingReport() const {
+        if (employees_.empty()) {
+            std::cout << "当前没有员工记录。" << std::endl;
+            return;
+        }
+        auto readLine = [](const std::string& prompt) {
+            std::cout << prompt;
+            std::cout.flush();
+            std::string s;
+            std::getline(std::cin, s);
+            return s;
+        };
+
+        int id = 0;
+        size_t k = 10;
+        try {
+            id = std::stoi(readLine("员工编号: "));
+            std::string s = readLine("显示下属月薪前几名(默认10): ");
+            if (!s.empty()) k = std::stoul(s);
+        } catch (...) {
+            std::cout << "输入格式错误。" << std::endl;
+            return;
+        }
+        ReportingInfo info;
+        if (!reportingOf(id, k, info)) {
+            std::cout << "未找到编号为 " << id << " 的员工。" << std::endl;
+            return;
+        }
+
+        const Employee* emp = findById(id);
+        double salary = emp->calculateSalary();
+        auto name = [](const Employee* e) { return e->getName() + "(" + std::to_string(e->getId()) + ")"; };
+        std::cout << std::fixed << std::setprecision(2);
+        std::cout << "\n========== 汇报关系 ==========" << std::endl;
+        std::cout << name(emp) << " " << emp->getRoleName() << " 月薪 " << salary << " 元" << std::endl;
+
+        std::cout << "汇报链: ";
+        if (info.chain.empty()) std::cout << "无（最高层）";
+        for (size_t i = 0; i < info.chain.size(); ++i) std::cout << (i ? " -> " : "") << name(info.chain[i]);
+        if (info.chainTruncated) std::cout << " -> ...";
+        std::cout << std::endl;
+        int effective = info.chain.empty() ? 0 : info.chain[0]->getId();
+        if (info.declaredManager != effective) {
+            std::cout << "（登记的上级 " << info.declaredManager << " 不存在或会形成环，暂按最高层处理）" << std::endl;
+        }
+
+        std::cout << "直接下属: " << info.directCount << " 人";
+        for (size_t i = 0; i < info.direct.size(); ++i) std::cout << (i ? "、" : "  ") << name(info.direct[i]);
+        if (info.directCount > info.direct.size()) std::cout << " 等";
+        std::cout << std::endl;
+        std::cout << "全部下属: " << info.headcount << " 人，月薪合计 " << info.payroll << " 元" << std::endl;
+        std::cout << "含本人: " << info.headcount + 1 << " 人，月薪合计 " << info.payroll + salary << " 元" << std::endl;
+
+        if (!info.top.empty()) {
+            std::cout << "\n下属月薪前 " << info.top.size() << " 名:" << std::endl;
+            int rank = 1;
+            for (const Employee* e : info.top) {
+                printRankingLine(rank++, e->getName(), e->getRoleName(), e->calculateSalary());
+            }
+        }
+        std::cout << "==============================" << std::endl;
+    }
+
+    // 运行指标：控制台报告，可选导出 JSON
+    void showMetrics() const {
+        if (!metrics::kEnabled) {
+            std::cout << "运行指标已在编译时关闭 (HR_DISABLE_METRICS)。" << std::endl;
+            return;
+        }
+        metrics::Registry::instance().report(std::cout);
+
+        std::cout << "导出 JSON 到文件(直接回车跳过): ";
+        std::cout.flush();
+        std::string path;
+        std::getline(std::cin, path);
+        if (path.empty()) return;
+
+        std::ofstream out(path);
+        if (!out.is_open()) {
+            std::cout << "无法写入文件: " << path << std::endl;
+            return;
+        }
+        out << metrics::Registry::instance().toJSON() << "\n";
+        std::cout << "指标已导出到 " << path << std::endl;
+    }
+
     // ========== 辅助 ==========
     
     size_t count() const { return employees_.size(); }
     const std::string& getDataPath() const { return csvPath_; }
+    bool isSharded() const { return store_ != nullptr; }
 };
 
 #endif // EMPLOYEEMANAGER_H
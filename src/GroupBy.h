@@ -0,0 +1,536 @@
+#ifndef GROUPBY_H
+#define GROUPBY_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <limits>
+#include <thread>
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+
+#include "ColumnSnapshot.h"
+#include "Query.h"
+#include "JsonUtil.h"
+
+/**
+ * 分组聚合与透视报表 (GroupBy / PivotTable)
+ * - 可按 岗位、级别、性别、出生年份 任意组合分组，求人数及月薪 合计/平均/最低/最高
+ * - 每行的分组键由各维度列直接拼成一个 64 位整数（未选维度被掩码清零），
+ *   在开放寻址（线性探测）哈希表中累加，表项连续存放，分组数不大时整表常驻缓存
+ * - 大花名册按线程切分行区间，各线程写自己的局部表，最后合并
+ * - 透视表以一个维度的取值作为列，其余维度作为行，可输出到控制台、CSV 或 JSON
+ */
+namespace report {
+
+enum class Dim : uint8_t { Role, Level, Gender, BirthYear };
+enum class Agg : uint8_t { Count, Sum, Avg, Min, Max };
+
+inline const char* dimName(Dim d) {
+    static const char* const names[] = {"role", "level", "gender", "year"};
+    return names[static_cast<int>(d)];
+}
+
+inline const char* aggName(Agg a) {
+    static const char* const names[] = {"count", "sum", "avg", "min", "max"};
+    return names[static_cast<int>(a)];
+}
+
+inline bool parseDim(const std::string& s, Dim& d) {
+    if (s == "role" || s == "岗位") d = Dim::Role;
+    else if (s == "level" || s == "级别") d = Dim::Level;
+    else if (s == "gender" || s == "性别") d = Dim::Gender;
+    else if (s == "year" || s == "出生年份") d = Dim::BirthYear;
+    else return false;
+    return true;
+}
+
+inline bool parseAgg(const std::string& s, Agg& a) {
+    if (s == "count") a = Agg::Count;
+    else if (s == "sum") a = Agg::Sum;
+    else if (s == "avg") a = Agg::Avg;
+    else if (s == "min") a = Agg::Min;
+    else if (s == "max") a = Agg::Max;
+    else return false;
+    return true;
+}
+
+// 解析逗号分隔的维度/聚合列表，如 "role,level"；空串得到空列表
+inline bool parseDimList(const std::string& list, std::vector<Dim>& out) {
+    out.clear();
+    std::stringstream ss(list);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        item.erase(0, item.find_first_not_of(' '));
+        item.erase(item.find_last_not_of(' ') + 1);
+        if (item.empty()) continue;
+        Dim d;
+        if (!parseDim(item, d) || std::find(out.begin(), out.end(), d) != out.end()) return false;
+        out.push_back(d);
+    }
+    return true;
+}
+
+inline bool parseAggList(const std::string& list, std::vector<Agg>& out) {
+    out.clear();
+    std::stringstream ss(list);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        item.erase(0, item.find_first_not_of(' '));
+        item.erase(item.find_last_not_of(' ') + 1);
+        if (item.empty()) continue;
+        Agg a;
+        if (!parseAgg(item, a)) return false;
+        out.push_back(a);
+    }
+    return true;
+}
+
+// 维度取值的显示文本
+inline std::string dimLabel(Dim d, int value) {
+    switch (d) {
+        case Dim::Role: {
+            return value >= 0 && value < static_cast<int>(roles::kCount)
+                ? std::string(roles::name(static_cast<uint8_t>(value))) : "未知";
+        }
+        case Dim::Gender: {
+            static const char* const genders[] = {"男", "女", "其他"};
+            return value >= 0 && value < 3 ? genders[value] : "其他";
+        }
+        case Dim::BirthYear:
+            return value == 0 ? "未知" : std::to_string(value);
+        case Dim::Level:
+            break;
+    }
+    return std::to_string(value);
+}
+
+// 单个分组的聚合值
+struct Cell {
+    uint64_t count = 0;
+    double sum = 0.0;
+    double min = std::numeric_limits<double>::infinity();
+    double max = -std::numeric_limits<double>::infinity();
+
+    void add(double v) {
+        ++count;
+        sum += v;
+        min = v < min ? v : min;
+        max = v > max ? v : max;
+    }
+
+    void merge(const Cell& o) {
+        count += o.count;
+        sum += o.sum;
+        min = std::min(min, o.min);
+        max = std::max(max, o.max);
+    }
+
+    double value(Agg a) const {
+        switch (a) {
+            case Agg::Count: return static_cast<double>(count);
+            case Agg::Sum: return sum;
+            case Agg::Avg: return count ? sum / static_cast<double>(count) : 0.0;
+            case Agg::Min: return count ? min : 0.0;
+            case Agg::Max: return count ? max : 0.0;
+        }
+        return 0.0;
+    }
+};
+
+// 分组键：各维度在 64 位整数中的位置
+//   [63..56] 岗位  [55..48] 性别  [47..32] 出生年份  [31..0] 级别
+struct GroupKey {
+    static uint64_t pack(uint8_t role, uint8_t gender, int32_t birthday, int32_t level) {
+        return (static_cast<uint64_t>(role) << 56) | (static_cast<uint64_t>(gender) << 48) |
+               (static_cast<uint64_t>(static_cast<uint16_t>(birthday / 10000)) << 32) |
+               static_cast<uint32_t>(level);
+    }
+
+    static uint64_t mask(Dim d) {
+        switch (d) {
+            case Dim::Role: return 0xFF00000000000000ULL;
+            case Dim::Gender: return 0x00FF000000000000ULL;
+            case Dim::BirthYear: return 0x0000FFFF00000000ULL;
+            case Dim::Level: return 0x00000000FFFFFFFFULL;
+        }
+        return 0;
+    }
+
+    static int value(uint64_t key, Dim d) {
+        switch (d) {
+            case Dim::Role: return static_cast<int>(key >> 56);
+            case Dim::Gender: return static_cast<int>((key >> 48) & 0xFF);
+            case Dim::BirthYear: return static_cast<int>((key >> 32) & 0xFFFF);
+            case Dim::Level: return static_cast<int32_t>(static_cast<uint32_t>(key));
+        }
+        return 0;
+    }
+};
+
+// 开放寻址聚合表（线性探测，容量为 2 的幂，负载超过一半时扩容）
+class AggregationTable {
+public:
+    struct Slot {
+        uint64_t key;
+        Cell cell;
+    };
+
+    static constexpr uint64_t kEmpty = ~0ULL;  // 打包键不可能为全 1（出生年份不超过 9999）
+
+    explicit AggregationTable(size_t capacity = 64) { reset(capacity); }
+
+    Cell& at(uint64_t key) {
+        size_t i = hash(key) & mask_;
+        while (true) {
+            Slot& s = slots_[i];
+            if (s.key == key) return s.cell;
+            if (s.key == kEmpty) {
+                if ((size_ + 1) * 2 > slots_.size()) {
+                    grow();
+                    return at(key);
+                }
+                s.key = key;
+                ++size_;
+                return s.cell;
+            }
+            i = (i + 1) & mask_;
+        }
+    }
+
+    void mergeFrom(const AggregationTable& other) {
+        for (const Slot& s : other.slots_) {
+            if (s.key != kEmpty) at(s.key).merge(s.cell);
+        }
+    }
+
+    size_t size() const { return size_; }
+
+    template <typename Fn>
+    void forEach(Fn fn) const {
+        for (const Slot& s : slots_) {
+            if (s.key != kEmpty) fn(s.key, s.cell);
+        }
+    }
+
+private:
+    std::vector<Slot> slots_;
+    size_t size_ = 0;
+    size_t mask_ = 0;
+
+    static size_t hash(uint64_t key) {
+        key ^= key >> 29;
+        key *= 0x9E3779B97F4A7C15ULL;
+        return static_cast<size_t>(key >> 32);
+    }
+
+    void reset(size_t capacity) {
+        size_t n = 16;
+        while (n < capacity) n <<= 1;
+        slots_.assign(n, Slot{kEmpty, Cell()});
+        mask_ = n - 1;
+        size_ = 0;
+    }
+
+    void grow() {
+        std::vector<Slot> old;
+        old.swap(slots_);
+        reset(old.size() * 2);
+        for (const Slot& s : old) {
+            if (s.key != kEmpty) at(s.key) = s.cell;
+        }
+    }
+};
+
+struct Group {
+    uint64_t key;
+    Cell cell;
+};
+
+// 分组聚合引擎
+class GroupBy {
+public:
+    static constexpr size_t kRowsPerThread = 1 << 16;  // 行数少于此值的部分不再拆给新线程
+
+    explicit GroupBy(const std::vector<Dim>& dims) : dims_(dims) {
+        for (Dim d : dims_) keyMask_ |= GroupKey::mask(d);
+    }
+
+    const std::vector<Dim>& dims() const { return dims_; }
+
+    // 聚合快照中的全部行，或仅 selection 选中的行；结果按各维度取值排序
+    std::vector<Group> run(const ColumnSnapshot& s, const query::Selection* selection = nullptr) const {
+        size_t rows = s.rows();
+        size_t threads = std::max<size_t>(1, std::min<size_t>(std::thread::hardware_concurrency(),
+                                                              rows / kRowsPerThread));
+        std::vector<AggregationTable> partials(threads);
+
+        // 按 64 行对齐切分，使各线程读取选择位图的不同字
+        size_t per = ((rows + threads - 1) / threads + 63) / 64 * 64;
+        auto work = [&](size_t t) {
+            size_t begin = std::min(rows, t * per), end = std::min(rows, begin + per);
+            if (selection) aggregateSelected(s, *selection, begin, end, partials[t]);
+            else aggregateRange(s, begin, end, partials[t]);
+        };
+        if (threads == 1) {
+            work(0);
+        } else {
+            std::vector<std::thread> pool;
+            for (size_t t = 1; t < threads; ++t) pool.emplace_back(work, t);
+            work(0);
+            for (auto& th : pool) th.join();
+        }
+        for (size_t t = 1; t < threads; ++t) partials[0].mergeFrom(partials[t]);
+
+        std::vector<Group> groups;
+        groups.reserve(partials[0].size());
+        partials[0].forEach([&](uint64_t key, const Cell& cell) { groups.push_back({key, cell}); });
+        std::sort(groups.begin(), groups.end(), [this](const Group& a, const Group& b) {
+            for (Dim d : dims_) {
+                int va = GroupKey::value(a.key, d), vb = GroupKey::value(b.key, d);
+                if (va != vb) return va < vb;
+            }
+            return false;
+        });
+        return groups;
+    }
+
+private:
+    std::vector<Dim> dims_;
+    uint64_t keyMask_ = 0;
+
+    void aggregateRange(const ColumnSnapshot& s, size_t begin, size_t end, AggregationTable& table) const {
+        const uint8_t* role = s.role.data();
+        const uint8_t* gender = s.gender.data();
+        const int32_t* birthday = s.birthday.data();
+        const int32_t* level = s.level.data();
+        const double* salary = s.salary.data();
+        const uint64_t mask = keyMask_;
+
+        // 连续行往往落在同一分组，先与上一行的键比较，命中时省去一次哈希探测
+        uint64_t lastKey = AggregationTable::kEmpty;
+        Cell* last = nullptr;
+        for (size_t i = begin; i < end; ++i) {
+            uint64_t key = GroupKey::pack(role[i], gender[i], birthday[i], level[i]) & mask;
+            if (key != lastKey) {
+                last = &table.at(key);
+                lastKey = key;
+            }
+            last->add(salary[i]);
+        }
+    }
+
+    void aggregateSelected(const ColumnSnapshot& s, const query::Selection& sel, size_t begin, size_t end,
+                           AggregationTable& table) const {
+        const uint64_t* words = sel.data();
+        for (size_t w = begin / 64; w * 64 < end; ++w) {
+            uint64_t bits = words[w];
+            while (bits) {
+                size_t i = w * 64 + static_cast<size_t>(bitops::countTrailingZeros64(bits));
+                bits &= bits - 1;
+                uint64_t key = GroupKey::pack(s.role[i], s.gender[i], s.birthday[i], s.level[i]) & keyMask_;
+                table.at(key).add(s.salary[i]);
+            }
+        }
+    }
+};
+
+// 透视表：rowDims 作为行，可选的 columnDim 取值作为列，每个单元格输出 aggs 中的各项
+class PivotTable {
+public:
+    PivotTable(const std::vector<Dim>& rowDims, bool hasColumn, Dim columnDim, const std::vector<Agg>& aggs)
+        : rowDims_(rowDims), hasColumn_(hasColumn), columnDim_(columnDim), aggs_(aggs) {}
+
+    void build(const ColumnSnapshot& s, const query::Selection* selection = nullptr) {
+        std::vector<Dim> dims = rowDims_;
+        if (hasColumn_) dims.push_back(columnDim_);
+        std::vector<Group> groups = GroupBy(dims).run(s, selection);
+
+        columns_.clear();
+        rows_.clear();
+        total_ = Cell();
+        if (hasColumn_) {
+            for (const Group& g : groups) columns_.push_back(GroupKey::value(g.key, columnDim_));
+            std::sort(columns_.begin(), columns_.end());
+            columns_.erase(std::unique(columns_.begin(), columns_.end()), columns_.end());
+        }
+
+        // groups 已按行维度排序，同一行的分组相邻
+        for (const Group& g : groups) {
+            std::vector<int> key;
+            for (Dim d : rowDims_) key.push_back(GroupKey::value(g.key, d));
+            if (rows_.empty() || rows_.back().key != key) {
+                rows_.push_back({key, std::vector<Cell>(hasColumn_ ? columns_.size() : 1), Cell()});
+            }
+            size_t col = 0;
+            if (hasColumn_) {
+                int v = GroupKey::value(g.key, columnDim_);
+                col = static_cast<size_t>(std::lower_bound(columns_.begin(), columns_.end(), v) - columns_.begin());
+            }
+            rows_.back().cells[col].merge(g.cell);
+            rows_.back().total.merge(g.cell);
+            total_.merge(g.cell);
+        }
+    }
+
+    size_t rowCount() const { return rows_.size(); }
+
+    void printConsole(std::ostream& os) const {
+        std::vector<std::vector<std::string>> grid = toGrid();
+        std::vector<size_t> widths(grid[0].size(), 0);
+        for (const auto& line : grid) {
+            for (size_t c = 0; c < line.size(); ++c) widths[c] = std::max(widths[c], displayWidth(line[c]));
+        }
+        for (size_t r = 0; r < grid.size(); ++r) {
+            for (size_t c = 0; c < grid[r].size(); ++c) {
+                os << grid[r][c] << std::string(widths[c] - displayWidth(grid[r][c]) + 2, ' ');
+            }
+            os << "\n";
+            if (r == 0) {
+                size_t line = 0;
+                for (size_t w : widths) line += w + 2;
+                os << std::string(line, '-') << "\n";
+            }
+        }
+        os.flush();
+    }
+
+    void writeCSV(std::ostream& os) const {
+        for (const auto& line : toGrid()) {
+            for (size_t c = 0; c < line.size(); ++c) {
+                if (c) os << ',';
+                os << line[c];
+            }
+            os << "\n";
+        }
+    }
+
+    std::string toJSON() const {
+        std::ostringstream oss;
+        oss << std::fixed << std::setprecision(2);
+        oss << "{\"rows\":[";
+        for (size_t r = 0; r < rows_.size(); ++r) {
+            const Row& row = rows_[r];
+            if (r) oss << ',';
+            oss << '{';
+            for (size_t i = 0; i < rowDims_.size(); ++i) {
+                oss << json::quote(dimName(rowDims_[i])) << ':' << json::quote(dimLabel(rowDims_[i], row.key[i])) << ',';
+            }
+            if (hasColumn_) {
+                oss << "\"columns\":{";
+                bool first = true;
+                for (size_t c = 0; c < columns_.size(); ++c) {
+                    if (row.cells[c].count == 0) continue;
+                    if (!first) oss << ',';
+                    first = false;
+                    oss << json::quote(dimLabel(columnDim_, columns_[c])) << ":{";
+                    writeCellFields(oss, row.cells[c]);
+                    oss << '}';
+                }
+                oss << "},\"total\":{";
+                writeCellFields(oss, row.total);
+                oss << '}';
+            } else {
+                writeCellFields(oss, row.total);
+            }
+            oss << '}';
+        }
+        oss << "],\"total\":{";
+        writeCellFields(oss, total_);
+        oss << "}}";
+        return oss.str();
+    }
+
+private:
+    struct Row {
+        std::vector<int> key;
+        std::vector<Cell> cells;
+        Cell total;
+    };
+
+    std::vector<Dim> rowDims_;
+    bool hasColumn_;
+    Dim columnDim_;
+    std::vector<Agg> aggs_;
+    std::vector<int> columns_;
+    std::vector<Row> rows_;
+    Cell total_;
+
+    static std::string format(const Cell& cell, Agg a) {
+        if (cell.count == 0) return "-";
+        if (a == Agg::Count) return std::to_string(cell.count);
+        std::ostringstream oss;
+        oss << std::fixed << std::setprecision(2) << cell.value(a);
+        return oss.str();
+    }
+
+    // "count":..,"sum":..（不含花括号）
+    void writeCellFields(std::ostream& os, const Cell& cell) const {
+        for (size_t i = 0; i < aggs_.size(); ++i) {
+            if (i) os << ',';
+            os << '"' << aggName(aggs_[i]) << "\":";
+            if (aggs_[i] == Agg::Count) os << cell.count;
+            else os << cell.value(aggs_[i]);
+        }
+    }
+
+    // 表头 + 各行 + 合计行，控制台与 CSV 共用
+    std::vector<std::vector<std::string>> toGrid() const {
+        std::vector<std::vector<std::string>> grid;
+        std::vector<std::string> header;
+        for (Dim d : rowDims_) header.push_back(dimName(d));
+        if (hasColumn_) {
+            for (int c : columns_) {
+                for (Agg a : aggs_) header.push_back(dimLabel(columnDim_, c) + "/" + aggName(a));
+            }
+        }
+        for (Agg a : aggs_) header.push_back(hasColumn_ ? std::string("total/") + aggName(a) : aggName(a));
+        grid.push_back(header);
+
+        for (const Row& row : rows_) {
+            std::vector<std::string> line;
+            for (size_t i = 0; i < rowDims_.size(); ++i) line.push_back(dimLabel(rowDims_[i], row.key[i]));
+            appendCells(line, row.cells, row.total);
+            grid.push_back(line);
+        }
+
+        if (rowDims_.empty()) return grid;  // 只有一行，即合计
+
+        std::vector<std::string> totalLine;
+        for (size_t i = 0; i < rowDims_.size(); ++i) totalLine.push_back(i == 0 ? "合计" : "");
+        std::vector<Cell> columnTotals(hasColumn_ ? columns_.size() : 1);
+        for (const Row& row : rows_) {
+            for (size_t c = 0; c < row.cells.size(); ++c) columnTotals[c].merge(row.cells[c]);
+        }
+        appendCells(totalLine, columnTotals, total_);
+        grid.push_back(totalLine);
+        return grid;
+    }
+
+    void appendCells(std::vector<std::string>& line, const std::vector<Cell>& cells, const Cell& total) const {
+        if (hasColumn_) {
+            for (const Cell& cell : cells) {
+                for (Agg a : aggs_) line.push_back(format(cell, a));
+            }
+        }
+        for (Agg a : aggs_) line.push_back(format(total, a));
+    }
+
+    // 控制台显示宽度：中日韩字符按 2 列计
+    static size_t displayWidth(const std::string& s) {
+        size_t width = 0;
+        for (size_t i = 0; i < s.size();) {
+            unsigned char c = static_cast<unsigned char>(s[i]);
+            size_t len = c < 0x80 ? 1 : c < 0xE0 ? 2 : c < 0xF0 ? 3 : 4;
+            width += len >= 3 ? 2 : 1;
+            i += len;
+        }
+        return width;
+    }
+};
+
+} // namespace report
+
+#endif // GROUPBY_H
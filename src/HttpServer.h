@@ -0,0 +1,823 @@
+#ifndef HTTPSERVER_H
+#define HTTPSERVER_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <cstring>
+#include <cstdlib>
+#include <cctype>
+
+#include "EmployeeManager.h"
+#include "JsonUtil.h"
+
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+/**
+ * 嵌入式 HTTP/1.1 查询服务 (HttpServer)
+ * - 只监听 127.0.0.1，供本机其他服务调用，替代驱动交互菜单
+ * - 每个工作线程拥有独立的 epoll 实例和 SO_REUSEPORT 监听套接字，
+ *   由内核在线程间分配连接，连接不跨线程转交
+ * - 支持 keep-alive 与请求流水线：一次读入的多个完整请求依次处理，响应按序写回
+ * - 所有请求共享同一个 EmployeeManager：查询持读锁，修改持写锁并立即保存
+ *
+ * 路由：
+ *   GET    /employees/{id}                     按编号查询
+ *   GET    /employees?name=...                 按姓名查询
+ *   GET    /statistics                         工资统计
+ *   GET    /employees/{id}/rank                全员及岗位内的月薪名次与百分位
+ *   GET    /employees/{id}/reports?k=10        汇报链、直接下属、全部下属人数与月薪合计、下属月薪前 k 名
+ *   GET    /ranking?k=10&offset=0&role=...     月薪排名分页（从第 offset+1 名起取 k 名，role 可选）
+ *   GET    /salary-range?min=&max=&role=...    月薪在 [min, max] 内的人数（role 可选）
+ *   GET    /distribution                       月薪分布（全员/岗位/级别的 P50/P90/P99 与直方图）
+ *   GET    /birthdays?date=YYYY-MM-DD&days=7   生日提醒
+ *   GET    /metrics                            运行指标（JSON）
+ *   GET    /query?q=...&output=count           条件查询（output: count|list|statistics|ranking，ranking 可带 k）
+ *   GET    /pivot?rows=role,level&columns=gender&aggs=count,sum&q=...   分组透视报表（JSON）
+ *   POST   /employees                          新增（JSON 请求体）
+ *   PUT    /employees/{id}                     修改（未给出的字段保留原值）
+ *   DELETE /employees/{id}                     删除
+ */
+
+struct HttpRequest {
+    std::string method;
+    std::string path;
+    std::map<std::string, std::string> query;
+    std::string body;
+    bool keepAlive = true;
+};
+
+struct HttpResponse {
+    int status = 200;
+    std::string body;
+};
+
+class HttpServer {
+private:
+    static constexpr size_t kMaxRequestBytes = 1 << 20;  // 单个请求（头+体）上限
+
+    EmployeeManager& manager_;
+    std::shared_mutex mutex_;
+    int port_;
+    int workers_;
+    std::atomic<bool> running_;
+
+public:
+    HttpServer(EmployeeManager& manager, int port, int workers)
+        : manager_(manager), port_(port), workers_(workers > 0 ? workers : 1), running_(false) {}
+
+    // 启动服务并阻塞，直到 stop() 被调用；启动失败返回 false
+    bool run() {
+#ifdef __linux__
+        running_ = true;
+        std::vector<int> listeners;
+        for (int i = 0; i < workers_; ++i) {
+            int fd = openListener();
+            if (fd < 0) {
+                std::cout << "无法监听端口 " << port_ << ": " << std::strerror(errno) << std::endl;
+                for (int l : listeners) ::close(l);
+                running_ = false;
+                return false;
+            }
+            listeners.push_back(fd);
+        }
+
+        std::cout << "服务已启动: http://127.0.0.1:" << port_
+                  << " (工作线程 " << workers_ << " 个)" << std::endl;
+
+        std::vector<std::thread> threads;
+        for (int fd : listeners) {
+            threads.emplace_back([this, fd] { workerLoop(fd); });
+        }
+        for (auto& t : threads) t.join();
+        std::cout << "服务已停止。" << std::endl;
+        return true;
+#else
+        std::cout << "服务模式仅支持 Linux (epoll)。" << std::endl;
+        return false;
+#endif
+    }
+
+    void stop() { running_ = false; }
+
+    // ========== 路由与处理（与平台无关） ==========
+
+    HttpResponse handle(const HttpRequest& req) {
+        std::vector<std::string> parts = splitPath(req.path);
+
+        if (parts.size() >= 1 && parts[0] == "employees") {
+            if (parts.size() == 1) {
+                if (req.method == "GET") return findByName(req);
+                if (req.method == "POST") return createEmployee(req);
+                return error(405, "method not allowed");
+            }
+            if (parts.size() == 2) {
+                int id = 0;
+                if (!parseInt(parts[1], id)) return error(400, "invalid id");
+                if (req.method == "GET") return getEmployee(id);
+                if (req.method == "PUT") return updateEmployee(id, req);
+                if (req.method == "DELETE") return deleteEmployee(id);
+                return error(405, "method not allowed");
+            }
+            if (parts.size() == 3 && parts[2] == "rank" && req.method == "GET") {
+                int id = 0;
+                if (!parseInt(parts[1], id)) return error(400, "invalid id");
+                return employeeRank(id);
+            }
+            if (parts.size() == 3 && parts[2] == "reports" && req.method == "GET") {
+                int id = 0;
+                if (!parseInt(parts[1], id)) return error(400, "invalid id");
+                return employeeReports(id, req);
+            }
+        } else if (parts.size() == 1 && req.method == "GET") {
+            if (parts[0] == "statistics") return statistics();
+            if (parts[0] == "distribution") return distribution();
+            if (parts[0] == "ranking") return ranking(req);
+            if (parts[0] == "salary-range") return salaryRange(req);
+            if (parts[0] == "birthdays") return birthdays(req);
+            if (parts[0] == "query") return queryEmployees(req);
+            if (parts[0] == "pivot") return pivot(req);
+            if (parts[0] == "metrics") return {200, metrics::Registry::instance().toJSON()};
+        }
+        return error(404, "not found");
+    }
+
+private:
+    // ---------- 只读查询 ----------
+
+    HttpResponse getEmployee(int id) {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        const Employee* emp = manager_.findById(id);
+        if (!emp) return error(404, "employee not found");
+        return {200, emp->toJSON()};
+    }
+
+    HttpResponse findByName(const HttpRequest& req) {
+        auto it = req.query.find("name");
+        if (it == req.query.end()) return error(400, "missing name");
+
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        std::string body = "[";
+        bool first = true;
+        for (const Employee* emp : manager_.findByName(it->second)) {
+            if (!first) body += ',';
+            body += emp->toJSON();
+            first = false;
+        }
+        body += ']';
+        return {200, body};
+    }
+
+    HttpResponse statistics() {
+        EmployeeManager::SalaryStatistics st;
+        {
+            std::shared_lock<std::shared_mutex> lock(mutex_);
+            st = manager_.computeStatistics();
+        }
+        return {200, statisticsJson(st)};
+    }
+
+    HttpResponse distribution() {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        return {200, manager_.salaryDistribution().toJSON()};
+    }
+
+    static std::string statisticsJson(const EmployeeManager::SalaryStatistics& st) {
+        std::ostringstream oss;
+        oss << std::fixed << std::setprecision(2);
+        oss << "{\"employees\":" << st.employees << ",\"total\":" << st.total << ",\"roles\":{";
+        for (uint8_t r = 0; r < roles::kCount; ++r) {
+            const EmployeeManager::RoleTotals& t = st.byRole[r];
+            if (r) oss << ',';
+            oss << '"' << roles::name(r) << "\":{\"count\":" << t.count
+                << ",\"total\":" << t.total
+                << ",\"share\":" << (st.total > 0 ? t.total / st.total * 100 : 0) << '}';
+        }
+        oss << "}}";
+        return oss.str();
+    }
+
+    HttpResponse ranking(const HttpRequest& req) {
+        int k = 10;
+        if (!parseK(req, k)) return error(400, "invalid k");
+        int offset = 0;
+        auto offsetIt = req.query.find("offset");
+        if (offsetIt != req.query.end() && (!parseInt(offsetIt->second, offset) || offset < 0)) {
+            return error(400, "invalid offset");
+        }
+        int role = -1;
+        if (!parseRole(req, role)) return error(400, "invalid role");
+
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        size_t first = static_cast<size_t>(offset) + 1;
+        return {200, rankingJson(manager_.rankingPage(first, static_cast<size_t>(k), role), first)};
+    }
+
+    HttpResponse employeeRank(int id) {
+        EmployeeManager::RankInfo info;
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        if (!manager_.rankOf(id, info)) return error(404, "employee not found");
+        const Employee* emp = manager_.findById(id);
+
+        std::ostringstream oss;
+        oss << std::fixed << std::setprecision(2);
+        oss << "{\"id\":" << id
+            << ",\"role\":" << json::quote(emp->getRoleName())
+            << ",\"salary\":" << emp->calculateSalary()
+            << ",\"rank\":" << info.rank << ",\"total\":" << info.total
+            << ",\"percentile\":" << info.percentile
+            << ",\"roleRank\":" << info.roleRank << ",\"roleTotal\":" << info.roleTotal
+            << ",\"rolePercentile\":" << info.rolePercentile << '}';
+        return {200, oss.str()};
+    }
+
+    HttpResponse employeeReports(int id, const HttpRequest& req) {
+        int k = 10;
+        if (!parseK(req, k)) return error(400, "invalid k");
+        EmployeeManager::ReportingInfo info;
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        if (!manager_.reportingOf(id, static_cast<size_t>(k), info)) return error(404, "employee not found");
+
+        auto ids = [](const std::vector<const Employee*>& list) {
+            std::string out = "[";
+            for (size_t i = 0; i < list.size(); ++i) {
+                if (i) out += ',';
+                out += std::to_string(list[i]->getId());
+            }
+            return out + ']';
+        };
+        std::ostringstream oss;
+        oss << std::fixed << std::setprecision(2);
+        oss << "{\"id\":" << id
+            << ",\"managerId\":" << (info.chain.empty() ? 0 : info.chain[0]->getId())
+            << ",\"declaredManagerId\":" << info.declaredManager
+            << ",\"chain\":" << ids(info.chain)
+            << ",\"chainTruncated\":" << (info.chainTruncated ? "true" : "false")
+            << ",\"directReports\":" << ids(info.direct)
+            << ",\"directCount\":" << info.directCount
+            << ",\"headcount\":" << info.headcount
+            << ",\"payroll\":" << info.payroll
+            << ",\"top\":" << rankingJson(info.top) << '}';
+        return {200, oss.str()};
+    }
+
+    HttpResponse salaryRange(const HttpRequest& req) {
+        double low = 0.0, high = 0.0;
+        auto minIt = req.query.find("min");
+        auto maxIt = req.query.find("max");
+        if (minIt == req.query.end() || !parseDouble(minIt->second, low) ||
+            maxIt == req.query.end() || !parseDouble(maxIt->second, high)) {
+            return error(400, "invalid min/max");
+        }
+        int role = -1;
+        if (!parseRole(req, role)) return error(400, "invalid role");
+
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        return {200, "{\"count\":" + std::to_string(manager_.countSalaryBetween(low, high, role)) + "}"};
+    }
+
+    // role 参数：英文岗位名，缺省为全员（-1）
+    static bool parseRole(const HttpRequest& req, int& role) {
+        auto it = req.query.find("role");
+        if (it == req.query.end()) return true;
+        uint8_t code = ColumnSnapshot::roleCode(it->second);
+        if (code == ColumnSnapshot::kUnknownRole) return false;
+        role = code;
+        return true;
+    }
+
+    static bool parseK(const HttpRequest& req, int& k) {
+        auto it = req.query.find("k");
+        return it == req.query.end() || (parseInt(it->second, k) && k >= 0);
+    }
+
+    static std::string rankingJson(const std::vector<const Employee*>& ranked, size_t firstRank = 1) {
+        std::ostringstream oss;
+        oss << std::fixed << std::setprecision(2) << '[';
+        size_t rank = firstRank;
+        for (const Employee* emp : ranked) {
+            if (rank > firstRank) oss << ',';
+            oss << "{\"rank\":" << rank++
+                << ",\"id\":" << emp->getId()
+                << ",\"name\":" << json::quote(emp->getName())
+                << ",\"role\":" << json::quote(emp->getRoleName())
+                << ",\"salary\":" << emp->calculateSalary() << '}';
+        }
+        oss << ']';
+        return oss.str();
+    }
+
+    HttpResponse birthdays(const HttpRequest& req) {
+        auto dateIt = req.query.find("date");
+        if (dateIt == req.query.end() || !Employee::isValidDate(dateIt->second)) {
+            return error(400, "invalid date");
+        }
+        int days = 7;
+        auto daysIt = req.query.find("days");
+        if (daysIt != req.query.end() && !parseInt(daysIt->second, days)) {
+            return error(400, "invalid days");
+        }
+        int month = std::stoi(dateIt->second.substr(5, 2));
+        int day = std::stoi(dateIt->second.substr(8, 2));
+
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        std::string body = "[";
+        bool first = true;
+        for (const Employee* emp : manager_.upcomingBirthdays(month, day, days)) {
+            if (!first) body += ',';
+            body += emp->toJSON();
+            first = false;
+        }
+        body += ']';
+        return {200, body};
+    }
+
+    HttpResponse queryEmployees(const HttpRequest& req) {
+        auto it = req.query.find("q");
+        if (it == req.query.end()) return error(400, "missing q");
+        query::CompiledQuery q;
+        std::string message;
+        if (!q.compile(it->second, &message)) {
+            return {400, "{\"error\":" + json::quote(message) + "}"};
+        }
+        auto outIt = req.query.find("output");
+        std::string output = outIt == req.query.end() ? "count" : outIt->second;
+        int k = 10;
+        if (!parseK(req, k)) return error(400, "invalid k");
+
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        if (output == "count") {
+            return {200, "{\"count\":" + std::to_string(manager_.countMatching(q)) + "}"};
+        }
+        if (output == "statistics") return {200, statisticsJson(manager_.computeStatistics(manager_.select(q)))};
+        if (output == "ranking") {
+            return {200, rankingJson(manager_.topBySalary(manager_.select(q), static_cast<size_t>(k)))};
+        }
+        if (output == "list") {
+            std::string body = "[";
+            bool first = true;
+            for (const Employee* emp : manager_.matchingEmployees(q)) {
+                if (!first) body += ',';
+                body += emp->toJSON();
+                first = false;
+            }
+            body += ']';
+            return {200, body};
+        }
+        return error(400, "invalid output");
+    }
+
+    HttpResponse pivot(const HttpRequest& req) {
+        auto param = [&req](const char* name, const char* fallback) {
+            auto it = req.query.find(name);
+            return it == req.query.end() ? std::string(fallback) : it->second;
+        };
+        std::vector<report::Dim> rowDims, columnDims;
+        std::vector<report::Agg> aggs;
+        if (!report::parseDimList(param("rows", ""), rowDims) ||
+            !report::parseDimList(param("columns", ""), columnDims) || columnDims.size() > 1 ||
+            (!columnDims.empty() && std::find(rowDims.begin(), rowDims.end(), columnDims[0]) != rowDims.end())) {
+            return error(400, "invalid dimensions");
+        }
+        if (!report::parseAggList(param("aggs", "count,sum,avg"), aggs) || aggs.empty()) {
+            return error(400, "invalid aggs");
+        }
+        query::CompiledQuery filter;
+        std::string q = param("q", ""), message;
+        if (!q.empty() && !filter.compile(q, &message)) {
+            return {400, "{\"error\":" + json::quote(message) + "}"};
+        }
+
+        report::PivotTable table(rowDims, !columnDims.empty(),
+                                 columnDims.empty() ? report::Dim::Role : columnDims[0], aggs);
+        {
+            std::shared_lock<std::shared_mutex> lock(mutex_);
+            manager_.buildPivot(table, q.empty() ? nullptr : &filter);
+        }
+        return {200, table.toJSON()};
+    }
+
+    // ---------- 修改 ----------
+
+    HttpResponse createEmployee(const HttpRequest& req) {
+        json::Object obj;
+        if (!json::parseObject(req.body, obj)) return error(400, "invalid json");
+        if (!obj.count("role")) return error(400, "missing role");
+
+        std::vector<std::string> cols(Employee::kManagerColumn + 1, "0");
+        cols[0] = obj.count("id") ? obj["id"] : "0";
+        cols[3] = "1";
+        cols[5] = "";
+        if (!applyJson(obj, cols)) return error(400, "invalid field");
+
+        std::unique_ptr<Employee> emp = EmployeeManager::fromColumns(cols);
+        if (!emp) return error(400, "invalid employee");
+
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        if (!manager_.canReportTo(emp->getId(), emp->getManagerId())) return error(400, "invalid managerId");
+        Employee* raw = emp.get();
+        if (!manager_.insertEmployee(std::move(emp))) return error(409, "id already exists");
+        manager_.save();
+        return {201, raw->toJSON()};
+    }
+
+    HttpResponse updateEmployee(int id, const HttpRequest& req) {
+        json::Object obj;
+        if (!json::parseObject(req.body, obj)) return error(400, "invalid json");
+
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        const Employee* current = manager_.findById(id);
+        if (!current) return error(404, "employee not found");
+
+        // 以现有数据为底，覆盖请求中给出的字段；更换岗位时岗位参数清零
+        std::vector<std::string> cols = EmployeeManager::splitCSV(current->toCSV());
+        cols.resize(Employee::kManagerColumn + 1, "0");
+        if (obj.count("role") && obj["role"] != cols[2]) {
+            cols[6] = cols[7] = cols[8] = "0";
+        }
+        obj.erase("id");
+        if (!applyJson(obj, cols)) return error(400, "invalid field");
+        cols[0] = std::to_string(id);
+
+        std::unique_ptr<Employee> emp = EmployeeManager::fromColumns(cols);
+        if (!emp) return error(400, "invalid employee");
+        if (!manager_.canReportTo(id, emp->getManagerId())) return error(400, "invalid managerId");
+
+        Employee* raw = emp.get();
+        manager_.replaceEmployee(id, std::move(emp));
+        manager_.save();
+        return {200, raw->toJSON()};
+    }
+
+    HttpResponse deleteEmployee(int id) {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        if (!manager_.eraseEmployee(id)) return error(404, "employee not found");
+        manager_.save();
+        return {200, "{\"deleted\":" + std::to_string(id) + "}"};
+    }
+
+    // 将 JSON 字段写入 CSV 列（列布局与 save() 一致），字段非法时返回 false
+    static bool applyJson(const json::Object& obj, std::vector<std::string>& cols) {
+        static const char* const kBasicKeys[] = {"id", "name", "role", "level", "gender", "birthday"};
+        for (int i = 0; i < 6; ++i) {
+            auto it = obj.find(kBasicKeys[i]);
+            if (it != obj.end()) cols[i] = it->second;
+        }
+        if (obj.count("gender") && cols[4] != "男" && cols[4] != "女") return false;
+        if (obj.count("birthday") && !cols[5].empty() && !Employee::isValidDate(cols[5])) return false;
+
+        // 各岗位特有字段对应的参数列 (param1, param2, param3)
+        uint8_t role = roles::code(cols[2]);
+        if (role == roles::kUnknown) return false;
+        const auto& keys = roles::paramKeys(role);
+        for (int i = 0; i < 3; ++i) {
+            if (!keys[i]) continue;
+            auto it = obj.find(keys[i]);
+            if (it == obj.end()) continue;
+            char* end = nullptr;
+            std::strtod(it->second.c_str(), &end);
+            if (it->second.empty() || *end != '\0') return false;
+            cols[6 + i] = it->second;
+        }
+
+        auto manager = obj.find("managerId");
+        if (manager != obj.end()) {
+            int managerId = 0;
+            if (!parseInt(manager->second, managerId) || managerId < 0) return false;
+            cols[Employee::kManagerColumn] = manager->second;
+        }
+        return true;
+    }
+
+    // ---------- 工具函数 ----------
+
+    static HttpResponse error(int status, const char* message) {
+        return {status, "{\"error\":" + json::quote(message) + "}"};
+    }
+
+    static bool parseInt(const std::string& s, int& out) {
+        if (s.empty() || s.size() > 10) return false;
+        char* end = nullptr;
+        long v = std::strtol(s.c_str(), &end, 10);
+        if (*end != '\0') return false;
+        out = static_cast<int>(v);
+        return true;
+    }
+
+    static bool parseDouble(const std::string& s, double& out) {
+        if (s.empty()) return false;
+        char* end = nullptr;
+        out = std::strtod(s.c_str(), &end);
+        return *end == '\0';
+    }
+
+    static std::vector<std::string> splitPath(const std::string& path) {
+        std::vector<std::string> parts;
+        size_t i = 0;
+        while (i < path.size()) {
+            while (i < path.size() && path[i] == '/') ++i;
+            size_t j = path.find('/', i);
+            if (j == std::string::npos) j = path.size();
+            if (j > i) parts.push_back(path.substr(i, j - i));
+            i = j;
+        }
+        return parts;
+    }
+
+    static std::string urlDecode(const std::string& s) {
+        std::string out;
+        out.reserve(s.size());
+        for (size_t i = 0; i < s.size(); ++i) {
+            if (s[i] == '+') {
+                out += ' ';
+            } else if (s[i] == '%' && i + 2 < s.size() &&
+                       std::isxdigit(static_cast<unsigned char>(s[i + 1])) &&
+                       std::isxdigit(static_cast<unsigned char>(s[i + 2]))) {
+                out += static_cast<char>(std::stoi(s.substr(i + 1, 2), nullptr, 16));
+                i += 2;
+            } else {
+                out += s[i];
+            }
+        }
+        return out;
+    }
+
+    static const char* statusText(int status) {
+        switch (status) {
+            case 200: return "OK";
+            case 201: return "Created";
+            case 400: return "Bad Request";
+            case 404: return "Not Found";
+            case 405: return "Method Not Allowed";
+            case 409: return "Conflict";
+            case 413: return "Payload Too Large";
+            case 501: return "Not Implemented";
+            default:  return "Internal Server Error";
+        }
+    }
+
+    static void appendResponse(std::string& out, const HttpResponse& resp, bool keepAlive) {
+        out += "HTTP/1.1 ";
+        out += std::to_string(resp.status);
+        out += ' ';
+        out += statusText(resp.status);
+        out += "\r\nContent-Type: application/json; charset=utf-8\r\nContent-Length: ";
+        out += std::to_string(resp.body.size());
+        out += keepAlive ? "\r\n\r\n" : "\r\nConnection: close\r\n\r\n";
+        out += resp.body;
+    }
+
+    static bool headerEquals(const char* a, size_t len, const char* name) {
+        size_t n = std::strlen(name);
+        if (len != n) return false;
+        for (size_t i = 0; i < n; ++i) {
+            if (std::tolower(static_cast<unsigned char>(a[i])) != name[i]) return false;
+        }
+        return true;
+    }
+
+    static bool containsToken(std::string value, const char* token) {
+        for (auto& c : value) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        return value.find(token) != std::string::npos;
+    }
+
+    // 从 buf[pos..] 解析一个完整请求。
+    // 返回值：>0 已消费字节数；0 数据不完整；-1 格式错误；-2 不支持的传输编码；-3 请求过大
+    static long parseRequest(const std::string& buf, size_t pos, HttpRequest& req) {
+        size_t headerEnd = buf.find("\r\n\r\n", pos);
+        if (headerEnd == std::string::npos) {
+            return buf.size() - pos > kMaxRequestBytes ? -3 : 0;
+        }
+
+        size_t lineEnd = buf.find("\r\n", pos);
+        size_t sp1 = buf.find(' ', pos);
+        size_t sp2 = (sp1 == std::string::npos) ? sp1 : buf.find(' ', sp1 + 1);
+        if (sp1 == std::string::npos || sp2 == std::string::npos || sp2 > lineEnd) return -1;
+
+        req = HttpRequest();
+        req.method.assign(buf, pos, sp1 - pos);
+        std::string target(buf, sp1 + 1, sp2 - sp1 - 1);
+        std::string version(buf, sp2 + 1, lineEnd - sp2 - 1);
+        if (version.compare(0, 5, "HTTP/") != 0) return -1;
+        bool http10 = (version == "HTTP/1.0");
+        req.keepAlive = !http10;
+
+        size_t q = target.find('?');
+        req.path = urlDecode(target.substr(0, q));
+        if (q != std::string::npos) {
+            std::string qs = target.substr(q + 1);
+            size_t i = 0;
+            while (i <= qs.size()) {
+                size_t amp = qs.find('&', i);
+                if (amp == std::string::npos) amp = qs.size();
+                size_t eq = qs.find('=', i);
+                if (eq != std::string::npos && eq < amp) {
+                    req.query[urlDecode(qs.substr(i, eq - i))] = urlDecode(qs.substr(eq + 1, amp - eq - 1));
+                } else if (amp > i) {
+                    req.query[urlDecode(qs.substr(i, amp - i))] = "";
+                }
+                i = amp + 1;
+            }
+        }
+
+        size_t contentLength = 0;
+        size_t line = lineEnd + 2;
+        while (line < headerEnd) {
+            size_t end = buf.find("\r\n", line);
+            size_t colon = buf.find(':', line);
+            if (colon != std::string::npos && colon < end) {
+                size_t vstart = colon + 1;
+                while (vstart < end && (buf[vstart] == ' ' || buf[vstart] == '\t')) ++vstart;
+                std::string value(buf, vstart, end - vstart);
+                const char* name = buf.data() + line;
+                size_t nameLen = colon - line;
+                if (headerEquals(name, nameLen, "content-length")) {
+                    char* e = nullptr;
+                    unsigned long long v = std::strtoull(value.c_str(), &e, 10);
+                    if (value.empty() || *e != '\0') return -1;
+                    if (v > kMaxRequestBytes) return -3;
+                    contentLength = static_cast<size_t>(v);
+                } else if (headerEquals(name, nameLen, "connection")) {
+                    if (containsToken(value, "close")) req.keepAlive = false;
+                    else if (containsToken(value, "keep-alive")) req.keepAlive = true;
+                } else if (headerEquals(name, nameLen, "transfer-encoding")) {
+                    return -2;
+                }
+            }
+            line = end + 2;
+        }
+
+        size_t bodyStart = headerEnd + 4;
+        if (buf.size() - bodyStart < contentLength) return 0;
+        req.body.assign(buf, bodyStart, contentLength);
+        return static_cast<long>(bodyStart + contentLength - pos);
+    }
+
+#ifdef __linux__
+    // ========== epoll 事件循环 ==========
+
+    struct Connection {
+        std::string in;
+        size_t inPos = 0;
+        std::string out;
+        size_t outPos = 0;
+        bool closing = false;   // 写完后关闭
+        bool peerClosed = false;
+    };
+
+    int openListener() {
+        int fd = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (fd < 0) return -1;
+        int one = 1;
+        ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        ::setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &one, sizeof(one));
+
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(static_cast<uint16_t>(port_));
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 ||
+            ::listen(fd, 1024) < 0) {
+            int saved = errno;
+            ::close(fd);
+            errno = saved;
+            return -1;
+        }
+        return fd;
+    }
+
+    void workerLoop(int listenFd) {
+        int ep = ::epoll_create1(EPOLL_CLOEXEC);
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.fd = listenFd;
+        ::epoll_ctl(ep, EPOLL_CTL_ADD, listenFd, &ev);
+
+        std::unordered_map<int, Connection> conns;
+        epoll_event events[256];
+        char buf[64 * 1024];
+
+        while (running_) {
+            int n = ::epoll_wait(ep, events, 256, 200);
+            for (int i = 0; i < n; ++i) {
+                int fd = events[i].data.fd;
+                if (fd == listenFd) {
+                    acceptAll(ep, listenFd, conns);
+                    continue;
+                }
+
+                auto it = conns.find(fd);
+                if (it == conns.end()) continue;
+                Connection& c = it->second;
+
+                if (events[i].events & (EPOLLERR | EPOLLHUP)) {
+                    closeConnection(ep, fd, conns);
+                    continue;
+                }
+                if (events[i].events & (EPOLLIN | EPOLLRDHUP)) {
+                    // 边沿触发：读到 EAGAIN 为止
+                    while (true) {
+                        ssize_t r = ::read(fd, buf, sizeof(buf));
+                        if (r > 0) {
+                            c.in.append(buf, static_cast<size_t>(r));
+                        } else if (r == 0) {
+                            c.peerClosed = true;
+                            break;
+                        } else {
+                            if (errno != EAGAIN && errno != EWOULDBLOCK) c.peerClosed = true;
+                            break;
+                        }
+                    }
+                    processInput(c);
+                }
+                if (!flush(fd, c) || (c.out.size() == c.outPos && (c.closing || c.peerClosed))) {
+                    closeConnection(ep, fd, conns);
+                }
+            }
+        }
+
+        for (auto& kv : conns) ::close(kv.first);
+        ::close(listenFd);
+        ::close(ep);
+    }
+
+    void acceptAll(int ep, int listenFd, std::unordered_map<int, Connection>& conns) {
+        while (true) {
+            int cfd = ::accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (cfd < 0) return;
+            int one = 1;
+            ::setsockopt(cfd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+            epoll_event ev{};
+            ev.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+            ev.data.fd = cfd;
+            ::epoll_ctl(ep, EPOLL_CTL_ADD, cfd, &ev);
+            conns.emplace(cfd, Connection());
+        }
+    }
+
+    static void closeConnection(int ep, int fd, std::unordered_map<int, Connection>& conns) {
+        ::epoll_ctl(ep, EPOLL_CTL_DEL, fd, nullptr);
+        ::close(fd);
+        conns.erase(fd);
+    }
+
+    // 处理缓冲区中所有完整请求（流水线），响应依次追加到输出缓冲
+    void processInput(Connection& c) {
+        while (!c.closing && c.inPos < c.in.size()) {
+            HttpRequest req;
+            long used = parseRequest(c.in, c.inPos, req);
+            if (used == 0) break;
+            if (used < 0) {
+                HttpResponse resp = used == -2 ? error(501, "transfer-encoding not supported")
+                                  : used == -3 ? error(413, "request too large")
+                                  : error(400, "malformed request");
+                appendResponse(c.out, resp, false);
+                c.closing = true;
+                break;
+            }
+            c.inPos += static_cast<size_t>(used);
+            appendResponse(c.out, handle(req), req.keepAlive);
+            if (!req.keepAlive) c.closing = true;
+        }
+
+        // 压缩已消费的输入
+        if (c.inPos == c.in.size()) {
+            c.in.clear();
+            c.inPos = 0;
+        } else if (c.inPos > 64 * 1024) {
+            c.in.erase(0, c.inPos);
+            c.inPos = 0;
+        }
+    }
+
+    // 尽量写出输出缓冲；连接出错返回 false
+    static bool flush(int fd, Connection& c) {
+        while (c.outPos < c.out.size()) {
+            ssize_t w = ::send(fd, c.out.data() + c.outPos, c.out.size() - c.outPos, MSG_NOSIGNAL);
+            if (w > 0) {
+                c.outPos += static_cast<size_t>(w);
+            } else {
+                return w < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+            }
+        }
+        c.out.clear();
+        c.outPos = 0;
+        return true;
+    }
+#endif
+};
+
+#endif // HTTPSERVER_H
@@ -0,0 +1,148 @@
+#ifndef JSONUTIL_H
+#define JSONUTIL_H
+
+#include <string>
+#include <map>
+#include <cstdio>
+
+/**
+ * JSON 辅助工具 (JsonUtil)
+ * - 字符串转义输出
+ * - 解析扁平 JSON 对象（仅支持字符串/数字/布尔/null 值，不支持嵌套）
+ *   服务模式的请求体只需要这一子集
+ */
+namespace json {
+
+// 追加带引号的转义字符串
+inline void appendString(std::string& out, const std::string& s) {
+    out += '"';
+    for (unsigned char c : s) {
+        switch (c) {
+            case '"':  out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (c < 0x20) {
+                    char buf[8];
+                    std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+                    out += buf;
+                } else {
+                    out += static_cast<char>(c);  // UTF-8 原样输出
+                }
+        }
+    }
+    out += '"';
+}
+
+inline std::string quote(const std::string& s) {
+    std::string out;
+    appendString(out, s);
+    return out;
+}
+
+// 扁平 JSON 对象：键 -> 原始值文本（字符串已去引号并反转义）
+using Object = std::map<std::string, std::string>;
+
+namespace detail {
+
+inline void skipSpace(const std::string& s, size_t& i) {
+    while (i < s.size() && (s[i] == ' ' || s[i] == '\t' || s[i] == '\n' || s[i] == '\r')) ++i;
+}
+
+// 将码点编码为 UTF-8
+inline void appendUtf8(std::string& out, unsigned cp) {
+    if (cp < 0x80) {
+        out += static_cast<char>(cp);
+    } else if (cp < 0x800) {
+        out += static_cast<char>(0xC0 | (cp >> 6));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else {
+        out += static_cast<char>(0xE0 | (cp >> 12));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    }
+}
+
+inline bool parseString(const std::string& s, size_t& i, std::string& out) {
+    if (i >= s.size() || s[i] != '"') return false;
+    ++i;
+    while (i < s.size()) {
+        char c = s[i++];
+        if (c == '"') return true;
+        if (c != '\\') { out += c; continue; }
+        if (i >= s.size()) return false;
+        char e = s[i++];
+        switch (e) {
+            case '"': out += '"'; break;
+            case '\\': out += '\\'; break;
+            case '/': out += '/'; break;
+            case 'n': out += '\n'; break;
+            case 'r': out += '\r'; break;
+            case 't': out += '\t'; break;
+            case 'b': out += '\b'; break;
+            case 'f': out += '\f'; break;
+            case 'u': {
+                if (i + 4 > s.size()) return false;
+                unsigned cp = 0;
+                for (int k = 0; k < 4; ++k) {
+                    char h = s[i++];
+                    cp <<= 4;
+                    if (h >= '0' && h <= '9') cp |= h - '0';
+                    else if (h >= 'a' && h <= 'f') cp |= h - 'a' + 10;
+                    else if (h >= 'A' && h <= 'F') cp |= h - 'A' + 10;
+                    else return false;
+                }
+                appendUtf8(out, cp);
+                break;
+            }
+            default: return false;
+        }
+    }
+    return false;
+}
+
+} // namespace detail
+
+// 解析扁平对象，格式错误返回 false
+inline bool parseObject(const std::string& s, Object& obj) {
+    size_t i = 0;
+    detail::skipSpace(s, i);
+    if (i >= s.size() || s[i] != '{') return false;
+    ++i;
+    detail::skipSpace(s, i);
+    if (i < s.size() && s[i] == '}') return true;
+
+    while (i < s.size()) {
+        std::string key;
+        detail::skipSpace(s, i);
+        if (!detail::parseString(s, i, key)) return false;
+        detail::skipSpace(s, i);
+        if (i >= s.size() || s[i] != ':') return false;
+        ++i;
+        detail::skipSpace(s, i);
+
+        std::string value;
+        if (i < s.size() && s[i] == '"') {
+            if (!detail::parseString(s, i, value)) return false;
+        } else {
+            size_t start = i;
+            while (i < s.size() && s[i] != ',' && s[i] != '}' &&
+                   s[i] != ' ' && s[i] != '\n' && s[i] != '\r' && s[i] != '\t') ++i;
+            value = s.substr(start, i - start);
+            if (value.empty() || value[0] == '{' || value[0] == '[') return false;
+        }
+        obj[key] = value;
+
+        detail::skipSpace(s, i);
+        if (i < s.size() && s[i] == ',') { ++i; continue; }
+        if (i < s.size() && s[i] == '}') return true;
+        return false;
+    }
+    return false;
+}
+
+} // namespace json
+
+#endif // JSONUTIL_H
@@ -0,0 +1,461 @@
+#ifndef LZ4FRAME_H
+#define LZ4FRAME_H
+
+#include <string>
+#include <vector>
+#include <istream>
+#include <ostream>
+#include <cstdint>
+#include <cstring>
+
+/**
+ * LZ4 帧格式编解码 (Lz4Frame)
+ * - 按 LZ4 Frame 规范自行实现，无需外部库；生成的文件可用官方 lz4 命令行解压，
+ *   官方 lz4 压缩的文件（块独立模式，即默认模式）也可直接读取
+ * - 块压缩采用贪心匹配（单个 4 字节散列表），对重复度高的 CSV 压缩率约 3~5 倍
+ * - 写出时附带内容校验 (XXH32)，读取时若帧带校验则逐块累积并在结尾核对
+ */
+namespace lz4 {
+
+// ========== XXH32（帧头校验与内容校验） ==========
+
+class Xxh32 {
+public:
+    explicit Xxh32(uint32_t seed = 0) { reset(seed); }
+
+    void reset(uint32_t seed = 0) {
+        v_[0] = seed + kPrime1 + kPrime2;
+        v_[1] = seed + kPrime2;
+        v_[2] = seed;
+        v_[3] = seed - kPrime1;
+        seed_ = seed;
+        total_ = 0;
+        bufLen_ = 0;
+    }
+
+    void update(const void* data, size_t len) {
+        const uint8_t* p = static_cast<const uint8_t*>(data);
+        total_ += len;
+        if (bufLen_ + len < 16) {
+            std::memcpy(buf_ + bufLen_, p, len);
+            bufLen_ += len;
+            return;
+        }
+        if (bufLen_ > 0) {
+            size_t fill = 16 - bufLen_;
+            std::memcpy(buf_ + bufLen_, p, fill);
+            stripe(buf_);
+            p += fill;
+            len -= fill;
+            bufLen_ = 0;
+        }
+        while (len >= 16) {
+            stripe(p);
+            p += 16;
+            len -= 16;
+        }
+        std::memcpy(buf_, p, len);
+        bufLen_ = len;
+    }
+
+    uint32_t digest() const {
+        uint32_t h;
+        if (total_ >= 16) {
+            h = rotl(v_[0], 1) + rotl(v_[1], 7) + rotl(v_[2], 12) + rotl(v_[3], 18);
+        } else {
+            h = seed_ + kPrime5;
+        }
+        h += static_cast<uint32_t>(total_);
+
+        const uint8_t* p = buf_;
+        size_t len = bufLen_;
+        while (len >= 4) {
+            h += read32(p) * kPrime3;
+            h = rotl(h, 17) * kPrime4;
+            p += 4;
+            len -= 4;
+        }
+        while (len > 0) {
+            h += (*p) * kPrime5;
+            h = rotl(h, 11) * kPrime1;
+            ++p;
+            --len;
+        }
+        h ^= h >> 15;
+        h *= kPrime2;
+        h ^= h >> 13;
+        h *= kPrime3;
+        h ^= h >> 16;
+        return h;
+    }
+
+    static uint32_t hash(const void* data, size_t len, uint32_t seed = 0) {
+        Xxh32 x(seed);
+        x.update(data, len);
+        return x.digest();
+    }
+
+private:
+    static constexpr uint32_t kPrime1 = 2654435761u;
+    static constexpr uint32_t kPrime2 = 2246822519u;
+    static constexpr uint32_t kPrime3 = 3266489917u;
+    static constexpr uint32_t kPrime4 = 668265263u;
+    static constexpr uint32_t kPrime5 = 374761393u;
+
+    static uint32_t rotl(uint32_t x, int r) { return (x << r) | (x >> (32 - r)); }
+    static uint32_t read32(const uint8_t* p) {
+        return uint32_t(p[0]) | (uint32_t(p[1]) << 8) | (uint32_t(p[2]) << 16) | (uint32_t(p[3]) << 24);
+    }
+    static uint32_t round(uint32_t acc, uint32_t input) {
+        acc += input * kPrime2;
+        return rotl(acc, 13) * kPrime1;
+    }
+    void stripe(const uint8_t* p) {
+        v_[0] = round(v_[0], read32(p));
+        v_[1] = round(v_[1], read32(p + 4));
+        v_[2] = round(v_[2], read32(p + 8));
+        v_[3] = round(v_[3], read32(p + 12));
+    }
+
+    uint32_t v_[4];
+    uint32_t seed_;
+    uint64_t total_;
+    uint8_t buf_[16];
+    size_t bufLen_;
+};
+
+// ========== 块压缩 / 解压 ==========
+
+namespace detail {
+
+constexpr size_t kMinMatch = 4;
+constexpr size_t kLastLiterals = 5;   // 块末尾至少 5 字节必须是字面量
+constexpr size_t kMatchFind = 12;     // 最后一个匹配须在块末 12 字节之前开始
+constexpr int kHashLog = 14;
+
+inline uint32_t read32(const uint8_t* p) {
+    uint32_t v;
+    std::memcpy(&v, p, 4);
+    return v;
+}
+
+inline uint32_t hashOf(uint32_t seq) {
+    return (seq * 2654435761u) >> (32 - kHashLog);
+}
+
+inline void writeLength(std::string& out, size_t len) {
+    while (len >= 255) {
+        out += static_cast<char>(255);
+        len -= 255;
+    }
+    out += static_cast<char>(len);
+}
+
+inline void emitSequence(std::string& out, const uint8_t* literals, size_t litLen,
+                         size_t offset, size_t matchLen, bool last) {
+    size_t tokenPos = out.size();
+    out += '\0';
+    uint8_t token = 0;
+    if (litLen >= 15) {
+        token = 15 << 4;
+        writeLength(out, litLen - 15);
+    } else {
+        token = static_cast<uint8_t>(litLen << 4);
+    }
+    out.append(reinterpret_cast<const char*>(literals), litLen);
+    if (!last) {
+        out += static_cast<char>(offset & 0xFF);
+        out += static_cast<char>(offset >> 8);
+        size_t ml = matchLen - kMinMatch;
+        if (ml >= 15) {
+            token |= 15;
+            writeLength(out, ml - 15);
+        } else {
+            token |= static_cast<uint8_t>(ml);
+        }
+    }
+    out[tokenPos] = static_cast<char>(token);
+}
+
+} // namespace detail
+
+// 压缩一个块，结果追加到 out
+inline void compressBlock(const uint8_t* src, size_t n, std::string& out) {
+    using namespace detail;
+    size_t anchor = 0;
+    if (n >= kMatchFind + 1) {
+        std::vector<uint32_t> table(size_t(1) << kHashLog, 0);  // 存 位置+1，0 表示空
+        size_t ip = 0;
+        const size_t limit = n - kMatchFind;
+        const size_t matchLimit = n - kLastLiterals;
+        while (ip < limit) {
+            uint32_t seq = read32(src + ip);
+            uint32_t h = hashOf(seq);
+            size_t ref = table[h];
+            table[h] = static_cast<uint32_t>(ip + 1);
+            if (ref == 0 || ip - (ref - 1) > 65535 || read32(src + ref - 1) != seq) {
+                ++ip;
+                continue;
+            }
+            ref -= 1;
+
+            // 向后延伸匹配
+            size_t len = kMinMatch;
+            while (ip + len < matchLimit && src[ref + len] == src[ip + len]) ++len;
+            // 向前延伸（吃掉尚未输出的字面量）
+            while (ip > anchor && ref > 0 && src[ip - 1] == src[ref - 1]) {
+                --ip;
+                --ref;
+                ++len;
+            }
+
+            emitSequence(out, src + anchor, ip - anchor, ip - ref, len, false);
+            ip += len;
+            anchor = ip;
+            if (ip - 2 < limit) {
+                table[hashOf(read32(src + ip - 2))] = static_cast<uint32_t>(ip - 2 + 1);
+            }
+        }
+    }
+    emitSequence(out, src + anchor, n - anchor, 0, 0, true);
+}
+
+// 解压一个块到 out（容量 cap），返回解压后长度；数据损坏返回 -1
+inline long decompressBlock(const uint8_t* src, size_t n, uint8_t* out, size_t cap) {
+    size_t ip = 0, op = 0;
+    while (ip < n) {
+        uint8_t token = src[ip++];
+        size_t litLen = token >> 4;
+        if (litLen == 15) {
+            uint8_t b;
+            do {
+                if (ip >= n) return -1;
+                b = src[ip++];
+                litLen += b;
+            } while (b == 255);
+        }
+        if (litLen > n - ip || litLen > cap - op) return -1;
+        std::memcpy(out + op, src + ip, litLen);
+        ip += litLen;
+        op += litLen;
+        if (ip == n) break;  // 最后一个序列只有字面量
+
+        if (n - ip < 2) return -1;
+        size_t offset = src[ip] | (size_t(src[ip + 1]) << 8);
+        ip += 2;
+        if (offset == 0 || offset > op) return -1;
+
+        size_t matchLen = token & 15;
+        if (matchLen == 15) {
+            uint8_t b;
+            do {
+                if (ip >= n) return -1;
+                b = src[ip++];
+                matchLen += b;
+            } while (b == 255);
+        }
+        matchLen += detail::kMinMatch;
+        if (matchLen > cap - op) return -1;
+
+        uint8_t* dst = out + op;
+        const uint8_t* from = dst - offset;
+        if (offset >= matchLen) {
+            std::memcpy(dst, from, matchLen);
+        } else {
+            for (size_t i = 0; i < matchLen; ++i) dst[i] = from[i];  // 重叠复制
+        }
+        op += matchLen;
+    }
+    return static_cast<long>(op);
+}
+
+// ========== 帧写入 ==========
+
+class FrameWriter {
+public:
+    static constexpr uint32_t kMagic = 0x184D2204;
+    static constexpr size_t kBlockSize = 1 << 20;  // BD=6：最大块 1MB
+
+    explicit FrameWriter(std::ostream& out) : out_(out) {
+        uint8_t header[7];
+        put32(header, kMagic);
+        header[4] = 0x64;  // 版本 01，块独立，含内容校验
+        header[5] = 0x60;  // 最大块 1MB
+        header[6] = static_cast<uint8_t>((Xxh32::hash(header + 4, 2) >> 8) & 0xFF);
+        out_.write(reinterpret_cast<const char*>(header), sizeof(header));
+        bytesOut_ = sizeof(header);
+        pending_.reserve(kBlockSize);
+    }
+
+    void write(const char* data, size_t len) {
+        checksum_.update(data, len);
+        while (len > 0) {
+            size_t take = std::min(len, kBlockSize - pending_.size());
+            pending_.append(data, take);
+            data += take;
+            len -= take;
+            if (pending_.size() == kBlockSize) flushBlock();
+        }
+    }
+
+    void write(const std::string& s) { write(s.data(), s.size()); }
+
+    // 写出剩余数据、结束标记与内容校验
+    void finish() {
+        if (!pending_.empty()) flushBlock();
+        uint8_t tail[8];
+        put32(tail, 0);
+        put32(tail + 4, checksum_.digest());
+        out_.write(reinterpret_cast<const char*>(tail), sizeof(tail));
+        bytesOut_ += sizeof(tail);
+    }
+
+    uint64_t bytesWritten() const { return bytesOut_; }
+
+private:
+    void flushBlock() {
+        compressed_.clear();
+        compressBlock(reinterpret_cast<const uint8_t*>(pending_.data()), pending_.size(), compressed_);
+
+        uint8_t size[4];
+        if (compressed_.size() < pending_.size()) {
+            put32(size, static_cast<uint32_t>(compressed_.size()));
+            out_.write(reinterpret_cast<const char*>(size), 4);
+            out_.write(compressed_.data(), static_cast<std::streamsize>(compressed_.size()));
+            bytesOut_ += 4 + compressed_.size();
+        } else {
+            // 不可压缩：最高位置 1，原样存储
+            put32(size, static_cast<uint32_t>(pending_.size()) | 0x80000000u);
+            out_.write(reinterpret_cast<const char*>(size), 4);
+            out_.write(pending_.data(), static_cast<std::streamsize>(pending_.size()));
+            bytesOut_ += 4 + pending_.size();
+        }
+        pending_.clear();
+    }
+
+    static void put32(uint8_t* p, uint32_t v) {
+        p[0] = static_cast<uint8_t>(v);
+        p[1] = static_cast<uint8_t>(v >> 8);
+        p[2] = static_cast<uint8_t>(v >> 16);
+        p[3] = static_cast<uint8_t>(v >> 24);
+    }
+
+    std::ostream& out_;
+    std::string pending_;
+    std::string compressed_;
+    Xxh32 checksum_;
+    uint64_t bytesOut_ = 0;
+};
+
+// ========== 帧读取 ==========
+
+class FrameReader {
+public:
+    explicit FrameReader(std::istream& in) : in_(in) {}
+
+    // 读取下一个解压后的块到 out；结束返回 false（出错时 error() 非空）
+    bool next(std::string& out) {
+        while (true) {
+            if (!inFrame_ && !openFrame()) return false;
+
+            uint32_t blockSize = 0;
+            if (!read32(blockSize)) return fail("数据截断");
+            if (blockSize == 0) {
+                // 结束标记
+                if (contentChecksum_) {
+                    uint32_t expected = 0;
+                    if (!read32(expected)) return fail("数据截断");
+                    if (expected != checksum_.digest()) return fail("内容校验失败");
+                }
+                inFrame_ = false;
+                continue;  // 可能还有后续拼接的帧
+            }
+
+            bool raw = (blockSize & 0x80000000u) != 0;
+            blockSize &= 0x7FFFFFFFu;
+            if (blockSize > blockMax_) return fail("块大小非法");
+            input_.resize(blockSize);
+            if (!in_.read(&input_[0], blockSize)) return fail("数据截断");
+            if (blockChecksum_) {
+                uint32_t ignored;
+                if (!read32(ignored)) return fail("数据截断");
+            }
+
+            if (raw) {
+                out.assign(input_.data(), blockSize);
+            } else {
+                out.resize(blockMax_);
+                long n = decompressBlock(reinterpret_cast<const uint8_t*>(input_.data()), blockSize,
+                                         reinterpret_cast<uint8_t*>(&out[0]), blockMax_);
+                if (n < 0) return fail("块数据损坏");
+                out.resize(static_cast<size_t>(n));
+            }
+            if (contentChecksum_) checksum_.update(out.data(), out.size());
+            return true;
+        }
+    }
+
+    const std::string& error() const { return error_; }
+
+private:
+    bool openFrame() {
+        uint32_t magic = 0;
+        if (!read32(magic)) return false;  // 正常结束
+        if ((magic & 0xFFFFFFF0u) == 0x184D2A50u) {
+            // 可跳过帧
+            uint32_t len = 0;
+            if (!read32(len)) return fail("数据截断");
+            in_.ignore(len);
+            return openFrame();
+        }
+        if (magic != FrameWriter::kMagic) return fail("不是 LZ4 帧格式");
+
+        uint8_t desc[2];
+        if (!in_.read(reinterpret_cast<char*>(desc), 2)) return fail("数据截断");
+        uint8_t flg = desc[0], bd = desc[1];
+        if ((flg >> 6) != 1) return fail("不支持的 LZ4 帧版本");
+        if (!(flg & 0x20)) return fail("不支持块依赖模式（请用 lz4 -BI 或默认参数压缩）");
+        if (flg & 0x01) return fail("不支持字典");
+        blockChecksum_ = (flg & 0x10) != 0;
+        contentChecksum_ = (flg & 0x04) != 0;
+        int bsid = (bd >> 4) & 7;
+        if (bsid < 4) return fail("块大小非法");
+        blockMax_ = size_t(1) << (8 + 2 * bsid);
+
+        std::string rest(1 + ((flg & 0x08) ? 8 : 0), '\0');
+        if (!in_.read(&rest[0], static_cast<std::streamsize>(rest.size()))) return fail("数据截断");
+        std::string hdr(reinterpret_cast<char*>(desc), 2);
+        hdr += rest.substr(0, rest.size() - 1);
+        uint8_t hc = static_cast<uint8_t>((Xxh32::hash(hdr.data(), hdr.size()) >> 8) & 0xFF);
+        if (hc != static_cast<uint8_t>(rest.back())) return fail("帧头校验失败");
+
+        checksum_.reset();
+        inFrame_ = true;
+        return true;
+    }
+
+    bool read32(uint32_t& v) {
+        uint8_t b[4];
+        if (!in_.read(reinterpret_cast<char*>(b), 4)) return false;
+        v = uint32_t(b[0]) | (uint32_t(b[1]) << 8) | (uint32_t(b[2]) << 16) | (uint32_t(b[3]) << 24);
+        return true;
+    }
+
+    bool fail(const char* message) {
+        error_ = message;
+        return false;
+    }
+
+    std::istream& in_;
+    bool inFrame_ = false;
+    bool blockChecksum_ = false;
+    bool contentChecksum_ = false;
+    size_t blockMax_ = 0;
+    std::string input_;
+    Xxh32 checksum_;
+    std::string error_;
+};
+
+} // namespace lz4
+
+#endif // LZ4FRAME_H
@@ -21,20 +21,42 @@ public:
         : Employee(id, name, gender, level), fixedSalary_(fixedSalary) {}
 
     // ========== 访问器 ==========
-    double getFixedSalary() const { return fixedSalary_; }
-    void setFixedSalary(double salary) { fixedSalary_ = salary; }
+    double getFixedSalary() const { ensureSpecific(); return fixedSalary_; }
+    void setFixedSalary(double salary) { ensureSpecific(); fixedSalary_ = salary; }
+
+    // ========== 岗位登记信息（见 RoleRegistry） ==========
+    static constexpr const char* kRoleName = "Manager";
+    static constexpr const char* kLabel = "经理";
+    static constexpr const char* kFullLabel = "经理";
+    static constexpr const char* kSalaryHint = "固定月薪";
+    // CSV 参数列 param1..param3 对应的 JSON 字段（nullptr 表示该列不使用）
+    static constexpr const char* kParamKeys[3] = {"fixedSalary", nullptr, nullptr};
+    // 各参数列的合理取值范围（数据校验使用，未使用的列不校验）
+    static constexpr ParamRange kParamRanges[3] = {{0, 1e6}, {0, 0}, {0, 0}};
+
+    // 由 CSV 参数列计算月薪（流式统计直接使用，无需构造对象）
+    static double salaryFromParams(double p1, double, double) {
+        return salaryFormula(p1);
+    }
 
     // ========== 实现纯虚函数 ==========
     
     std::string getRoleName() const override {
-        return "Manager";
+        return kRoleName;
+    }
+
+    // 薪资公式
+    static double salaryFormula(double fixedSalary) {
+        return fixedSalary;
     }
 
     double calculateSalary() const override {
-        return fixedSalary_;
+        ensureSpecific();
+        return salaryFormula(fixedSalary_);
     }
 
     void display() const override {
+        ensureSpecific();
         std::cout << "========== 经理信息 ==========" << std::endl;
         displayBasic();
         std::cout << std::fixed << std::setprecision(2);
@@ -44,6 +66,7 @@ public:
     }
 
     void inputSpecificInfo() override {
+        ensureSpecific();
         std::cout << "固定月薪: ";
         std::cout.flush();
         std::string s;
@@ -56,17 +79,42 @@ public:
     }
 
     std::string toCSV() const override {
+        ensureSpecific();
         std::ostringstream oss;
         oss << basicToCSV() << ","
             << std::fixed << std::setprecision(2) << fixedSalary_
-            << ",0,0";  // hours, sales 占位
+            << ",0,0"  // hours, sales 占位
+            << managerToCSV();
         return oss.str();
     }
 
+    std::string toJSON() const override {
+        ensureSpecific();
+        std::ostringstream oss;
+        oss << basicToJSON()
+            << ",\"fixedSalary\":" << std::fixed << std::setprecision(2) << fixedSalary_ << "}";
+        return oss.str();
+    }
+
+    std::unique_ptr<Employee> clone() const override {
+        materialize();
+        return std::unique_ptr<Employee>(new Manager(*this));
+    }
+
+    std::array<double, 3> getParams() const override {
+        ensureSpecific();
+        return {fixedSalary_, 0.0, 0.0};
+    }
+
+    void setParams(const std::array<double, 3>& params) override {
+        ensureSpecific();
+        fixedSalary_ = params[0];
+    }
+
     void parseCSV(const std::vector<std::string>& cols) override {
         // cols[6] = fixedSalary (baseSalary 列)
         if (cols.size() > 6) {
-            try { fixedSalary_ = std::stod(cols[6]); } catch (...) { fixedSalary_ = 0; }
+            try { fixedSalary_ = std::stod(cols[6]); } catch (...) { fixedSalary_ = 0; HR_METRIC_ADD(ParseFailures, 1); }
         }
     }
 };
@@ -0,0 +1,302 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <sstream>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+
+/**
+ * 运行指标 (Metrics)
+ * - 每类操作一个 HDR 风格延迟直方图：按 2 的幂分段，每段 32 个线性子桶，
+ *   相对误差约 3%，记录只有几次 relaxed 原子自增（按线程分条，无跨核争用）
+ * - 按编号查找等极轻量操作采用 1/256 抽样计时，次数与耗时按权重折算
+ * - 计数器：解析行数、解析失败次数、写出字节数、员工对象分配次数
+ * - 埋点统一通过 HR_METRIC_* 宏；编译时定义 HR_DISABLE_METRICS 后宏展开为空，
+ *   不产生任何计时或原子操作
+ */
+namespace metrics {
+
+// 被计时的操作
+enum class Op {
+    Load, Save, FindById, FindByName, Statistics, Ranking, Birthday,
+    Insert, Erase, Replace, PromoteAll, Query, GroupBy, ApplyChanges, Reporting,
+    Count_
+};
+
+// 计数器
+enum class Counter {
+    RowsParsed, ParseFailures, BytesWritten, Allocations,
+    Count_
+};
+
+inline const char* opName(Op op) {
+    static const char* const names[] = {
+        "load", "save", "find_by_id", "find_by_name", "statistics", "ranking", "birthday",
+        "insert", "erase", "replace", "promote_all", "query", "group_by", "apply_changes", "reporting",
+    };
+    return names[static_cast<int>(op)];
+}
+
+inline const char* counterName(Counter c) {
+    static const char* const names[] = {
+        "rows_parsed", "parse_failures", "bytes_written", "allocations",
+    };
+    return names[static_cast<int>(c)];
+}
+
+#ifndef HR_DISABLE_METRICS
+constexpr bool kEnabled = true;
+#else
+constexpr bool kEnabled = false;
+#endif
+
+// 纳秒级延迟直方图
+// 按线程分条 (stripe) 记录，避免多个工作线程争用同一缓存行；读取时合并
+class LatencyHistogram {
+public:
+    static constexpr int kSubBits = 5;
+    static constexpr int kSubCount = 1 << kSubBits;                 // 每段子桶数
+    static constexpr int kBuckets = (65 - kSubBits) * kSubCount;   // 覆盖整个 uint64 范围
+    static constexpr int kStripes = 8;
+
+    // weight > 1 用于抽样记录：一次样本代表 weight 次调用
+    void record(uint64_t ns, uint64_t weight = 1) {
+        Stripe& s = stripes_[stripeIndex()];
+        s.buckets[bucketOf(ns)].fetch_add(weight, std::memory_order_relaxed);
+        s.count.fetch_add(weight, std::memory_order_relaxed);
+        s.sum.fetch_add(ns * weight, std::memory_order_relaxed);
+        if (ns > s.max.load(std::memory_order_relaxed)) s.max.store(ns, std::memory_order_relaxed);
+    }
+
+    uint64_t count() const {
+        uint64_t total = 0;
+        for (const auto& s : stripes_) total += s.count.load(std::memory_order_relaxed);
+        return total;
+    }
+
+    uint64_t sum() const {
+        uint64_t total = 0;
+        for (const auto& s : stripes_) total += s.sum.load(std::memory_order_relaxed);
+        return total;
+    }
+
+    uint64_t max() const {
+        uint64_t m = 0;
+        for (const auto& s : stripes_) m = std::max(m, s.max.load(std::memory_order_relaxed));
+        return m;
+    }
+
+    // 分位数（p 取 0~1），返回所在桶的上界
+    uint64_t percentile(double p) const {
+        uint64_t total = count();
+        if (total == 0) return 0;
+        uint64_t target = static_cast<uint64_t>(p * static_cast<double>(total) + 0.5);
+        if (target < 1) target = 1;
+        uint64_t seen = 0;
+        for (int i = 0; i < kBuckets; ++i) {
+            for (const auto& s : stripes_) seen += s.buckets[i].load(std::memory_order_relaxed);
+            if (seen >= target) return std::min(bucketUpperBound(i), max());
+        }
+        return max();
+    }
+
+    void reset() {
+        for (auto& s : stripes_) {
+            for (auto& b : s.buckets) b.store(0, std::memory_order_relaxed);
+            s.count.store(0, std::memory_order_relaxed);
+            s.sum.store(0, std::memory_order_relaxed);
+            s.max.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    static int bucketOf(uint64_t v) {
+        if (v < static_cast<uint64_t>(kSubCount)) return static_cast<int>(v);
+        int msb = 63 - countLeadingZeros(v);
+        int sub = static_cast<int>((v >> (msb - kSubBits)) & (kSubCount - 1));
+        return (msb - kSubBits + 1) * kSubCount + sub;
+    }
+
+    static uint64_t bucketUpperBound(int idx) {
+        if (idx < kSubCount) return static_cast<uint64_t>(idx);
+        int msb = idx / kSubCount + kSubBits - 1;
+        uint64_t sub = static_cast<uint64_t>(idx % kSubCount);
+        uint64_t width = uint64_t(1) << (msb - kSubBits);
+        return ((kSubCount + sub) << (msb - kSubBits)) + width - 1;
+    }
+
+private:
+    struct alignas(64) Stripe {
+        std::atomic<uint64_t> buckets[kBuckets] = {};
+        std::atomic<uint64_t> count{0};
+        std::atomic<uint64_t> sum{0};
+        std::atomic<uint64_t> max{0};
+    };
+
+    // 每个线程首次记录时分配一个分条编号
+    static int stripeIndex() {
+        static std::atomic<int> next{0};
+        thread_local int index = next.fetch_add(1, std::memory_order_relaxed) % kStripes;
+        return index;
+    }
+
+    static int countLeadingZeros(uint64_t v) {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_clzll(v);
+#else
+        int n = 0;
+        for (uint64_t bit = uint64_t(1) << 63; bit && !(v & bit); bit >>= 1) ++n;
+        return n;
+#endif
+    }
+
+    Stripe stripes_[kStripes];
+};
+
+// 全局指标注册表
+class Registry {
+public:
+    static Registry& instance() {
+        static Registry registry;
+        return registry;
+    }
+
+    void record(Op op, uint64_t ns, uint64_t weight = 1) {
+        histograms_[static_cast<int>(op)].record(ns, weight);
+    }
+
+    void add(Counter c, uint64_t n) {
+        counters_[static_cast<int>(c)].fetch_add(n, std::memory_order_relaxed);
+    }
+
+    uint64_t counter(Counter c) const {
+        return counters_[static_cast<int>(c)].load(std::memory_order_relaxed);
+    }
+
+    const LatencyHistogram& histogram(Op op) const { return histograms_[static_cast<int>(op)]; }
+
+    void reset() {
+        for (auto& h : histograms_) h.reset();
+        for (auto& c : counters_) c.store(0, std::memory_order_relaxed);
+    }
+
+    // 控制台报告（延迟单位：微秒）
+    void report(std::ostream& os) const {
+        os << "\n========== 运行指标 ==========" << std::endl;
+        os << std::left << std::setw(14) << "op" << std::right
+           << std::setw(10) << "count" << std::setw(12) << "mean(us)"
+           << std::setw(12) << "p50(us)" << std::setw(12) << "p99(us)"
+           << std::setw(12) << "max(us)" << std::endl;
+        os << std::fixed << std::setprecision(1);
+        for (int i = 0; i < static_cast<int>(Op::Count_); ++i) {
+            const LatencyHistogram& h = histograms_[i];
+            if (h.count() == 0) continue;
+            os << std::left << std::setw(14) << opName(static_cast<Op>(i)) << std::right
+               << std::setw(10) << h.count()
+               << std::setw(12) << h.sum() / 1000.0 / h.count()
+               << std::setw(12) << h.percentile(0.50) / 1000.0
+               << std::setw(12) << h.percentile(0.99) / 1000.0
+               << std::setw(12) << h.max() / 1000.0 << std::endl;
+        }
+        os << std::endl;
+        for (int i = 0; i < static_cast<int>(Counter::Count_); ++i) {
+            os << "  " << counterName(static_cast<Counter>(i)) << ": "
+               << counters_[i].load(std::memory_order_relaxed) << std::endl;
+        }
+        os << "==============================" << std::endl;
+    }
+
+    // 机器可读的 JSON 输出（延迟单位：纳秒）
+    std::string toJSON() const {
+        std::ostringstream oss;
+        oss << "{\"enabled\":" << (kEnabled ? "true" : "false") << ",\"operations\":{";
+        bool first = true;
+        for (int i = 0; i < static_cast<int>(Op::Count_); ++i) {
+            const LatencyHistogram& h = histograms_[i];
+            if (!first) oss << ',';
+            first = false;
+            oss << '"' << opName(static_cast<Op>(i)) << "\":{\"count\":" << h.count()
+                << ",\"sum_ns\":" << h.sum()
+                << ",\"p50_ns\":" << h.percentile(0.50)
+                << ",\"p90_ns\":" << h.percentile(0.90)
+                << ",\"p99_ns\":" << h.percentile(0.99)
+                << ",\"max_ns\":" << h.max() << '}';
+        }
+        oss << "},\"counters\":{";
+        for (int i = 0; i < static_cast<int>(Counter::Count_); ++i) {
+            if (i > 0) oss << ',';
+            oss << '"' << counterName(static_cast<Counter>(i)) << "\":"
+                << counters_[i].load(std::memory_order_relaxed);
+        }
+        oss << "}}";
+        return oss.str();
+    }
+
+private:
+    Registry() = default;
+
+    LatencyHistogram histograms_[static_cast<int>(Op::Count_)];
+    std::atomic<uint64_t> counters_[static_cast<int>(Counter::Count_)] = {};
+};
+
+// 作用域计时器：析构时记录耗时
+class ScopedTimer {
+public:
+    explicit ScopedTimer(Op op) : op_(op), start_(std::chrono::steady_clock::now()) {}
+    ~ScopedTimer() {
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start_).count();
+        Registry::instance().record(op_, static_cast<uint64_t>(ns));
+    }
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+    Op op_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+// 抽样计时器：用于按编号查找这类十纳秒级操作，读时钟本身比操作还贵。
+// 每个线程每 kSampleEvery 次调用计时一次，并以 kSampleEvery 的权重记入直方图
+class SampledTimer {
+public:
+    static constexpr uint32_t kSampleEvery = 256;
+
+    explicit SampledTimer(Op op) : op_(op), sampled_((++tick_ & (kSampleEvery - 1)) == 0) {
+        if (sampled_) start_ = std::chrono::steady_clock::now();
+    }
+    ~SampledTimer() {
+        if (!sampled_) return;
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start_).count();
+        Registry::instance().record(op_, static_cast<uint64_t>(ns), kSampleEvery);
+    }
+    SampledTimer(const SampledTimer&) = delete;
+    SampledTimer& operator=(const SampledTimer&) = delete;
+
+private:
+    static inline thread_local uint32_t tick_ = 0;
+
+    Op op_;
+    bool sampled_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+} // namespace metrics
+
+#ifndef HR_DISABLE_METRICS
+#define HR_METRIC_TIMER(op) ::metrics::ScopedTimer hrMetricTimer_(::metrics::Op::op)
+#define HR_METRIC_SAMPLED_TIMER(op) ::metrics::SampledTimer hrMetricTimer_(::metrics::Op::op)
+#define HR_METRIC_ADD(counter, n) \
+    ::metrics::Registry::instance().add(::metrics::Counter::counter, static_cast<uint64_t>(n))
+#else
+#define HR_METRIC_TIMER(op) ((void)0)
+#define HR_METRIC_SAMPLED_TIMER(op) ((void)0)
+#define HR_METRIC_ADD(counter, n) ((void)0)
+#endif
+
+#endif // METRICS_H
@@ -0,0 +1,219 @@
+#ifndef ORDERSTATISTICTREE_H
+#define ORDERSTATISTICTREE_H
+
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+/**
+ * 顺序统计树 (OrderStatisticTree)
+ * - 以 Treap（随机优先级的二叉搜索树）实现，每个结点记录子树大小，
+ *   插入、删除、求名次、按名次取元素、区间计数均为期望 O(log n)
+ * - 结点存放在连续数组中，以下标代替指针，删除的结点回收到空闲链表
+ * - 批量构建时先排序，再用单调栈在 O(n) 内建出满足堆序的笛卡尔树
+ * - Less 为严格弱序；名次从 0 开始，第 0 名为 Less 意义下最小的元素
+ */
+template <typename Key, typename Less>
+class OrderStatisticTree {
+public:
+    size_t size() const { return nodes_[root_].size; }
+    bool empty() const { return root_ == kNil; }
+
+    void clear() {
+        nodes_.assign(1, Node());
+        freeList_.clear();
+        root_ = kNil;
+    }
+
+    // 用任意顺序的键重建整棵树（键须互不相同）
+    void build(std::vector<Key> keys) {
+        clear();
+        std::sort(keys.begin(), keys.end(), less_);
+        nodes_.reserve(keys.size() + 1);
+
+        // 按序追加结点，单调栈维护最右链（优先级从栈底到栈顶递减）
+        std::vector<uint32_t> stack;
+        for (const Key& key : keys) {
+            uint32_t n = allocate(key);
+            uint32_t last = kNil;
+            while (!stack.empty() && nodes_[stack.back()].priority < nodes_[n].priority) {
+                last = stack.back();
+                stack.pop_back();
+                update(last);
+            }
+            nodes_[n].left = last;
+            if (!stack.empty()) nodes_[stack.back()].right = n;
+            stack.push_back(n);
+        }
+        root_ = stack.empty() ? kNil : stack.front();  // 最右链的栈底即根
+        while (!stack.empty()) {
+            update(stack.back());
+            stack.pop_back();
+        }
+    }
+
+    void insert(const Key& key) {
+        uint32_t n = allocate(key);
+        uint32_t l, r;
+        split(root_, key, l, r);
+        root_ = merge(merge(l, n), r);
+    }
+
+    // 删除等于 key 的元素，返回是否存在
+    bool erase(const Key& key) {
+        uint32_t l, mid, r;
+        split(root_, key, l, r);          // l < key <= r
+        splitFirst(r, mid, r);            // mid 为 r 中最小的元素
+        bool found = mid != kNil && !less_(key, nodes_[mid].key);
+        if (found) {
+            freeList_.push_back(mid);
+        } else {
+            r = merge(mid, r);
+        }
+        root_ = merge(l, r);
+        return found;
+    }
+
+    // 严格小于 key 的元素个数（即 key 若存在时的名次）
+    size_t countLess(const Key& key) const {
+        size_t count = 0;
+        uint32_t t = root_;
+        while (t != kNil) {
+            if (less_(nodes_[t].key, key)) {
+                count += nodes_[nodes_[t].left].size + 1;
+                t = nodes_[t].right;
+            } else {
+                t = nodes_[t].left;
+            }
+        }
+        return count;
+    }
+
+    // 第 rank 名的键（rank < size()）
+    const Key& at(size_t rank) const {
+        uint32_t t = root_;
+        while (true) {
+            size_t leftSize = nodes_[nodes_[t].left].size;
+            if (rank < leftSize) {
+                t = nodes_[t].left;
+            } else if (rank == leftSize) {
+                return nodes_[t].key;
+            } else {
+                rank -= leftSize + 1;
+                t = nodes_[t].right;
+            }
+        }
+    }
+
+    // 按名次顺序访问 [first, first + count) 内的元素，O(log n + count)
+    template <typename Fn>
+    void forEachInRange(size_t first, size_t count, Fn fn) const {
+        if (first >= size() || count == 0) return;
+        size_t last = std::min(size(), first + count);
+        visit(root_, 0, first, last, fn);
+    }
+
+private:
+    static constexpr uint32_t kNil = 0;  // 0 号结点为哨兵，size 恒为 0
+
+    struct Node {
+        Key key{};
+        uint32_t priority = 0;
+        uint32_t left = kNil;
+        uint32_t right = kNil;
+        uint32_t size = 0;
+    };
+
+    std::vector<Node> nodes_ = std::vector<Node>(1);
+    std::vector<uint32_t> freeList_;
+    uint32_t root_ = kNil;
+    uint64_t seed_ = 0x9E3779B97F4A7C15ULL;
+    Less less_;
+
+    uint32_t nextPriority() {
+        seed_ ^= seed_ << 13;
+        seed_ ^= seed_ >> 7;
+        seed_ ^= seed_ << 17;
+        return static_cast<uint32_t>(seed_ >> 32);
+    }
+
+    uint32_t allocate(const Key& key) {
+        uint32_t n;
+        if (!freeList_.empty()) {
+            n = freeList_.back();
+            freeList_.pop_back();
+        } else {
+            n = static_cast<uint32_t>(nodes_.size());
+            nodes_.emplace_back();
+        }
+        Node& node = nodes_[n];
+        node.key = key;
+        node.priority = nextPriority();
+        node.left = node.right = kNil;
+        node.size = 1;
+        return n;
+    }
+
+    void update(uint32_t t) {
+        nodes_[t].size = nodes_[nodes_[t].left].size + nodes_[nodes_[t].right].size + 1;
+    }
+
+    // 拆分为 (< key) 与 (>= key) 两棵树
+    void split(uint32_t t, const Key& key, uint32_t& l, uint32_t& r) {
+        if (t == kNil) {
+            l = r = kNil;
+            return;
+        }
+        if (less_(nodes_[t].key, key)) {
+            split(nodes_[t].right, key, nodes_[t].right, r);
+            l = t;
+        } else {
+            split(nodes_[t].left, key, l, nodes_[t].left);
+            r = t;
+        }
+        update(t);
+    }
+
+    // 拆出最小的一个元素
+    void splitFirst(uint32_t t, uint32_t& first, uint32_t& rest) {
+        if (t == kNil) {
+            first = rest = kNil;
+            return;
+        }
+        if (nodes_[t].left == kNil) {
+            first = t;
+            rest = nodes_[t].right;
+            nodes_[t].right = kNil;
+            update(t);
+            return;
+        }
+        splitFirst(nodes_[t].left, first, nodes_[t].left);
+        update(t);
+        rest = t;
+    }
+
+    uint32_t merge(uint32_t l, uint32_t r) {
+        if (l == kNil) return r;
+        if (r == kNil) return l;
+        if (nodes_[l].priority > nodes_[r].priority) {
+            nodes_[l].right = merge(nodes_[l].right, r);
+            update(l);
+            return l;
+        }
+        nodes_[r].left = merge(l, nodes_[r].left);
+        update(r);
+        return r;
+    }
+
+    // offset 为子树 t 中最小元素的名次；只进入与 [first, last) 相交的子树
+    template <typename Fn>
+    void visit(uint32_t t, size_t offset, size_t first, size_t last, Fn& fn) const {
+        if (t == kNil || offset >= last || offset + nodes_[t].size <= first) return;
+        size_t self = offset + nodes_[nodes_[t].left].size;
+        visit(nodes_[t].left, offset, first, last, fn);
+        if (self >= first && self < last) fn(self, nodes_[t].key);
+        visit(nodes_[t].right, self + 1, first, last, fn);
+    }
+};
+
+#endif // ORDERSTATISTICTREE_H
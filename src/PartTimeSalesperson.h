@@ -23,23 +23,45 @@ public:
           commissionRate_(commissionRate), salesAmount_(salesAmount) {}
 
     // ========== 访问器 ==========
-    double getCommissionRate() const { return commissionRate_; }
-    void setCommissionRate(double rate) { commissionRate_ = rate; }
+    double getCommissionRate() const { ensureSpecific(); return commissionRate_; }
+    void setCommissionRate(double rate) { ensureSpecific(); commissionRate_ = rate; }
     
-    double getSalesAmount() const { return salesAmount_; }
-    void setSalesAmount(double amount) { salesAmount_ = amount; }
+    double getSalesAmount() const { ensureSpecific(); return salesAmount_; }
+    void setSalesAmount(double amount) { ensureSpecific(); salesAmount_ = amount; }
+
+    // ========== 岗位登记信息（见 RoleRegistry） ==========
+    static constexpr const char* kRoleName = "PartTimeSales";
+    static constexpr const char* kLabel = "兼职推销";
+    static constexpr const char* kFullLabel = "兼职推销员";
+    static constexpr const char* kSalaryHint = "按销售提成";
+    // CSV 参数列 param1..param3 对应的 JSON 字段（nullptr 表示该列不使用）
+    static constexpr const char* kParamKeys[3] = {"commissionRate", nullptr, "salesAmount"};
+    // 各参数列的合理取值范围（数据校验使用，未使用的列不校验）
+    static constexpr ParamRange kParamRanges[3] = {{0, 1}, {0, 0}, {0, 1e10}};
+
+    // 由 CSV 参数列计算月薪（流式统计直接使用，无需构造对象）
+    static double salaryFromParams(double p1, double, double p3) {
+        return salaryFormula(p1, p3);
+    }
 
     // ========== 实现纯虚函数 ==========
     
     std::string getRoleName() const override {
-        return "PartTimeSales";
+        return kRoleName;
+    }
+
+    // 薪资公式
+    static double salaryFormula(double commissionRate, double salesAmount) {
+        return salesAmount * commissionRate;
     }
 
     double calculateSalary() const override {
-        return salesAmount_ * commissionRate_;
+        ensureSpecific();
+        return salaryFormula(commissionRate_, salesAmount_);
     }
 
     void display() const override {
+        ensureSpecific();
         std::cout << "========== 兼职推销员信息 ==========" << std::endl;
         displayBasic();
         std::cout << std::fixed << std::setprecision(2);
@@ -50,6 +72,7 @@ public:
     }
 
     void inputSpecificInfo() override {
+        ensureSpecific();
         std::cout << "提成比例(如0.05表示5%): ";
         std::cout.flush();
         std::string s;
@@ -63,21 +86,48 @@ public:
     }
 
     std::string toCSV() const override {
+        ensureSpecific();
         std::ostringstream oss;
         oss << basicToCSV() << ","
             << std::fixed << std::setprecision(4) << commissionRate_ << ","
             << "0,"  // hours 占位
-            << std::fixed << std::setprecision(2) << salesAmount_;
+            << std::fixed << std::setprecision(2) << salesAmount_
+            << managerToCSV();
         return oss.str();
     }
 
+    std::string toJSON() const override {
+        ensureSpecific();
+        std::ostringstream oss;
+        oss << basicToJSON()
+            << ",\"commissionRate\":" << std::fixed << std::setprecision(4) << commissionRate_
+            << ",\"salesAmount\":" << std::fixed << std::setprecision(2) << salesAmount_ << "}";
+        return oss.str();
+    }
+
+    std::unique_ptr<Employee> clone() const override {
+        materialize();
+        return std::unique_ptr<Employee>(new PartTimeSalesperson(*this));
+    }
+
+    std::array<double, 3> getParams() const override {
+        ensureSpecific();
+        return {commissionRate_, 0.0, salesAmount_};
+    }
+
+    void setParams(const std::array<double, 3>& params) override {
+        ensureSpecific();
+        commissionRate_ = params[0];
+        salesAmount_ = params[2];
+    }
+
     void parseCSV(const std::vector<std::string>& cols) override {
         // cols[6] = commissionRate, cols[8] = salesAmount
         if (cols.size() > 6) {
-            try { commissionRate_ = std::stod(cols[6]); } catch (...) { commissionRate_ = 0; }
+            try { commissionRate_ = std::stod(cols[6]); } catch (...) { commissionRate_ = 0; HR_METRIC_ADD(ParseFailures, 1); }
         }
         if (cols.size() > 8) {
-            try { salesAmount_ = std::stod(cols[8]); } catch (...) { salesAmount_ = 0; }
+            try { salesAmount_ = std::stod(cols[8]); } catch (...) { salesAmount_ = 0; HR_METRIC_ADD(ParseFailures, 1); }
         }
     }
 };
@@ -23,23 +23,45 @@ public:
           hourlyRate_(hourlyRate), hoursWorked_(hoursWorked) {}
 
     // ========== 访问器 ==========
-    double getHourlyRate() const { return hourlyRate_; }
-    void setHourlyRate(double rate) { hourlyRate_ = rate; }
+    double getHourlyRate() const { ensureSpecific(); return hourlyRate_; }
+    void setHourlyRate(double rate) { ensureSpecific(); hourlyRate_ = rate; }
     
-    double getHoursWorked() const { return hoursWorked_; }
-    void setHoursWorked(double hours) { hoursWorked_ = hours; }
+    double getHoursWorked() const { ensureSpecific(); return hoursWorked_; }
+    void setHoursWorked(double hours) { ensureSpecific(); hoursWorked_ = hours; }
+
+    // ========== 岗位登记信息（见 RoleRegistry） ==========
+    static constexpr const char* kRoleName = "PartTimeTech";
+    static constexpr const char* kLabel = "兼职技术";
+    static constexpr const char* kFullLabel = "兼职技术人员";
+    static constexpr const char* kSalaryHint = "按工时计薪";
+    // CSV 参数列 param1..param3 对应的 JSON 字段（nullptr 表示该列不使用）
+    static constexpr const char* kParamKeys[3] = {"hourlyRate", "hoursWorked", nullptr};
+    // 各参数列的合理取值范围（数据校验使用，未使用的列不校验）
+    static constexpr ParamRange kParamRanges[3] = {{0, 1e4}, {0, 744}, {0, 0}};
+
+    // 由 CSV 参数列计算月薪（流式统计直接使用，无需构造对象）
+    static double salaryFromParams(double p1, double p2, double) {
+        return salaryFormula(p1, p2);
+    }
 
     // ========== 实现纯虚函数 ==========
     
     std::string getRoleName() const override {
-        return "PartTimeTech";
+        return kRoleName;
+    }
+
+    // 薪资公式
+    static double salaryFormula(double hourlyRate, double hoursWorked) {
+        return hourlyRate * hoursWorked;
     }
 
     double calculateSalary() const override {
-        return hourlyRate_ * hoursWorked_;
+        ensureSpecific();
+        return salaryFormula(hourlyRate_, hoursWorked_);
     }
 
     void display() const override {
+        ensureSpecific();
         std::cout << "========== 兼职技术人员信息 ==========" << std::endl;
         displayBasic();
         std::cout << std::fixed << std::setprecision(2);
@@ -50,6 +72,7 @@ public:
     }
 
     void inputSpecificInfo() override {
+        ensureSpecific();
         std::cout << "时薪: ";
         std::cout.flush();
         std::string s;
@@ -63,21 +86,48 @@ public:
     }
 
     std::string toCSV() const override {
+        ensureSpecific();
         std::ostringstream oss;
         oss << basicToCSV() << ","
             << std::fixed << std::setprecision(2) << hourlyRate_ << ","
             << std::fixed << std::setprecision(2) << hoursWorked_ << ","
-            << "0";  // sales 占位
+            << "0"  // sales 占位
+            << managerToCSV();
         return oss.str();
     }
 
+    std::string toJSON() const override {
+        ensureSpecific();
+        std::ostringstream oss;
+        oss << basicToJSON() << std::fixed << std::setprecision(2)
+            << ",\"hourlyRate\":" << hourlyRate_
+            << ",\"hoursWorked\":" << hoursWorked_ << "}";
+        return oss.str();
+    }
+
+    std::unique_ptr<Employee> clone() const override {
+        materialize();
+        return std::unique_ptr<Employee>(new PartTimeTechnician(*this));
+    }
+
+    std::array<double, 3> getParams() const override {
+        ensureSpecific();
+        return {hourlyRate_, hoursWorked_, 0.0};
+    }
+
+    void setParams(const std::array<double, 3>& params) override {
+        ensureSpecific();
+        hourlyRate_ = params[0];
+        hoursWorked_ = params[1];
+    }
+
     void parseCSV(const std::vector<std::string>& cols) override {
         // cols[6] = hourlyRate, cols[7] = hoursWorked
         if (cols.size() > 6) {
-            try { hourlyRate_ = std::stod(cols[6]); } catch (...) { hourlyRate_ = 0; }
+            try { hourlyRate_ = std::stod(cols[6]); } catch (...) { hourlyRate_ = 0; HR_METRIC_ADD(ParseFailures, 1); }
         }
         if (cols.size() > 7) {
-            try { hoursWorked_ = std::stod(cols[7]); } catch (...) { hoursWorked_ = 0; }
+            try { hoursWorked_ = std::stod(cols[7]); } catch (...) { hoursWorked_ = 0; HR_METRIC_ADD(ParseFailures, 1); }
         }
     }
 };
@@ -0,0 +1,606 @@
+#ifndef QUERY_H
+#define QUERY_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cstring>
+#include <cstdlib>
+#include <cerrno>
+#include <algorithm>
+
+#include "ColumnSnapshot.h"
+#include "BitOps.h"
+
+/**
+ * 条件查询 (Query)
+ * - 查询语言示例：
+ *     role == SalesManager && level >= 4 && sales > 300000
+ *     gender == 女 && birthday < 1990-01-01
+ *     !(role == Manager) || name == "张三"
+ * - 运算符：== != < <= > >=，逻辑 && || !（也可写 and / or / not），括号分组
+ * - 字段：id name role level gender birthday manager salary sales rate hours base
+ *   （manager 为直接上级的编号，无上级为 0；base 为经理/销售经理的固定月薪或兼职技术的时薪）
+ * - 查询只解析一次：表达式树在编译时完成字段与字面量的类型检查和转换，
+ *   生成后缀形式的执行计划，每个比较节点绑定一个按列类型与运算符特化的扫描函数
+ * - 执行时按 4096 行一批扫描列式快照，每个比较生成一段选择位图，再按位与/或/非合并；
+ *   扫描过程不调用虚函数、不拷贝字符串
+ * - 生日缺失的员工不满足任何关于 birthday 的比较（包括 !=）
+ */
+namespace query {
+
+enum class Field : uint8_t { Id, Name, Role, Level, Gender, Birthday, Manager, Salary, Sales, Rate, Hours, Base };
+enum class CmpOp : uint8_t { Eq, Ne, Lt, Le, Gt, Ge };
+
+// 选择位图：第 i 位为 1 表示快照第 i 行被选中
+class Selection {
+public:
+    explicit Selection(size_t rows = 0) : rows_(rows), words_((rows + 63) / 64, 0) {}
+
+    size_t rows() const { return rows_; }
+    uint64_t* data() { return words_.data(); }
+    const uint64_t* data() const { return words_.data(); }
+
+    bool test(size_t row) const { return (words_[row >> 6] >> (row & 63)) & 1; }
+
+    size_t count() const {
+        size_t n = 0;
+        for (uint64_t w : words_) n += static_cast<size_t>(bitops::popcount64(w));
+        return n;
+    }
+
+    // 按行号升序遍历被选中的行
+    template <typename Fn>
+    void forEach(Fn fn) const {
+        for (size_t w = 0; w < words_.size(); ++w) {
+            uint64_t bits = words_[w];
+            while (bits) {
+                fn(w * 64 + static_cast<size_t>(bitops::countTrailingZeros64(bits)));
+                bits &= bits - 1;
+            }
+        }
+    }
+
+private:
+    size_t rows_;
+    std::vector<uint64_t> words_;
+};
+
+// ========== 词法与语法分析 ==========
+
+struct Node {
+    enum Kind { And, Or, Not, Compare } kind;
+    Field field = Field::Id;
+    CmpOp op = CmpOp::Eq;
+    std::string literal;
+    std::unique_ptr<Node> left, right;  // Not 只使用 left
+};
+
+class Parser {
+public:
+    explicit Parser(const std::string& text) : text_(text) {}
+
+    // 解析整条查询，失败时返回 nullptr 并设置 error
+    std::unique_ptr<Node> parse(std::string& error) {
+        pos_ = 0;
+        error_.clear();
+        advance();
+        std::unique_ptr<Node> root;
+        if (tok_.kind == Tok::End) {
+            fail("查询条件为空");
+        } else {
+            root = parseOr();
+            if (root && tok_.kind != Tok::End) fail("多余的内容 \"" + tok_.text + "\"");
+        }
+        if (!error_.empty()) {
+            error = error_;
+            return nullptr;
+        }
+        return root;
+    }
+
+private:
+    struct Tok {
+        enum Kind { Word, String, Op, AndAnd, OrOr, Bang, LParen, RParen, End, Bad } kind = End;
+        std::string text;
+        CmpOp op = CmpOp::Eq;
+        size_t pos = 0;
+    };
+
+    const std::string& text_;
+    size_t pos_ = 0;
+    Tok tok_;
+    std::string error_;
+
+    static bool isDelimiter(char c) {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '=' || c == '!' ||
+               c == '<' || c == '>' || c == '&' || c == '|' || c == '(' || c == ')' || c == '"';
+    }
+
+    void fail(const std::string& message) {
+        if (error_.empty()) error_ = "第 " + std::to_string(tok_.pos + 1) + " 个字符附近: " + message;
+    }
+
+    void advance() {
+        while (pos_ < text_.size() && (text_[pos_] == ' ' || text_[pos_] == '\t' ||
+                                       text_[pos_] == '\r' || text_[pos_] == '\n')) {
+            ++pos_;
+        }
+        tok_ = Tok();
+        tok_.pos = pos_;
+        if (pos_ >= text_.size()) return;
+
+        char c = text_[pos_];
+        char next = pos_ + 1 < text_.size() ? text_[pos_ + 1] : '\0';
+        auto op = [&](Tok::Kind kind, size_t len, CmpOp cmp = CmpOp::Eq) {
+            tok_.kind = kind;
+            tok_.op = cmp;
+            tok_.text = text_.substr(pos_, len);
+            pos_ += len;
+        };
+
+        if (c == '(') return op(Tok::LParen, 1);
+        if (c == ')') return op(Tok::RParen, 1);
+        if (c == '&') return next == '&' ? op(Tok::AndAnd, 2) : op(Tok::Bad, 1);
+        if (c == '|') return next == '|' ? op(Tok::OrOr, 2) : op(Tok::Bad, 1);
+        if (c == '=') return next == '=' ? op(Tok::Op, 2, CmpOp::Eq) : op(Tok::Op, 1, CmpOp::Eq);
+        if (c == '!') return next == '=' ? op(Tok::Op, 2, CmpOp::Ne) : op(Tok::Bang, 1);
+        if (c == '<') return next == '=' ? op(Tok::Op, 2, CmpOp::Le) : op(Tok::Op, 1, CmpOp::Lt);
+        if (c == '>') return next == '=' ? op(Tok::Op, 2, CmpOp::Ge) : op(Tok::Op, 1, CmpOp::Gt);
+
+        if (c == '"') {
+            size_t close = text_.find('"', pos_ + 1);
+            if (close == std::string::npos) return op(Tok::Bad, text_.size() - pos_);
+            tok_.kind = Tok::String;
+            tok_.text = text_.substr(pos_ + 1, close - pos_ - 1);
+            pos_ = close + 1;
+            return;
+        }
+
+        size_t end = pos_;
+        while (end < text_.size() && !isDelimiter(text_[end])) ++end;
+        tok_.kind = Tok::Word;
+        tok_.text = text_.substr(pos_, end - pos_);
+        pos_ = end;
+        if (tok_.text == "and" || tok_.text == "AND") tok_.kind = Tok::AndAnd;
+        else if (tok_.text == "or" || tok_.text == "OR") tok_.kind = Tok::OrOr;
+        else if (tok_.text == "not" || tok_.text == "NOT") tok_.kind = Tok::Bang;
+    }
+
+    static std::unique_ptr<Node> binary(Node::Kind kind, std::unique_ptr<Node> l, std::unique_ptr<Node> r) {
+        std::unique_ptr<Node> n(new Node());
+        n->kind = kind;
+        n->left = std::move(l);
+        n->right = std::move(r);
+        return n;
+    }
+
+    // or := and ( '||' and )*
+    std::unique_ptr<Node> parseOr() {
+        std::unique_ptr<Node> left = parseAnd();
+        while (left && tok_.kind == Tok::OrOr) {
+            advance();
+            std::unique_ptr<Node> right = parseAnd();
+            if (!right) return nullptr;
+            left = binary(Node::Or, std::move(left), std::move(right));
+        }
+        return left;
+    }
+
+    // and := unary ( '&&' unary )*
+    std::unique_ptr<Node> parseAnd() {
+        std::unique_ptr<Node> left = parseUnary();
+        while (left && tok_.kind == Tok::AndAnd) {
+            advance();
+            std::unique_ptr<Node> right = parseUnary();
+            if (!right) return nullptr;
+            left = binary(Node::And, std::move(left), std::move(right));
+        }
+        return left;
+    }
+
+    // unary := '!' unary | '(' or ')' | comparison
+    std::unique_ptr<Node> parseUnary() {
+        if (tok_.kind == Tok::Bang) {
+            advance();
+            std::unique_ptr<Node> inner = parseUnary();
+            if (!inner) return nullptr;
+            return binary(Node::Not, std::move(inner), nullptr);
+        }
+        if (tok_.kind == Tok::LParen) {
+            advance();
+            std::unique_ptr<Node> inner = parseOr();
+            if (!inner) return nullptr;
+            if (tok_.kind != Tok::RParen) {
+                fail("缺少右括号");
+                return nullptr;
+            }
+            advance();
+            return inner;
+        }
+        return parseComparison();
+    }
+
+    // comparison := field op value
+    std::unique_ptr<Node> parseComparison() {
+        if (tok_.kind != Tok::Word) {
+            fail(tok_.kind == Tok::End ? "条件不完整" : "此处应为字段名，而不是 \"" + tok_.text + "\"");
+            return nullptr;
+        }
+        std::unique_ptr<Node> n(new Node());
+        n->kind = Node::Compare;
+        if (!lookupField(tok_.text, n->field)) {
+            fail("未知字段 \"" + tok_.text + "\"");
+            return nullptr;
+        }
+        advance();
+        if (tok_.kind != Tok::Op) {
+            fail("此处应为比较运算符");
+            return nullptr;
+        }
+        n->op = tok_.op;
+        advance();
+        if (tok_.kind != Tok::Word && tok_.kind != Tok::String) {
+            fail("此处应为比较的值");
+            return nullptr;
+        }
+        n->literal = tok_.text;
+        advance();
+        return n;
+    }
+
+    static bool lookupField(const std::string& name, Field& field) {
+        static const struct { const char* name; Field field; } kFields[] = {
+            {"id", Field::Id}, {"编号", Field::Id},
+            {"name", Field::Name}, {"姓名", Field::Name},
+            {"role", Field::Role}, {"岗位", Field::Role},
+            {"level", Field::Level}, {"级别", Field::Level},
+            {"gender", Field::Gender}, {"性别", Field::Gender},
+            {"birthday", Field::Birthday}, {"生日", Field::Birthday},
+            {"manager", Field::Manager}, {"上级", Field::Manager},
+            {"salary", Field::Salary}, {"月薪", Field::Salary},
+            {"sales", Field::Sales}, {"销售额", Field::Sales},
+            {"rate", Field::Rate}, {"提成比例", Field::Rate},
+            {"hours", Field::Hours}, {"工时", Field::Hours},
+            {"base", Field::Base}, {"底薪", Field::Base},
+        };
+        for (const auto& f : kFields) {
+            if (name == f.name) {
+                field = f.field;
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+// ========== 编译与执行 ==========
+
+class CompiledQuery {
+public:
+    static constexpr size_t kBatchRows = 4096;
+    static constexpr size_t kBatchWords = kBatchRows / 64;
+
+    // 可由位图索引回答的条件：岗位/性别相等，或任意级别比较
+    struct IndexTerm {
+        Field field;
+        CmpOp op;
+        int value;  // 岗位、性别为编码，级别为级别值
+    };
+
+    // 解析并编译查询，失败时返回 false 并设置 error
+    bool compile(const std::string& text, std::string* error = nullptr) {
+        program_.clear();
+        indexTerms_.clear();
+        depth_ = 0;
+        text_ = text;
+
+        std::string message;
+        std::unique_ptr<Node> root = Parser(text).parse(message);
+        if (root && !emit(*root, message)) root.reset();
+        if (!root) {
+            program_.clear();
+            if (error) *error = message;
+            return false;
+        }
+        indexable_ = collectIndexTerms(*root);
+        if (!indexable_) indexTerms_.clear();
+
+        // 计算执行时位图栈的最大深度
+        size_t sp = 0;
+        for (const Instr& in : program_) {
+            if (in.kind == Instr::Compare) depth_ = std::max(depth_, ++sp);
+            else if (in.kind != Instr::Not) --sp;
+        }
+        return true;
+    }
+
+    bool valid() const { return !program_.empty(); }
+
+    // 查询是否为若干可索引条件的合取；是则返回这些条件，否则返回 nullptr
+    const std::vector<IndexTerm>* indexTerms() const {
+        return indexable_ ? &indexTerms_ : nullptr;
+    }
+    const std::string& text() const { return text_; }
+
+    // 在快照上执行查询
+    Selection evaluate(const ColumnSnapshot& s) const {
+        size_t rows = s.rows();
+        Selection result(rows);
+        if (program_.empty()) return result;
+
+        std::vector<uint64_t> stack(depth_ * kBatchWords);
+        for (size_t begin = 0; begin < rows; begin += kBatchRows) {
+            size_t n = std::min(kBatchRows, rows - begin);
+            size_t words = (n + 63) / 64;
+            size_t sp = 0;
+            for (const Instr& in : program_) {
+                switch (in.kind) {
+                    case Instr::Compare:
+                        in.kernel(s, in, begin, n, &stack[sp * kBatchWords]);
+                        ++sp;
+                        break;
+                    case Instr::And: {
+                        --sp;
+                        uint64_t* a = &stack[(sp - 1) * kBatchWords];
+                        const uint64_t* b = &stack[sp * kBatchWords];
+                        for (size_t w = 0; w < words; ++w) a[w] &= b[w];
+                        break;
+                    }
+                    case Instr::Or: {
+                        --sp;
+                        uint64_t* a = &stack[(sp - 1) * kBatchWords];
+                        const uint64_t* b = &stack[sp * kBatchWords];
+                        for (size_t w = 0; w < words; ++w) a[w] |= b[w];
+                        break;
+                    }
+                    case Instr::Not: {
+                        uint64_t* a = &stack[(sp - 1) * kBatchWords];
+                        for (size_t w = 0; w < words; ++w) a[w] = ~a[w];
+                        if (n % 64) a[words - 1] &= (uint64_t(1) << (n % 64)) - 1;  // 清除批尾无效位
+                        break;
+                    }
+                }
+            }
+            std::memcpy(result.data() + begin / 64, stack.data(), words * sizeof(uint64_t));
+        }
+        return result;
+    }
+
+private:
+    struct Instr;
+    using Kernel = void (*)(const ColumnSnapshot&, const Instr&, size_t begin, size_t n, uint64_t* out);
+
+    struct Instr {
+        enum Kind : uint8_t { Compare, And, Or, Not } kind = Compare;
+        Kernel kernel = nullptr;
+        int32_t intValue = 0;
+        double doubleValue = 0.0;
+        uint8_t codeValue = 0;
+        std::string stringValue;
+    };
+
+    std::vector<Instr> program_;  // 后缀形式
+    size_t depth_ = 0;
+    std::vector<IndexTerm> indexTerms_;
+    bool indexable_ = false;
+    std::string text_;
+
+    // ---------- 特化的扫描函数 ----------
+
+    template <CmpOp Op, typename T>
+    static bool apply(T a, T b) {
+        switch (Op) {
+            case CmpOp::Eq: return a == b;
+            case CmpOp::Ne: return a != b;
+            case CmpOp::Lt: return a < b;
+            case CmpOp::Le: return a <= b;
+            case CmpOp::Gt: return a > b;
+            case CmpOp::Ge: return a >= b;
+        }
+        return false;
+    }
+
+    static int32_t literal(const Instr& in, int32_t) { return in.intValue; }
+    static double literal(const Instr& in, double) { return in.doubleValue; }
+    static uint8_t literal(const Instr& in, uint8_t) { return in.codeValue; }
+
+    // 比较一列中的 n 个值，每 64 行打包为一个位图字；Nullable 时 0 视为缺失
+    template <typename T, std::vector<T> ColumnSnapshot::*Column, CmpOp Op, bool Nullable>
+    static void scanColumn(const ColumnSnapshot& s, const Instr& in, size_t begin, size_t n, uint64_t* out) {
+        const T* col = (s.*Column).data() + begin;
+        const T value = literal(in, T());
+        for (size_t base = 0; base < n; base += 64) {
+            size_t m = std::min<size_t>(64, n - base);
+            const T* p = col + base;
+            uint64_t bits = 0;
+            for (size_t j = 0; j < m; ++j) {
+                bool hit = apply<Op>(p[j], value);
+                if (Nullable) hit = hit & (p[j] != 0);
+                bits |= static_cast<uint64_t>(hit) << j;
+            }
+            out[base / 64] = bits;
+        }
+    }
+
+    // 姓名比较：直接在姓名池中逐字节比较，不构造字符串
+    template <bool Equal>
+    static void scanName(const ColumnSnapshot& s, const Instr& in, size_t begin, size_t n, uint64_t* out) {
+        const char* pool = s.namePool.data();
+        const uint32_t* off = s.nameOffset.data() + begin;
+        const std::string& value = in.stringValue;
+        for (size_t base = 0; base < n; base += 64) {
+            size_t m = std::min<size_t>(64, n - base);
+            uint64_t bits = 0;
+            for (size_t j = 0; j < m; ++j) {
+                uint32_t from = off[base + j], to = off[base + j + 1];
+                bool eq = to - from == value.size() && std::memcmp(pool + from, value.data(), value.size()) == 0;
+                bits |= static_cast<uint64_t>(eq == Equal) << j;
+            }
+            out[base / 64] = bits;
+        }
+    }
+
+    template <typename T, std::vector<T> ColumnSnapshot::*Column, bool Nullable = false>
+    static Kernel pick(CmpOp op) {
+        switch (op) {
+            case CmpOp::Eq: return &scanColumn<T, Column, CmpOp::Eq, Nullable>;
+            case CmpOp::Ne: return &scanColumn<T, Column, CmpOp::Ne, Nullable>;
+            case CmpOp::Lt: return &scanColumn<T, Column, CmpOp::Lt, Nullable>;
+            case CmpOp::Le: return &scanColumn<T, Column, CmpOp::Le, Nullable>;
+            case CmpOp::Gt: return &scanColumn<T, Column, CmpOp::Gt, Nullable>;
+            case CmpOp::Ge: return &scanColumn<T, Column, CmpOp::Ge, Nullable>;
+        }
+        return nullptr;
+    }
+
+    // ---------- 表达式树 → 执行计划 ----------
+
+    bool emit(const Node& node, std::string& error) {
+        if (node.kind == Node::Compare) {
+            Instr in;
+            if (!bindCompare(node, in, error)) return false;
+            program_.push_back(std::move(in));
+            return true;
+        }
+        if (!emit(*node.left, error)) return false;
+        if (node.right && !emit(*node.right, error)) return false;
+
+        Instr in;
+        in.kind = node.kind == Node::And ? Instr::And : node.kind == Node::Or ? Instr::Or : Instr::Not;
+        program_.push_back(std::move(in));
+        return true;
+    }
+
+    bool collectIndexTerms(const Node& node) {
+        if (node.kind == Node::And) return collectIndexTerms(*node.left) && collectIndexTerms(*node.right);
+        if (node.kind != Node::Compare) return false;
+
+        IndexTerm term{node.field, node.op, 0};
+        if (node.field == Field::Level) {
+            int32_t level = 0;
+            if (!parseInt(node.literal, level)) return false;
+            term.value = level;
+        } else if (node.op != CmpOp::Eq) {
+            return false;
+        } else if (node.field == Field::Role) {
+            term.value = roleLiteral(node.literal);
+        } else if (node.field == Field::Gender) {
+            term.value = ColumnSnapshot::genderCode(node.literal);
+        } else {
+            return false;
+        }
+        indexTerms_.push_back(term);
+        return true;
+    }
+
+    // 按字段类型转换字面量并选择扫描函数
+    static bool bindCompare(const Node& node, Instr& in, std::string& error) {
+        const std::string& lit = node.literal;
+        bool equality = node.op == CmpOp::Eq || node.op == CmpOp::Ne;
+
+        switch (node.field) {
+            case Field::Id:
+            case Field::Level:
+            case Field::Manager:
+                if (!parseInt(lit, in.intValue)) {
+                    error = "\"" + lit + "\" 不是整数";
+                    return false;
+                }
+                in.kernel = node.field == Field::Id      ? pick<int32_t, &ColumnSnapshot::id>(node.op)
+                          : node.field == Field::Level   ? pick<int32_t, &ColumnSnapshot::level>(node.op)
+                                                         : pick<int32_t, &ColumnSnapshot::managerId>(node.op);
+                return true;
+
+            case Field::Birthday:
+                in.intValue = ColumnSnapshot::dateCode(lit);
+                if (in.intValue == 0) {
+                    error = "\"" + lit + "\" 不是有效日期（格式 YYYY-MM-DD）";
+                    return false;
+                }
+                in.kernel = pick<int32_t, &ColumnSnapshot::birthday, true>(node.op);
+                return true;
+
+            case Field::Role:
+                in.codeValue = roleLiteral(lit);
+                if (in.codeValue == ColumnSnapshot::kUnknownRole) {
+                    error = "未知岗位 \"" + lit + "\"（可选 " + roles::nameList(" ") + "）";
+                    return false;
+                }
+                if (!equality) {
+                    error = "岗位只支持 == 和 !=";
+                    return false;
+                }
+                in.kernel = pick<uint8_t, &ColumnSnapshot::role>(node.op);
+                return true;
+
+            case Field::Gender:
+                if (lit != "男" && lit != "女") {
+                    error = "性别只能是 男 或 女";
+                    return false;
+                }
+                if (!equality) {
+                    error = "性别只支持 == 和 !=";
+                    return false;
+                }
+                in.codeValue = ColumnSnapshot::genderCode(lit);
+                in.kernel = pick<uint8_t, &ColumnSnapshot::gender>(node.op);
+                return true;
+
+            case Field::Name:
+                if (!equality) {
+                    error = "姓名只支持 == 和 !=";
+                    return false;
+                }
+                in.stringValue = lit;
+                in.kernel = node.op == CmpOp::Eq ? &scanName<true> : &scanName<false>;
+                return true;
+
+            case Field::Salary:
+            case Field::Sales:
+            case Field::Rate:
+            case Field::Hours:
+            case Field::Base:
+                if (!parseDouble(lit, in.doubleValue)) {
+                    error = "\"" + lit + "\" 不是数字";
+                    return false;
+                }
+                switch (node.field) {
+                    case Field::Salary: in.kernel = pick<double, &ColumnSnapshot::salary>(node.op); break;
+                    case Field::Sales: in.kernel = pick<double, &ColumnSnapshot::sales>(node.op); break;
+                    case Field::Rate: in.kernel = pick<double, &ColumnSnapshot::rate>(node.op); break;
+                    case Field::Hours: in.kernel = pick<double, &ColumnSnapshot::hours>(node.op); break;
+                    default: in.kernel = pick<double, &ColumnSnapshot::base>(node.op); break;
+                }
+                return true;
+        }
+        return false;
+    }
+
+    // 岗位字面量：英文岗位名或新增员工菜单中的中文名
+    static uint8_t roleLiteral(const std::string& lit) {
+        return roles::codeFromLiteral(lit);
+    }
+
+    static bool parseInt(const std::string& s, int32_t& out) {
+        if (s.empty()) return false;
+        errno = 0;
+        char* end = nullptr;
+        long v = std::strtol(s.c_str(), &end, 10);
+        if (*end != '\0' || errno == ERANGE || v < INT32_MIN || v > INT32_MAX) return false;
+        out = static_cast<int32_t>(v);
+        return true;
+    }
+
+    static bool parseDouble(const std::string& s, double& out) {
+        if (s.empty()) return false;
+        char* end = nullptr;
+        out = std::strtod(s.c_str(), &end);
+        return *end == '\0';
+    }
+};
+
+} // namespace query
+
+#endif // QUERY_H
@@ -0,0 +1,629 @@
+#ifndef REPORTINGINDEX_H
+#define REPORTINGINDEX_H
+
+#include <vector>
+#include <queue>
+#include <cstdint>
+#include <algorithm>
+#include <unordered_map>
+
+#include "Employee.h"
+
+/**
+ * 汇报关系索引 (ReportingIndex)
+ * - 员工按上级编号组成森林；上级为 0、不在花名册中或会形成环时暂按最高层处理
+ *   （缺席的上级之后加入时自动挂回，环被打破后也会重新挂回）
+ * - 欧拉序：每名员工对应“进入”“离开”两个记号，某人的全部下属（递归）恰好位于其两个记号之间
+ * - 记号序列存放在以位置为隐式键的 Treap 中，结点带父指针并汇总子树的记号数、月薪合计与最高月薪：
+ *   下属人数与月薪合计、单人月薪变化均为期望 O(log n)；更换上级时把整段记号剪下、接到新上级之下，
+ *   同样为期望 O(log n)，与下属人数和汇报链深度无关
+ * - 下属中月薪最高的 k 人：把区间分解为 O(log n) 棵完整子树，按子树最高月薪做最佳优先展开，
+ *   期望 O((k + log n) log n)；顺序与业绩排名一致（月薪从高到低，同薪按编号从小到大）
+ * - 构建与查询都不递归遍历组织树，百万级员工、任意深的汇报链都不会耗尽栈
+ * - 由 EmployeeManager 在增删改时同步维护；查询只读，可在读锁下并发执行
+ */
+class ReportingIndex {
+public:
+    // 某人全部下属（不含本人）的汇总
+    struct Totals {
+        size_t headcount = 0;
+        double payroll = 0.0;
+    };
+
+    struct Entry {
+        int id;
+        double salary;
+    };
+
+    size_t size() const { return count_; }
+    bool contains(int id) const { return slotOf(id) != kNoSlot; }
+
+    void clear() {
+        nodes_.assign(1, Node());
+        people_.clear();
+        freeSlots_.clear();
+        denseSlot_.clear();
+        sparseSlot_.clear();
+        count_ = 0;
+        waiting_.clear();
+        detached_.clear();
+        root_ = kNil;
+    }
+
+    // 按给定顺序重建（同一上级的直接下属按此顺序排列；编号须互不相同）
+    void build(const std::vector<const Employee*>& employees) {
+        clear();
+        size_t n = employees.size();
+        people_.resize(n);
+        nodes_.resize(2 * n + 1);
+        denseSlot_.assign(std::min<size_t>(kMaxDense, std::max<size_t>(kMinDense, 2 * n + 1)), kNoSlot);
+        for (uint32_t s = 0; s < n; ++s) {
+            const Employee& emp = *employees[s];
+            people_[s] = Person{emp.getId(), emp.getManagerId(), kNoSlot, emp.calculateSalary()};
+            bindSlot(people_[s].id, s);
+        }
+        for (size_t t = 1; t < nodes_.size(); ++t) nodes_[t].priority = nextPriority();
+
+        std::vector<uint32_t> tour = eulerTour();
+
+        // 单调栈在 O(n) 内建出满足堆序的 Treap（与 OrderStatisticTree::build 相同），再补父指针
+        std::vector<uint32_t> spine;
+        for (uint32_t t : tour) {
+            nodes_[t].size = 1;
+            uint32_t last = kNil;
+            while (!spine.empty() && nodes_[spine.back()].priority < nodes_[t].priority) {
+                last = spine.back();
+                spine.pop_back();
+                update(last);
+            }
+            nodes_[t].left = last;
+            if (!spine.empty()) nodes_[spine.back()].right = t;
+            spine.push_back(t);
+        }
+        root_ = spine.empty() ? kNil : spine.front();
+        while (!spine.empty()) {
+            update(spine.back());
+            spine.pop_back();
+        }
+        for (uint32_t t : tour) {
+            if (nodes_[t].left != kNil) nodes_[nodes_[t].left].parent = t;
+            if (nodes_[t].right != kNil) nodes_[nodes_[t].right].parent = t;
+        }
+    }
+
+    // 新增或更新一名员工：月薪变化只更新一条路径，上级变化时连同全部下属整体移动
+    void set(int id, int manager, double salary) {
+        uint32_t slot = slotOf(id);
+        if (slot == kNoSlot) {
+            insert(id, manager, salary);
+            return;
+        }
+        Person& p = people_[slot];
+        if (p.salary != salary) {
+            p.salary = salary;
+            refresh(enterOf(slot));
+        }
+        if (p.manager != manager) {
+            p.manager = manager;
+            relink(slot);
+            retryDetached();
+        }
+    }
+
+    // 删除一名员工：其直接下属（连同各自的下属）改挂到其上级之下（无上级时成为最高层）。
+    // 返回这些直接下属的编号，heir 置为他们的新上级编号（0 表示无上级）
+    std::vector<int> erase(int id, int* heir = nullptr) {
+        std::vector<int> reports;
+        uint32_t slot = slotOf(id);
+        if (slot == kNoSlot) return reports;
+        uint32_t parent = people_[slot].parent;
+        int newManager = parent == kNoSlot ? 0 : people_[parent].id;
+
+        forEachChild(slot, [&](uint32_t child) {
+            reports.push_back(people_[child].id);
+            people_[child].parent = parent;
+            people_[child].manager = newManager;
+        });
+        removeToken(enterOf(slot));
+        removeToken(exitOf(slot));
+        bindSlot(id, kNoSlot);
+        people_[slot] = Person();
+        freeSlots_.push_back(slot);
+        retryDetached();
+
+        if (heir) *heir = newManager;
+        return reports;
+    }
+
+    // 实际挂靠的上级编号（0 表示最高层，包括上级缺席或会形成环的情况）
+    int managerOf(int id) const {
+        uint32_t slot = slotOf(id);
+        if (slot == kNoSlot || people_[slot].parent == kNoSlot) return 0;
+        return people_[people_[slot].parent].id;
+    }
+
+    // id 是否为 ancestor 本人或其（递归）下属
+    bool isWithin(int id, int ancestor) const {
+        uint32_t a = slotOf(id), b = slotOf(ancestor);
+        return a != kNoSlot && b != kNoSlot && within(a, b);
+    }
+
+    // id 能否改为向 manager 汇报：manager 为 0，或存在、不是本人且不是其下属（id 尚不存在时只要求 manager 存在）
+    bool canReportTo(int id, int manager) const {
+        if (manager == 0) return true;
+        uint32_t m = slotOf(manager);
+        if (m == kNoSlot || manager == id) return false;
+        uint32_t s = slotOf(id);
+        return s == kNoSlot || !within(m, s);
+    }
+
+    // 全部下属（递归，不含本人）的人数与月薪合计
+    Totals totals(int id) const {
+        Totals out;
+        uint32_t slot = slotOf(id);
+        if (slot == kNoSlot) return out;
+        size_t first = position(enterOf(slot)), last = position(exitOf(slot));
+        out.headcount = (last - first - 1) / 2;
+        if (out.headcount) {
+            forEachPiece(first + 1, last - 1, [&](uint32_t t, bool whole) {
+                out.payroll += whole ? nodes_[t].sum : valueOf(t);
+            });
+        }
+        return out;
+    }
+
+    // 全部下属（递归，不含本人）中月薪最高的 k 人
+    std::vector<Entry> topReports(int id, size_t k) const {
+        std::vector<Entry> out;
+        uint32_t slot = slotOf(id);
+        if (slot == kNoSlot || k == 0) return out;
+        size_t first = position(enterOf(slot)), last = position(exitOf(slot));
+        if (last == first + 1) return out;
+
+        struct Candidate {
+            uint32_t node;
+            bool whole;  // true 表示整棵子树，否则只是结点本身
+            int id;
+            double salary;
+        };
+        auto lower = [](const Candidate& a, const Candidate& b) { return ranksAbove(b.salary, b.id, a.salary, a.id); };
+        std::priority_queue<Candidate, std::vector<Candidate>, decltype(lower)> heap(lower);
+        auto push = [&](uint32_t t, bool whole) {
+            if (t == kNil) return;
+            if (whole && nodes_[t].top != kNoSlot) {
+                const Person& p = people_[nodes_[t].top];
+                heap.push(Candidate{t, true, p.id, p.salary});
+            } else if (!whole && isEnter(t)) {
+                const Person& p = people_[slotOfNode(t)];
+                heap.push(Candidate{t, false, p.id, p.salary});
+            }
+        };
+        forEachPiece(first + 1, last - 1, push);
+        while (!heap.empty() && out.size() < k) {
+            Candidate c = heap.top();
+            heap.pop();
+            if (!c.whole) {
+                out.push_back(Entry{c.id, c.salary});
+                continue;
+            }
+            push(nodes_[c.node].left, true);
+            push(c.node, false);
+            push(nodes_[c.node].right, true);
+        }
+        return out;
+    }
+
+    // 按顺序访问直接下属的编号，O(直接下属数 * log n)
+    template <typename Fn>
+    void forEachDirectReport(int id, Fn fn) const {
+        uint32_t slot = slotOf(id);
+        if (slot == kNoSlot) return;
+        forEachChild(slot, [&](uint32_t child) { fn(people_[child].id); });
+    }
+
+    // 登记了上级、但上级缺席或会形成环而按最高层处理的人数（O(n)，用于提示）
+    size_t unresolved() const {
+        size_t count = 0;
+        for (const Person& p : people_) {
+            if (p.id == 0 || p.manager == 0) continue;
+            if (p.parent == kNoSlot || people_[p.parent].id != p.manager) ++count;
+        }
+        return count;
+    }
+
+private:
+    static constexpr uint32_t kNil = 0;              // 0 号结点为哨兵，size 恒为 0
+    static constexpr uint32_t kNoSlot = 0xffffffffu;  // 无上级
+
+    struct Node {
+        uint32_t left = kNil;
+        uint32_t right = kNil;
+        uint32_t parent = kNil;
+        uint32_t priority = 0;
+        uint32_t size = 0;       // 子树中的记号数
+        uint32_t top = kNoSlot;  // 子树中排名最前者的槽位，子树中没有进入记号时为 kNoSlot
+        double sum = 0.0;        // 子树中进入记号的月薪合计
+    };
+
+    // 员工占一个槽位，进入、离开记号分别为 2 * slot + 1、2 * slot + 2 号结点
+    struct Person {
+        int id = 0;
+        int manager = 0;           // 登记的上级编号
+        uint32_t parent = kNoSlot; // 实际挂靠的上级槽位
+        double salary = 0.0;
+    };
+
+    std::vector<Node> nodes_ = std::vector<Node>(1);
+    std::vector<Person> people_;
+    std::vector<uint32_t> freeSlots_;
+    // 编号 -> 槽位：构建时按人数定出一段稠密编号区间直接下标存放，区间外的编号放散列表
+    static constexpr size_t kMinDense = 1 << 16;
+    static constexpr size_t kMaxDense = 1 << 24;
+    std::vector<uint32_t> denseSlot_;
+    std::unordered_map<int, uint32_t> sparseSlot_;
+    size_t count_ = 0;
+    std::unordered_map<int, std::vector<int>> waiting_;  // 缺席的上级编号 -> 等待其加入的员工（可能含过期项）
+    std::vector<int> detached_;                          // 因会形成环而按最高层处理的员工（可能含过期项）
+    uint32_t root_ = kNil;
+    uint64_t seed_ = 0x9E3779B97F4A7C15ULL;
+
+    uint32_t slotOf(int id) const {
+        if (id > 0 && static_cast<size_t>(id) < denseSlot_.size()) return denseSlot_[id];
+        auto it = sparseSlot_.find(id);
+        return it == sparseSlot_.end() ? kNoSlot : it->second;
+    }
+
+    // 登记编号的槽位，slot 为 kNoSlot 时注销
+    void bindSlot(int id, uint32_t slot) {
+        bool dense = id > 0 && static_cast<size_t>(id) < denseSlot_.size();
+        bool present = slotOf(id) != kNoSlot;
+        if (slot == kNoSlot) {
+            if (present) --count_;
+            if (dense) denseSlot_[id] = kNoSlot;
+            else sparseSlot_.erase(id);
+            return;
+        }
+        if (!present) ++count_;
+        if (dense) denseSlot_[id] = slot;
+        else sparseSlot_[id] = slot;
+    }
+
+    static uint32_t enterOf(uint32_t slot) { return 2 * slot + 1; }
+    static uint32_t exitOf(uint32_t slot) { return 2 * slot + 2; }
+    static bool isEnter(uint32_t node) { return (node & 1) != 0; }
+    static uint32_t slotOfNode(uint32_t node) { return (node - 1) / 2; }
+
+    // 排名规则：月薪高者在前，同薪编号小者在前
+    static bool ranksAbove(double salary, int id, double otherSalary, int otherId) {
+        return salary > otherSalary || (salary == otherSalary && id < otherId);
+    }
+
+    bool outranks(uint32_t a, uint32_t b) const {
+        return ranksAbove(people_[a].salary, people_[a].id, people_[b].salary, people_[b].id);
+    }
+
+    double valueOf(uint32_t t) const { return isEnter(t) ? people_[slotOfNode(t)].salary : 0.0; }
+
+    uint32_t nextPriority() {
+        seed_ ^= seed_ << 13;
+        seed_ ^= seed_ >> 7;
+        seed_ ^= seed_ << 17;
+        return static_cast<uint32_t>(seed_ >> 32);
+    }
+
+    void update(uint32_t t) {
+        Node& n = nodes_[t];
+        const Node& l = nodes_[n.left];
+        const Node& r = nodes_[n.right];
+        n.size = l.size + r.size + 1;
+        n.sum = l.sum + valueOf(t) + r.sum;
+        n.top = kNoSlot;
+        auto offer = [&](uint32_t slot) {
+            if (slot != kNoSlot && (n.top == kNoSlot || outranks(slot, n.top))) n.top = slot;
+        };
+        offer(l.top);
+        if (isEnter(t)) offer(slotOfNode(t));
+        offer(r.top);
+    }
+
+    // 结点值变化后沿父指针更新到根
+    void refresh(uint32_t t) {
+        for (; t != kNil; t = nodes_[t].parent) update(t);
+    }
+
+    void link(uint32_t parent, uint32_t child, bool left) {
+        (left ? nodes_[parent].left : nodes_[parent].right) = child;
+        if (child != kNil) nodes_[child].parent = parent;
+    }
+
+    void setRoot(uint32_t t) {
+        root_ = t;
+        if (t != kNil) nodes_[t].parent = kNil;
+    }
+
+    // 结点在记号序列中的位置（从 0 开始）
+    size_t position(uint32_t t) const {
+        size_t pos = nodes_[nodes_[t].left].size;
+        for (uint32_t p = nodes_[t].parent; p != kNil; t = p, p = nodes_[p].parent) {
+            if (nodes_[p].right == t) pos += nodes_[nodes_[p].left].size + 1;
+        }
+        return pos;
+    }
+
+    // 序列中的下一个记号，没有时返回 kNil
+    uint32_t successor(uint32_t t) const {
+        if (nodes_[t].right != kNil) {
+            t = nodes_[t].right;
+            while (nodes_[t].left != kNil) t = nodes_[t].left;
+            return t;
+        }
+        uint32_t p = nodes_[t].parent;
+        while (p != kNil && nodes_[p].right == t) {
+            t = p;
+            p = nodes_[p].parent;
+        }
+        return p;
+    }
+
+    // 槽位 a 是否为槽位 b 本人或其（递归）下属
+    bool within(uint32_t a, uint32_t b) const {
+        size_t p = position(enterOf(a));
+        return position(enterOf(b)) <= p && p <= position(exitOf(b));
+    }
+
+    // 直接下属：从进入记号之后开始，每遇到一个下属的进入记号就跳到其离开记号之后
+    template <typename Fn>
+    void forEachChild(uint32_t slot, Fn fn) const {
+        uint32_t stop = exitOf(slot);
+        for (uint32_t t = successor(enterOf(slot)); t != stop && t != kNil;) {
+            uint32_t child = slotOfNode(t);
+            fn(child);
+            t = successor(exitOf(child));
+        }
+    }
+
+    // 把位置区间 [lo, hi] 分解为完整子树 (whole = true) 与单个结点
+    template <typename Fn>
+    void forEachPiece(size_t lo, size_t hi, Fn fn) const {
+        pieces(root_, 0, lo, hi, fn);
+    }
+
+    template <typename Fn>
+    void pieces(uint32_t t, size_t offset, size_t lo, size_t hi, Fn& fn) const {
+        if (t == kNil) return;
+        size_t end = offset + nodes_[t].size;
+        if (end <= lo || offset > hi) return;
+        if (lo <= offset && end - 1 <= hi) {
+            fn(t, true);
+            return;
+        }
+        size_t self = offset + nodes_[nodes_[t].left].size;
+        pieces(nodes_[t].left, offset, lo, hi, fn);
+        if (self >= lo && self <= hi) fn(t, false);
+        pieces(nodes_[t].right, self + 1, lo, hi, fn);
+    }
+
+    // 前 k 个记号分到 l，其余分到 r（两棵结果树的根的父指针由调用方清空）
+    void split(uint32_t t, size_t k, uint32_t& l, uint32_t& r) {
+        if (t == kNil) {
+            l = r = kNil;
+            return;
+        }
+        size_t leftSize = nodes_[nodes_[t].left].size;
+        uint32_t a, b;
+        if (k <= leftSize) {
+            split(nodes_[t].left, k, a, b);
+            link(t, b, true);
+            l = a;
+            r = t;
+        } else {
+            split(nodes_[t].right, k - leftSize - 1, a, b);
+            link(t, a, false);
+            l = t;
+            r = b;
+        }
+        update(t);
+    }
+
+    void splitAt(uint32_t t, size_t k, uint32_t& l, uint32_t& r) {
+        split(t, k, l, r);
+        if (l != kNil) nodes_[l].parent = kNil;
+        if (r != kNil) nodes_[r].parent = kNil;
+    }
+
+    uint32_t merge(uint32_t l, uint32_t r) {
+        if (l == kNil) return r;
+        if (r == kNil) return l;
+        if (nodes_[l].priority > nodes_[r].priority) {
+            link(l, merge(nodes_[l].right, r), false);
+            update(l);
+            return l;
+        }
+        link(r, merge(l, nodes_[r].left), true);
+        update(r);
+        return r;
+    }
+
+    // 从序列中剪下位置 [first, last] 的记号，返回剪下的子树
+    uint32_t cut(size_t first, size_t last) {
+        uint32_t l, m, r;
+        splitAt(root_, first, l, m);
+        splitAt(m, last - first + 1, m, r);
+        setRoot(merge(l, r));
+        return m;
+    }
+
+    // 把记号子树插入到位置 at 之前
+    void paste(uint32_t seq, size_t at) {
+        uint32_t l, r;
+        splitAt(root_, at, l, r);
+        setRoot(merge(merge(l, seq), r));
+    }
+
+    void removeToken(uint32_t t) {
+        size_t pos = position(t);
+        cut(pos, pos);
+        uint32_t priority = nodes_[t].priority;
+        nodes_[t] = Node();
+        nodes_[t].priority = priority;
+    }
+
+    // 按登记的上级生成全部员工的欧拉序（显式栈，不递归），同时确定实际挂靠的上级；
+    // 上级缺席的登记到 waiting_，为打破环而断开的登记到 detached_
+    std::vector<uint32_t> eulerTour() {
+        size_t n = people_.size();
+        // 登记的上级 -> 候选父结点；不存在的上级与自指在此登记
+        std::vector<uint32_t> parent(n, kNoSlot);
+        for (uint32_t s = 0; s < n; ++s) {
+            const Person& p = people_[s];
+            if (p.manager == 0) continue;
+            uint32_t m = slotOf(p.manager);
+            if (m == kNoSlot) waiting_[p.manager].push_back(p.id);
+            else if (m == s) detached_.push_back(p.id);
+            else parent[s] = m;
+        }
+
+        // 直接下属按父结点分组（CSR），组内保持给定顺序
+        std::vector<uint32_t> start(n + 1, 0), children(n);
+        for (uint32_t s = 0; s < n; ++s) {
+            if (parent[s] != kNoSlot) ++start[parent[s] + 1];
+        }
+        for (size_t s = 0; s < n; ++s) start[s + 1] += start[s];
+        std::vector<uint32_t> cursor(start.begin(), start.end() - 1);
+        for (uint32_t s = 0; s < n; ++s) {
+            if (parent[s] != kNoSlot) children[cursor[parent[s]]++] = s;
+        }
+
+        // 显式栈深度优先遍历，生成欧拉序
+        std::vector<uint32_t> tour;
+        tour.reserve(2 * n);
+        std::vector<uint8_t> visited(n, 0);
+        struct Frame {
+            uint32_t slot;
+            uint32_t next;
+        };
+        std::vector<Frame> stack;
+        auto walk = [&](uint32_t top) {
+            visited[top] = 1;
+            tour.push_back(enterOf(top));
+            stack.push_back(Frame{top, start[top]});
+            while (!stack.empty()) {
+                Frame& f = stack.back();
+                if (f.next == start[f.slot + 1]) {
+                    tour.push_back(exitOf(f.slot));
+                    stack.pop_back();
+                    continue;
+                }
+                uint32_t c = children[f.next++];
+                if (visited[c] || parent[c] != f.slot) continue;  // 为打破环而断开的边
+                visited[c] = 1;
+                people_[c].parent = f.slot;
+                tour.push_back(enterOf(c));
+                stack.push_back(Frame{c, start[c]});
+            }
+        };
+        for (uint32_t s = 0; s < n; ++s) {
+            if (parent[s] == kNoSlot) walk(s);
+        }
+
+        // 剩下的员工所在的连通块各含一个环：沿上级找到环上的一人，断开其上级边后从他开始遍历
+        std::vector<uint32_t> mark(n, kNoSlot);
+        for (uint32_t s = 0; s < n; ++s) {
+            if (visited[s]) continue;
+            uint32_t c = s;
+            while (mark[c] != s) {
+                mark[c] = s;
+                c = parent[c];
+            }
+            parent[c] = kNoSlot;
+            detached_.push_back(people_[c].id);
+            walk(c);
+        }
+
+        return tour;
+    }
+
+    // 子树插入位置：上级的离开记号之前（成为最后一个直接下属），最高层接在序列末尾
+    size_t insertionPoint(uint32_t parent) const {
+        return parent == kNoSlot ? nodes_[root_].size : position(exitOf(parent));
+    }
+
+    // 由登记的上级确定挂靠的槽位；上级缺席时登记到 waiting_，会形成环时登记到 detached_，二者都挂到最高层
+    uint32_t resolve(uint32_t slot, bool placed) {
+        const Person& p = people_[slot];
+        if (p.manager == 0) return kNoSlot;
+        uint32_t m = slotOf(p.manager);
+        if (m == kNoSlot) {
+            waiting_[p.manager].push_back(p.id);
+            return kNoSlot;
+        }
+        if (m == slot || (placed && within(m, slot))) {
+            detached_.push_back(p.id);
+            return kNoSlot;
+        }
+        return m;
+    }
+
+    void insert(int id, int manager, double salary) {
+        uint32_t slot;
+        if (!freeSlots_.empty()) {
+            slot = freeSlots_.back();
+            freeSlots_.pop_back();
+        } else {
+            slot = static_cast<uint32_t>(people_.size());
+            people_.emplace_back();
+            nodes_.resize(nodes_.size() + 2);
+        }
+        people_[slot] = Person{id, manager, kNoSlot, salary};
+        bindSlot(id, slot);
+        for (uint32_t t : {enterOf(slot), exitOf(slot)}) {
+            uint32_t priority = nextPriority();
+            nodes_[t] = Node();
+            nodes_[t].priority = priority;
+            update(t);
+        }
+
+        uint32_t parent = resolve(slot, false);
+        people_[slot].parent = parent;
+        paste(merge(enterOf(slot), exitOf(slot)), insertionPoint(parent));
+        adopt(id);
+    }
+
+    // 按登记的上级重新挂靠：挂靠位置变化时把本人连同全部下属的记号整段移动
+    void relink(uint32_t slot) {
+        uint32_t parent = resolve(slot, true);
+        if (parent == people_[slot].parent) return;
+        uint32_t seq = cut(position(enterOf(slot)), position(exitOf(slot)));
+        people_[slot].parent = parent;
+        paste(seq, insertionPoint(parent));
+    }
+
+    // 新加入的 id 接收此前等待它的下属
+    void adopt(int id) {
+        auto it = waiting_.find(id);
+        if (it == waiting_.end()) return;
+        std::vector<int> ids = std::move(it->second);
+        waiting_.erase(it);
+        for (int report : ids) {
+            uint32_t s = slotOf(report);
+            if (s == kNoSlot) continue;
+            const Person& p = people_[s];
+            if (p.manager == id && p.parent == kNoSlot) relink(s);
+        }
+    }
+
+    // 汇报关系变化后，重试因成环而按最高层处理的员工
+    void retryDetached() {
+        if (detached_.empty()) return;
+        std::vector<int> ids;
+        ids.swap(detached_);
+        for (int id : ids) {
+            uint32_t s = slotOf(id);
+            if (s == kNoSlot) continue;
+            const Person& p = people_[s];
+            if (p.manager != 0 && p.parent == kNoSlot) relink(s);
+        }
+    }
+};
+
+#endif // REPORTINGINDEX_H
@@ -0,0 +1,357 @@
+#ifndef ROARINGBITMAP_H
+#define ROARINGBITMAP_H
+
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include <iterator>
+
+#include "BitOps.h"
+
+/**
+ * 压缩位图 (RoaringBitmap)
+ * - 32 位整数集合，按高 16 位分块，每块一个容器：
+ *     元素不超过 4096 个时为有序 uint16 数组（稀疏），否则为 65536 位的位图（稠密）
+ * - 增删时在两种容器间自动转换，集合基数随时维护，count() 为 O(1)
+ * - 多个位图的交集基数 andCardinality() 只按块逐字计数，不生成中间结果
+ */
+class RoaringBitmap {
+public:
+    static constexpr uint32_t kArrayMax = 4096;
+    static constexpr size_t kBitmapWords = 65536 / 64;
+
+    bool add(uint32_t x) {
+        Container& c = containerFor(static_cast<uint16_t>(x >> 16));
+        if (!c.insert(static_cast<uint16_t>(x))) return false;
+        ++cardinality_;
+        return true;
+    }
+
+    bool remove(uint32_t x) {
+        auto it = find(static_cast<uint16_t>(x >> 16));
+        if (it == containers_.end() || !it->erase(static_cast<uint16_t>(x))) return false;
+        --cardinality_;
+        if (it->card == 0) containers_.erase(it);
+        return true;
+    }
+
+    bool contains(uint32_t x) const {
+        auto it = find(static_cast<uint16_t>(x >> 16));
+        return it != containers_.end() && it->contains(static_cast<uint16_t>(x));
+    }
+
+    uint64_t count() const { return cardinality_; }
+    bool empty() const { return cardinality_ == 0; }
+
+    void clear() {
+        containers_.clear();
+        cardinality_ = 0;
+    }
+
+    // 按升序遍历所有元素
+    template <typename Fn>
+    void forEach(Fn fn) const {
+        for (const Container& c : containers_) {
+            uint32_t high = static_cast<uint32_t>(c.key) << 16;
+            if (c.bitmap()) {
+                for (size_t w = 0; w < kBitmapWords; ++w) {
+                    uint64_t bits = c.bits[w];
+                    while (bits) {
+                        fn(high | static_cast<uint32_t>(w * 64 + bitops::countTrailingZeros64(bits)));
+                        bits &= bits - 1;
+                    }
+                }
+            } else {
+                for (uint16_t low : c.array) fn(high | low);
+            }
+        }
+    }
+
+    // 多个位图的并集：每个块只合并、计数一次
+    static RoaringBitmap unite(const std::vector<const RoaringBitmap*>& sets) {
+        std::vector<const Container*> all;
+        for (const RoaringBitmap* b : sets) {
+            for (const Container& c : b->containers_) all.push_back(&c);
+        }
+        std::stable_sort(all.begin(), all.end(),
+                         [](const Container* a, const Container* b) { return a->key < b->key; });
+
+        RoaringBitmap result;
+        for (size_t i = 0; i < all.size();) {
+            size_t j = i;
+            uint64_t total = 0;
+            while (j < all.size() && all[j]->key == all[i]->key) total += all[j++]->card;
+
+            Container out;
+            out.key = all[i]->key;
+            if (j - i == 1) {
+                out = *all[i];
+            } else if (total <= kArrayMax) {
+                for (size_t k = i; k < j; ++k) out.array.insert(out.array.end(), all[k]->array.begin(), all[k]->array.end());
+                std::sort(out.array.begin(), out.array.end());
+                out.array.erase(std::unique(out.array.begin(), out.array.end()), out.array.end());
+                out.card = static_cast<uint32_t>(out.array.size());
+            } else {
+                out.bits.assign(kBitmapWords, 0);
+                for (size_t k = i; k < j; ++k) out.orInto(out.bits.data(), *all[k]);
+                for (uint64_t w : out.bits) out.card += static_cast<uint32_t>(bitops::popcount64(w));
+                if (out.card <= kArrayMax) out.toArray();
+            }
+            result.cardinality_ += out.card;
+            result.containers_.push_back(std::move(out));
+            i = j;
+        }
+        return result;
+    }
+
+    // 多个位图的交集
+    static RoaringBitmap intersect(const std::vector<const RoaringBitmap*>& sets) {
+        RoaringBitmap result;
+        forEachCommonKey(sets, [&](const std::vector<const Container*>& parts) {
+            Container c = Container::intersect(parts);
+            if (c.card == 0) return;
+            result.cardinality_ += c.card;
+            result.containers_.push_back(std::move(c));
+        });
+        return result;
+    }
+
+    // 多个位图交集的基数（不生成交集）
+    static uint64_t andCardinality(const std::vector<const RoaringBitmap*>& sets) {
+        if (sets.empty()) return 0;
+        if (sets.size() == 1) return sets[0]->count();
+        uint64_t total = 0;
+        forEachCommonKey(sets, [&](const std::vector<const Container*>& parts) {
+            total += Container::intersectCount(parts);
+        });
+        return total;
+    }
+
+    size_t memoryBytes() const {
+        size_t bytes = sizeof(*this) + containers_.capacity() * sizeof(Container);
+        for (const Container& c : containers_) {
+            bytes += c.array.capacity() * sizeof(uint16_t) + c.bits.capacity() * sizeof(uint64_t);
+        }
+        return bytes;
+    }
+
+private:
+    struct Container {
+        uint16_t key = 0;
+        uint32_t card = 0;
+        std::vector<uint16_t> array;  // 稀疏：有序数组
+        std::vector<uint64_t> bits;   // 稠密：位图（非空时使用）
+
+        bool bitmap() const { return !bits.empty(); }
+
+        bool contains(uint16_t v) const {
+            if (bitmap()) return (bits[v >> 6] >> (v & 63)) & 1;
+            return std::binary_search(array.begin(), array.end(), v);
+        }
+
+        bool insert(uint16_t v) {
+            if (bitmap()) {
+                uint64_t mask = uint64_t(1) << (v & 63);
+                if (bits[v >> 6] & mask) return false;
+                bits[v >> 6] |= mask;
+                ++card;
+                return true;
+            }
+            auto it = std::lower_bound(array.begin(), array.end(), v);
+            if (it != array.end() && *it == v) return false;
+            array.insert(it, v);
+            ++card;
+            if (card > kArrayMax) toBitmap();
+            return true;
+        }
+
+        bool erase(uint16_t v) {
+            if (bitmap()) {
+                uint64_t mask = uint64_t(1) << (v & 63);
+                if (!(bits[v >> 6] & mask)) return false;
+                bits[v >> 6] &= ~mask;
+                --card;
+                if (card <= kArrayMax) toArray();
+                return true;
+            }
+            auto it = std::lower_bound(array.begin(), array.end(), v);
+            if (it == array.end() || *it != v) return false;
+            array.erase(it);
+            --card;
+            return true;
+        }
+
+        void toBitmap() {
+            bits.assign(kBitmapWords, 0);
+            for (uint16_t v : array) bits[v >> 6] |= uint64_t(1) << (v & 63);
+            std::vector<uint16_t>().swap(array);
+        }
+
+        void toArray() {
+            array.clear();
+            array.reserve(card);
+            for (size_t w = 0; w < kBitmapWords; ++w) {
+                uint64_t b = bits[w];
+                while (b) {
+                    array.push_back(static_cast<uint16_t>(w * 64 + bitops::countTrailingZeros64(b)));
+                    b &= b - 1;
+                }
+            }
+            std::vector<uint64_t>().swap(bits);
+        }
+
+        static void orInto(uint64_t* words, const Container& c) {
+            if (c.bitmap()) {
+                for (size_t w = 0; w < kBitmapWords; ++w) words[w] |= c.bits[w];
+            } else {
+                for (uint16_t v : c.array) words[v >> 6] |= uint64_t(1) << (v & 63);
+            }
+        }
+
+
+        // 多个容器的交集：有数组容器时以最小的数组为基准逐个探测，否则逐字按位与
+        static Container intersect(const std::vector<const Container*>& parts) {
+            Container out;
+            out.key = parts[0]->key;
+            const Container* smallest = smallestArray(parts);
+            if (smallest) {
+                out.array = intersectArrays(parts, smallest);
+                out.card = static_cast<uint32_t>(out.array.size());
+                return out;
+            }
+            out.bits.resize(kBitmapWords);
+            out.card = static_cast<uint32_t>(andWords(parts, out.bits.data()));
+            if (out.card <= kArrayMax) out.toArray();
+            return out;
+        }
+
+        static uint64_t intersectCount(const std::vector<const Container*>& parts) {
+            const Container* smallest = smallestArray(parts);
+            uint64_t n = 0;
+            if (smallest) {
+                if (allOthersBitmap(parts, smallest) && parts.size() <= 4) {
+                    // 其余容器均为位图：取出裸指针后无分支探测
+                    const uint64_t* others[3];
+                    size_t k = 0;
+                    for (const Container* c : parts) {
+                        if (c != smallest) others[k++] = c->bits.data();
+                    }
+                    for (size_t i = k; i < 3; ++i) others[i] = others[0];
+                    for (uint16_t v : smallest->array) {
+                        size_t w = v >> 6, shift = v & 63;
+                        n += (others[0][w] & others[1][w] & others[2][w]) >> shift & 1;
+                    }
+                    return n;
+                }
+                return intersectArrays(parts, smallest).size();
+            }
+            uint64_t words[kBitmapWords];
+            return andWords(parts, words);
+        }
+
+        // 全部为位图容器时逐字按位与写入 out，返回结果基数；每趟只处理两个数组，便于编译器向量化
+        static uint64_t andWords(const std::vector<const Container*>& parts, uint64_t* out) {
+            const uint64_t* a = parts[0]->bits.data();
+            const uint64_t* b = parts.size() > 1 ? parts[1]->bits.data() : a;
+            for (size_t w = 0; w < kBitmapWords; ++w) out[w] = a[w] & b[w];
+            for (size_t i = 2; i < parts.size(); ++i) {
+                const uint64_t* c = parts[i]->bits.data();
+                for (size_t w = 0; w < kBitmapWords; ++w) out[w] &= c[w];
+            }
+            uint64_t n = 0;
+            for (size_t w = 0; w < kBitmapWords; ++w) n += static_cast<uint64_t>(bitops::popcount64(out[w]));
+            return n;
+        }
+
+        static const Container* smallestArray(const std::vector<const Container*>& parts) {
+            const Container* best = nullptr;
+            for (const Container* c : parts) {
+                if (!c->bitmap() && (!best || c->card < best->card)) best = c;
+            }
+            return best;
+        }
+
+        static bool allOthersBitmap(const std::vector<const Container*>& parts, const Container* skip) {
+            for (const Container* c : parts) {
+                if (c != skip && !c->bitmap()) return false;
+            }
+            return true;
+        }
+
+        // 以最小的数组容器为起点：先与其余数组线性归并求交，再按位图过滤
+        static std::vector<uint16_t> intersectArrays(const std::vector<const Container*>& parts,
+                                                     const Container* smallest) {
+            std::vector<uint16_t> result = smallest->array, merged;
+            for (const Container* c : parts) {
+                if (c == smallest || c->bitmap()) continue;
+                merged.clear();
+                std::set_intersection(result.begin(), result.end(), c->array.begin(), c->array.end(),
+                                      std::back_inserter(merged));
+                result.swap(merged);
+            }
+            for (const Container* c : parts) {
+                if (!c->bitmap()) continue;
+                size_t k = 0;
+                for (uint16_t v : result) {
+                    result[k] = v;
+                    k += (c->bits[v >> 6] >> (v & 63)) & 1;
+                }
+                result.resize(k);
+            }
+            return result;
+        }
+    };
+
+    std::vector<Container> containers_;  // 按 key 升序
+    uint64_t cardinality_ = 0;
+
+    std::vector<Container>::iterator find(uint16_t key) {
+        auto it = std::lower_bound(containers_.begin(), containers_.end(), key,
+                                   [](const Container& c, uint16_t k) { return c.key < k; });
+        return (it != containers_.end() && it->key == key) ? it : containers_.end();
+    }
+
+    std::vector<Container>::const_iterator find(uint16_t key) const {
+        auto it = std::lower_bound(containers_.begin(), containers_.end(), key,
+                                   [](const Container& c, uint16_t k) { return c.key < k; });
+        return (it != containers_.end() && it->key == key) ? it : containers_.end();
+    }
+
+    Container& containerFor(uint16_t key) {
+        auto it = std::lower_bound(containers_.begin(), containers_.end(), key,
+                                   [](const Container& c, uint16_t k) { return c.key < k; });
+        if (it == containers_.end() || it->key != key) {
+            it = containers_.insert(it, Container());
+            it->key = key;
+        }
+        return *it;
+    }
+
+    // 对所有位图都含有的每个块调用 fn(各位图在该块的容器)
+    template <typename Fn>
+    static void forEachCommonKey(const std::vector<const RoaringBitmap*>& sets, Fn fn) {
+        if (sets.empty()) return;
+        std::vector<size_t> pos(sets.size(), 0);
+        std::vector<const Container*> parts(sets.size());
+        while (true) {
+            // 取各位图当前块号的最大值，其余位图向前追赶
+            uint16_t key = 0;
+            for (size_t i = 0; i < sets.size(); ++i) {
+                if (pos[i] >= sets[i]->containers_.size()) return;
+                key = std::max(key, sets[i]->containers_[pos[i]].key);
+            }
+            bool aligned = true;
+            for (size_t i = 0; i < sets.size(); ++i) {
+                const auto& cs = sets[i]->containers_;
+                while (pos[i] < cs.size() && cs[pos[i]].key < key) ++pos[i];
+                if (pos[i] >= cs.size()) return;
+                if (cs[pos[i]].key != key) aligned = false;
+            }
+            if (!aligned) continue;
+            for (size_t i = 0; i < sets.size(); ++i) parts[i] = &sets[i]->containers_[pos[i]++];
+            fn(parts);
+        }
+    }
+};
+
+#endif // ROARINGBITMAP_H
@@ -0,0 +1,180 @@
+#ifndef ROLEREGISTRY_H
+#define ROLEREGISTRY_H
+
+#include <array>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <cstdint>
+#include <type_traits>
+
+#include "Employee.h"
+#include "Manager.h"
+#include "PartTimeTechnician.h"
+#include "SalesManager.h"
+#include "PartTimeSalesperson.h"
+
+/**
+ * 岗位登记表 (RoleRegistry)
+ * - 所有岗位类在 Registered 类型列表中登记一次，登记顺序即岗位编码
+ *   （ColumnSnapshot::RoleCode、各类按岗位分组的数组下标、新增员工菜单序号减一）
+ * - 工厂、岗位名 -> 编码、中文名称、JSON 参数字段、按参数列计算月薪等分派表均由类型列表在编译期生成
+ * - 岗位名查找用编译期求出的完美哈希：一次哈希 + 一次查表 + 一次字符串比较
+ * - 新增岗位只需实现岗位类（含 kRoleName、kParamKeys、kParamRanges 等登记信息与 salaryFromParams）并加入 Registered
+ */
+namespace roles {
+
+template <typename... Ts>
+struct TypeList {
+    static constexpr size_t size = sizeof...(Ts);
+};
+
+using Registered = TypeList<Manager, PartTimeTechnician, SalesManager, PartTimeSalesperson>;
+
+constexpr size_t kCount = Registered::size;
+constexpr uint8_t kUnknown = 255;
+
+namespace detail {
+
+template <typename T, typename List>
+struct IndexOf;
+
+template <typename T, typename... Ts>
+struct IndexOf<T, TypeList<T, Ts...>> : std::integral_constant<size_t, 0> {};
+
+template <typename T, typename U, typename... Ts>
+struct IndexOf<T, TypeList<U, Ts...>> : std::integral_constant<size_t, 1 + IndexOf<T, TypeList<Ts...>>::value> {};
+
+using Factory = std::unique_ptr<Employee> (*)();
+using SalaryFn = double (*)(double, double, double);
+using ParamKeys = std::array<const char*, 3>;
+using ParamRanges = std::array<ParamRange, 3>;
+
+template <typename T>
+std::unique_ptr<Employee> make() {
+    HR_METRIC_ADD(Allocations, 1);
+    return std::make_unique<T>();
+}
+
+template <typename List>
+struct Tables;
+
+template <typename... Ts>
+struct Tables<TypeList<Ts...>> {
+    static constexpr std::array<std::string_view, sizeof...(Ts)> names{{Ts::kRoleName...}};
+    static constexpr std::array<const char*, sizeof...(Ts)> labels{{Ts::kLabel...}};
+    static constexpr std::array<const char*, sizeof...(Ts)> fullLabels{{Ts::kFullLabel...}};
+    static constexpr std::array<const char*, sizeof...(Ts)> salaryHints{{Ts::kSalaryHint...}};
+    static constexpr std::array<ParamKeys, sizeof...(Ts)> paramKeys{{
+        ParamKeys{{Ts::kParamKeys[0], Ts::kParamKeys[1], Ts::kParamKeys[2]}}...}};
+    static constexpr std::array<ParamRanges, sizeof...(Ts)> paramRanges{{
+        ParamRanges{{Ts::kParamRanges[0], Ts::kParamRanges[1], Ts::kParamRanges[2]}}...}};
+    static constexpr std::array<Factory, sizeof...(Ts)> factories{{&make<Ts>...}};
+    static constexpr std::array<SalaryFn, sizeof...(Ts)> salaryFns{{&Ts::salaryFromParams...}};
+};
+
+using Table = Tables<Registered>;
+
+// 带种子的 FNV-1a
+constexpr uint32_t hash(std::string_view s, uint32_t seed) {
+    uint32_t h = 2166136261u ^ seed;
+    for (char c : s) h = (h ^ static_cast<unsigned char>(c)) * 16777619u;
+    return h;
+}
+
+// 槽位数取不小于 4 倍岗位数的 2 的幂，便于找到无冲突的种子
+constexpr size_t slotCount() {
+    size_t n = 1;
+    while (n < kCount * 4) n <<= 1;
+    return n;
+}
+
+constexpr size_t kSlots = slotCount();
+
+constexpr bool collisionFree(uint32_t seed) {
+    bool used[kSlots] = {};
+    for (std::string_view name : Table::names) {
+        size_t slot = hash(name, seed) & (kSlots - 1);
+        if (used[slot]) return false;
+        used[slot] = true;
+    }
+    return true;
+}
+
+constexpr uint32_t findSeed() {
+    for (uint32_t seed = 1; seed < 100000; ++seed) {
+        if (collisionFree(seed)) return seed;
+    }
+    return 0;
+}
+
+constexpr uint32_t kSeed = findSeed();
+static_assert(kSeed != 0, "岗位名称找不到无冲突的哈希种子，请增大槽位数");
+
+constexpr std::array<uint8_t, kSlots> buildSlots() {
+    std::array<uint8_t, kSlots> slots{};
+    for (auto& s : slots) s = kUnknown;
+    for (size_t i = 0; i < kCount; ++i) {
+        slots[hash(Table::names[i], kSeed) & (kSlots - 1)] = static_cast<uint8_t>(i);
+    }
+    return slots;
+}
+
+constexpr std::array<uint8_t, kSlots> kSlotTable = buildSlots();
+
+} // namespace detail
+
+// 岗位类的编码
+template <typename T>
+constexpr uint8_t codeOf() {
+    return static_cast<uint8_t>(detail::IndexOf<T, Registered>::value);
+}
+
+// 英文岗位名 -> 编码，未登记时返回 kUnknown
+inline uint8_t code(std::string_view name) {
+    uint8_t c = detail::kSlotTable[detail::hash(name, detail::kSeed) & (detail::kSlots - 1)];
+    return c != kUnknown && detail::Table::names[c] == name ? c : kUnknown;
+}
+
+// 英文岗位名、中文简称或中文全称 -> 编码（用户输入使用）
+inline uint8_t codeFromLiteral(std::string_view text) {
+    uint8_t c = code(text);
+    if (c != kUnknown) return c;
+    for (size_t i = 0; i < kCount; ++i) {
+        if (text == detail::Table::labels[i] || text == detail::Table::fullLabels[i]) return static_cast<uint8_t>(i);
+    }
+    return kUnknown;
+}
+
+inline std::unique_ptr<Employee> create(uint8_t code) {
+    return code < kCount ? detail::Table::factories[code]() : nullptr;
+}
+
+inline std::string_view name(uint8_t code) { return detail::Table::names[code]; }
+inline const char* label(uint8_t code) { return detail::Table::labels[code]; }
+inline const char* fullLabel(uint8_t code) { return detail::Table::fullLabels[code]; }
+inline const char* salaryHint(uint8_t code) { return detail::Table::salaryHints[code]; }
+
+// CSV 参数列 param1..param3 对应的 JSON 字段
+inline const detail::ParamKeys& paramKeys(uint8_t code) { return detail::Table::paramKeys[code]; }
+
+// CSV 参数列的合理取值范围（只对 paramKeys 非空的列有意义）
+inline const detail::ParamRanges& paramRanges(uint8_t code) { return detail::Table::paramRanges[code]; }
+
+inline double salaryFromParams(uint8_t code, double p1, double p2, double p3) {
+    return detail::Table::salaryFns[code](p1, p2, p3);
+}
+
+// 全部英文岗位名，以 sep 分隔（提示信息使用）
+inline std::string nameList(const char* sep) {
+    std::string s;
+    for (size_t i = 0; i < kCount; ++i) {
+        if (i) s += sep;
+        s += detail::Table::names[i];
+    }
+    return s;
+}
+
+} // namespace roles
+
+#endif // ROLEREGISTRY_H
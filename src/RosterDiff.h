@@ -0,0 +1,356 @@
+#ifndef ROSTERDIFF_H
+#define ROSTERDIFF_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstring>
+#include <cstdlib>
+#include <cstdint>
+#include <algorithm>
+
+#include "Employee.h"
+#include "RosterIO.h"
+#include "ShardedStore.h"
+
+/**
+ * 花名册比对 (RosterDiff)
+ * - Snapshot 把一份花名册（单文件、.lz4 或分片目录）映射到内存，只解析每行的编号，
+ *   按编号散列并行划分到 kPartitions 个分区，行内容仍引用映射的原始字节
+ * - diff() 对两份快照按分区并行做散列连接：每个分区各自建开放寻址表，
+ *   得出新增、删除、变更的员工；行字节不同时再逐列比较（数值列按数值比较），
+ *   避免 "5000" 与 "5000.00" 这类格式差异被当成变更
+ * - 同一份花名册中编号重复时以最后一行为准（与 EmployeeManager::load 一致）
+ * - ChangeSet 为紧凑的变更集，可写成文件（每行一个操作），由 EmployeeManager::applyChanges 原地应用
+ */
+namespace roster_diff {
+
+// 变更集：removed 为删除的编号，changed / added 为变更后 / 新增员工的完整 CSV 行，均按编号升序
+struct ChangeSet {
+    std::vector<int> removed;
+    std::vector<std::string> changed;
+    std::vector<std::string> added;
+
+    bool empty() const { return removed.empty() && changed.empty() && added.empty(); }
+    size_t size() const { return removed.size() + changed.size() + added.size(); }
+
+    // 文件格式：注释行以 # 开头；"-,编号" 删除，"~,CSV 行" 变更，"+,CSV 行" 新增。
+    // 按删除、变更、新增的顺序写出（应用时同样按此顺序）；.lz4 结尾时压缩
+    bool write(const std::string& path) const {
+        roster_io::RosterWriter out;
+        if (!out.open(path)) return false;
+        out.write("# roster changeset v1\n");
+        std::string line;
+        for (int id : removed) {
+            line = "-,";
+            line += std::to_string(id);
+            line += '\n';
+            out.write(line);
+        }
+        for (const std::string& row : changed) out.write("~," + row + "\n");
+        for (const std::string& row : added) out.write("+," + row + "\n");
+        return out.close();
+    }
+
+    roster_io::ReadStatus read(const std::string& path, std::string* error = nullptr) {
+        removed.clear();
+        changed.clear();
+        added.clear();
+        size_t lineNo = 0;
+        std::string bad;
+        roster_io::ReadStatus status = roster_io::forEachLine(path, [&](const std::string& raw) {
+            ++lineNo;
+            std::string line = raw;
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            if (line.empty() || line[0] == '#') return;
+            if (line.size() < 3 || line[1] != ',') {
+                if (bad.empty()) bad = "第 " + std::to_string(lineNo) + " 行格式错误";
+                return;
+            }
+            if (line[0] == '-') {
+                try {
+                    removed.push_back(std::stoi(line.substr(2)));
+                } catch (...) {
+                    if (bad.empty()) bad = "第 " + std::to_string(lineNo) + " 行编号无效";
+                }
+            } else if (line[0] == '~') {
+                changed.push_back(line.substr(2));
+            } else if (line[0] == '+') {
+                added.push_back(line.substr(2));
+            } else if (bad.empty()) {
+                bad = "第 " + std::to_string(lineNo) + " 行操作未知";
+            }
+        }, error);
+        if (status == roster_io::ReadStatus::Ok && !bad.empty()) {
+            if (error) *error = bad;
+            return roster_io::ReadStatus::Corrupt;
+        }
+        return status;
+    }
+};
+
+// 已映射、按编号分区的花名册
+class Snapshot {
+public:
+    static constexpr size_t kPartitions = 64;
+
+    // 一行的视图（不含换行符），在 Snapshot 销毁前有效
+    struct Row {
+        const char* data;
+        uint32_t length;
+        int id;
+    };
+
+    roster_io::ReadStatus open(const std::string& path, std::string* error = nullptr) {
+        files_.clear();
+        for (auto& p : partitions_) p.clear();
+        rows_ = 0;
+
+        std::vector<std::string> paths;
+        if (ShardedStore::isShardedPath(path)) {
+            ShardedStore store;
+            if (!store.open(path)) {
+                if (error) *error = "分片清单格式错误";
+                return roster_io::ReadStatus::Corrupt;
+            }
+            for (size_t s = 0; s < store.shardCount(); ++s) paths.push_back(store.shardPath(s));
+        } else {
+            paths.push_back(path);
+        }
+
+        for (const std::string& p : paths) {
+            std::unique_ptr<roster_io::MappedRoster> file(new roster_io::MappedRoster());
+            roster_io::ReadStatus status = file->open(p, error);
+            // 分片目录中缺失的分片视为空分片（与 ShardedStore::loadAll 一致）
+            if (status == roster_io::ReadStatus::NotFound && paths.size() > 1) continue;
+            if (status != roster_io::ReadStatus::Ok) return status;
+            files_.push_back(std::move(file));
+        }
+        partition();
+        return roster_io::ReadStatus::Ok;
+    }
+
+    size_t rows() const { return rows_; }
+    const std::vector<Row>& rowsIn(size_t partition) const { return partitions_[partition]; }
+
+    static size_t partitionOf(int id) {
+        return static_cast<size_t>((static_cast<uint32_t>(id) * 2654435761u) >> 26);  // 高 6 位
+    }
+
+private:
+    static_assert(kPartitions == 64, "partitionOf 取散列的高 6 位");
+    static constexpr size_t kChunkBytes = 4 << 20;
+
+    std::vector<std::unique_ptr<roster_io::MappedRoster>> files_;
+    std::vector<Row> partitions_[kPartitions];
+    size_t rows_ = 0;
+
+    // 解析行首的编号；表头、空行或编号无效时返回 false
+    static bool parseId(const char* p, size_t length, int& id) {
+        const char* end = p + length;
+        bool negative = p < end && *p == '-';
+        if (negative) ++p;
+        const char* start = p;
+        long long value = 0;
+        while (p < end && *p >= '0' && *p <= '9' && value <= 0x7fffffffLL) value = value * 10 + (*p++ - '0');
+        if (p == start || p == end || *p != ',' || value > 0x7fffffffLL) return false;
+        id = static_cast<int>(negative ? -value : value);
+        return true;
+    }
+
+    // 各文件按 4MB 切块（块边界对齐到行首），各块并行划分行，再按块顺序拼接各分区
+    void partition() {
+        struct Chunk {
+            const char* begin;
+            const char* end;
+            std::vector<Row> parts[kPartitions];
+        };
+        std::vector<Chunk> chunks;
+        for (const auto& file : files_) {
+            const char* p = file->data();
+            const char* end = p + file->size();
+            while (p < end) {
+                const char* stop = p + std::min<size_t>(kChunkBytes, static_cast<size_t>(end - p));
+                if (stop < end) {
+                    const char* nl = static_cast<const char*>(std::memchr(stop, '\n', end - stop));
+                    stop = nl ? nl + 1 : end;
+                }
+                chunks.push_back(Chunk{p, stop, {}});
+                p = stop;
+            }
+        }
+
+        ShardedStore::forEachShardParallel(chunks.size(), [&](size_t c) {
+            Chunk& chunk = chunks[c];
+            const char* p = chunk.begin;
+            while (p < chunk.end) {
+                const char* nl = static_cast<const char*>(std::memchr(p, '\n', chunk.end - p));
+                const char* stop = nl ? nl : chunk.end;
+                size_t length = static_cast<size_t>(stop - p);
+                if (length && p[length - 1] == '\r') --length;
+                int id;
+                if (parseId(p, length, id)) {
+                    chunk.parts[partitionOf(id)].push_back(Row{p, static_cast<uint32_t>(length), id});
+                }
+                p = stop + 1;
+            }
+        });
+
+        ShardedStore::forEachShardParallel(kPartitions, [&](size_t part) {
+            size_t total = 0;
+            for (const Chunk& chunk : chunks) total += chunk.parts[part].size();
+            partitions_[part].reserve(total);
+            for (const Chunk& chunk : chunks) {
+                partitions_[part].insert(partitions_[part].end(), chunk.parts[part].begin(), chunk.parts[part].end());
+            }
+        });
+        for (const auto& p : partitions_) rows_ += p.size();
+    }
+};
+
+namespace detail {
+
+// 分区内按编号的开放寻址散列表（线性探测），重复编号以后插入者为准
+class RowTable {
+public:
+    explicit RowTable(const std::vector<Snapshot::Row>& rows) {
+        size_t capacity = 16;
+        while (capacity < rows.size() * 2) capacity <<= 1;
+        mask_ = capacity - 1;
+        slots_.assign(capacity, kEmpty);
+        rows_ = &rows;
+        for (uint32_t i = 0; i < rows.size(); ++i) {
+            slots_[probe(rows[i].id)] = i;
+        }
+    }
+
+    // 返回编号所在行的下标，不存在时返回 kEmpty
+    uint32_t find(int id) const { return slots_[probe(id)]; }
+
+    template <typename Fn>
+    void forEach(Fn fn) const {
+        for (uint32_t slot : slots_) {
+            if (slot != kEmpty) fn(slot);
+        }
+    }
+
+    static constexpr uint32_t kEmpty = 0xffffffffu;
+
+private:
+    std::vector<uint32_t> slots_;
+    size_t mask_ = 0;
+    const std::vector<Snapshot::Row>* rows_ = nullptr;
+
+    size_t probe(int id) const {
+        // 分区已用掉散列的高位，这里用另一个乘数打散低位
+        size_t i = static_cast<size_t>((static_cast<uint64_t>(static_cast<uint32_t>(id)) * 0x9E3779B97F4A7C15ULL) >> 32) & mask_;
+        while (slots_[i] != kEmpty && (*rows_)[slots_[i]].id != id) i = (i + 1) & mask_;
+        return i;
+    }
+};
+
+inline bool sameNumber(const std::string& a, const std::string& b) {
+    if (a.empty() || b.empty()) return false;
+    char* endA = nullptr;
+    char* endB = nullptr;
+    double x = std::strtod(a.c_str(), &endA);
+    double y = std::strtod(b.c_str(), &endB);
+    return *endA == '\0' && *endB == '\0' && x == y;
+}
+
+// 两行内容是否相同：字节相同，或逐列相同（数值列按数值比较，缺少的尾部列视为空，
+// 缺少的上级编号列视为 0）
+inline bool sameRow(const Snapshot::Row& a, const Snapshot::Row& b) {
+    if (a.length == b.length && std::memcmp(a.data, b.data, a.length) == 0) return true;
+    std::vector<std::string> x = Employee::splitCSV(std::string(a.data, a.length));
+    std::vector<std::string> y = Employee::splitCSV(std::string(b.data, b.length));
+    size_t n = std::max(x.size(), y.size());
+    x.resize(n);
+    y.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        if (i == Employee::kManagerColumn) {
+            if (x[i].empty()) x[i] = "0";
+            if (y[i].empty()) y[i] = "0";
+        }
+        if (x[i] != y[i] && !sameNumber(x[i], y[i])) return false;
+    }
+    return true;
+}
+
+} // namespace detail
+
+// 比对结果各类别的人数
+struct DiffSummary {
+    size_t before = 0;
+    size_t after = 0;
+    size_t unchanged = 0;
+};
+
+// 计算由 before 变为 after 的变更集
+inline ChangeSet diff(const Snapshot& before, const Snapshot& after, DiffSummary* summary = nullptr) {
+    struct Partial {
+        std::vector<std::pair<int, const Snapshot::Row*>> changed, added;
+        std::vector<int> removed;
+        size_t before = 0, after = 0, unchanged = 0;
+    };
+    std::vector<Partial> partials(Snapshot::kPartitions);
+
+    ShardedStore::forEachShardParallel(Snapshot::kPartitions, [&](size_t part) {
+        const std::vector<Snapshot::Row>& oldRows = before.rowsIn(part);
+        const std::vector<Snapshot::Row>& newRows = after.rowsIn(part);
+        detail::RowTable oldTable(oldRows);
+        detail::RowTable newTable(newRows);
+        std::vector<char> matched(newRows.size(), 0);
+        Partial& out = partials[part];
+
+        oldTable.forEach([&](uint32_t i) {
+            const Snapshot::Row& row = oldRows[i];
+            ++out.before;
+            uint32_t j = newTable.find(row.id);
+            if (j == detail::RowTable::kEmpty) {
+                out.removed.push_back(row.id);
+                return;
+            }
+            matched[j] = 1;
+            if (detail::sameRow(row, newRows[j])) {
+                ++out.unchanged;
+            } else {
+                out.changed.emplace_back(row.id, &newRows[j]);
+            }
+        });
+        newTable.forEach([&](uint32_t j) {
+            ++out.after;
+            if (!matched[j]) out.added.emplace_back(newRows[j].id, &newRows[j]);
+        });
+    });
+
+    // 汇总并按编号排序，使变更集与分区、线程数无关
+    std::vector<std::pair<int, const Snapshot::Row*>> changed, added;
+    ChangeSet result;
+    DiffSummary counts;
+    for (Partial& p : partials) {
+        changed.insert(changed.end(), p.changed.begin(), p.changed.end());
+        added.insert(added.end(), p.added.begin(), p.added.end());
+        result.removed.insert(result.removed.end(), p.removed.begin(), p.removed.end());
+        counts.before += p.before;
+        counts.after += p.after;
+        counts.unchanged += p.unchanged;
+    }
+    auto byId = [](const std::pair<int, const Snapshot::Row*>& a, const std::pair<int, const Snapshot::Row*>& b) {
+        return a.first < b.first;
+    };
+    std::sort(changed.begin(), changed.end(), byId);
+    std::sort(added.begin(), added.end(), byId);
+    std::sort(result.removed.begin(), result.removed.end());
+    result.changed.reserve(changed.size());
+    for (const auto& c : changed) result.changed.emplace_back(c.second->data, c.second->length);
+    result.added.reserve(added.size());
+    for (const auto& a : added) result.added.emplace_back(a.second->data, a.second->length);
+
+    if (summary) *summary = counts;
+    return result;
+}
+
+} // namespace roster_diff
+
+#endif // ROSTERDIFF_H
@@ -0,0 +1,318 @@
+#ifndef ROSTERIO_H
+#define ROSTERIO_H
+
+#include <string>
+#include <deque>
+#include <fstream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstring>
+#include <memory>
+#include <iterator>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "Lz4Frame.h"
+#include "AsyncIO.h"
+
+/**
+ * 花名册文件读写 (RosterIO)
+ * - 以 .lz4 结尾的路径按 LZ4 帧压缩读写，其余按普通 CSV 文本处理
+ * - 读取压缩文件时，后台线程逐块解压并放入有界队列，调用方线程同时按行解析；
+ *   内存占用只与队列深度 × 块大小 (1MB) 有关，与文件大小无关
+ * - 普通 CSV 的读写经 AsyncIO（io_uring，或 pread/pwrite 回退）以 1MB 大块进行
+ * - MappedRoster 把整个花名册映射到内存，供延迟加载模式按行引用原始内容
+ */
+namespace roster_io {
+
+inline bool isCompressedPath(const std::string& path) {
+    return path.size() > 4 && path.compare(path.size() - 4, 4, ".lz4") == 0;
+}
+
+enum class ReadStatus { Ok, NotFound, Corrupt };
+
+// 有界块队列（单生产者、单消费者）
+class ChunkQueue {
+public:
+    explicit ChunkQueue(size_t capacity) : capacity_(capacity) {}
+
+    void push(std::string&& chunk) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        notFull_.wait(lock, [this] { return chunks_.size() < capacity_ || cancelled_; });
+        if (cancelled_) return;
+        chunks_.push_back(std::move(chunk));
+        notEmpty_.notify_one();
+    }
+
+    // 队列已关闭且取空时返回 false
+    bool pop(std::string& chunk) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        notEmpty_.wait(lock, [this] { return !chunks_.empty() || closed_; });
+        if (chunks_.empty()) return false;
+        chunk = std::move(chunks_.front());
+        chunks_.pop_front();
+        notFull_.notify_one();
+        return true;
+    }
+
+    // 生产者结束
+    void close() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+        notEmpty_.notify_all();
+    }
+
+    // 消费者提前退出，唤醒阻塞的生产者
+    void cancel() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        cancelled_ = true;
+        notFull_.notify_all();
+    }
+
+    bool cancelled() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return cancelled_;
+    }
+
+private:
+    size_t capacity_;
+    std::deque<std::string> chunks_;
+    bool closed_ = false;
+    bool cancelled_ = false;
+    std::mutex mutex_;
+    std::condition_variable notEmpty_;
+    std::condition_variable notFull_;
+};
+
+// 把连续到达的数据块切分成行：行可能跨块，未完成的尾部留在 carry 中
+template <typename Fn>
+class LineSplitter {
+public:
+    explicit LineSplitter(Fn& fn) : fn_(fn) {}
+
+    void feed(const char* p, size_t size) {
+        const char* end = p + size;
+        while (p < end) {
+            const char* nl = static_cast<const char*>(std::memchr(p, '\n', end - p));
+            if (!nl) {
+                carry_.append(p, end - p);
+                break;
+            }
+            if (carry_.empty()) {
+                line_.assign(p, nl - p);
+            } else {
+                carry_.append(p, nl - p);
+                line_.swap(carry_);
+                carry_.clear();
+            }
+            fn_(line_);
+            p = nl + 1;
+        }
+    }
+
+    // 文件末尾没有换行符时输出最后一行
+    void finish() {
+        if (!carry_.empty()) fn_(carry_);
+        carry_.clear();
+    }
+
+private:
+    Fn& fn_;
+    std::string carry_, line_;
+};
+
+// 逐行读取花名册，对每一行调用 fn(const std::string&)（不含换行符）
+// 普通 CSV 经 async_io 以大块异步读取，解析与读盘并行
+template <typename Fn>
+ReadStatus forEachLine(const std::string& path, Fn fn, std::string* error = nullptr) {
+    LineSplitter<Fn> splitter(fn);
+    if (!isCompressedPath(path)) {
+        std::string readError;
+        async_io::Status status = async_io::readFile(path, [&](const char* p, size_t size) {
+            splitter.feed(p, size);
+        }, &readError);
+        if (status == async_io::Status::NotFound) return ReadStatus::NotFound;
+        splitter.finish();
+        if (status == async_io::Status::Failed) {
+            if (error) *error = readError.empty() ? "读取失败" : readError;
+            return ReadStatus::Corrupt;
+        }
+        return ReadStatus::Ok;
+    }
+
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) return ReadStatus::NotFound;
+
+    ChunkQueue queue(4);
+    std::string readError;
+    std::thread producer([&] {
+        lz4::FrameReader reader(in);
+        std::string chunk;
+        while (!queue.cancelled() && reader.next(chunk)) {
+            queue.push(std::move(chunk));
+            chunk = std::string();
+        }
+        readError = reader.error();
+        queue.close();
+    });
+
+    // 解析与解压并行
+    std::string chunk;
+    try {
+        while (queue.pop(chunk)) splitter.feed(chunk.data(), chunk.size());
+        splitter.finish();
+    } catch (...) {
+        queue.cancel();
+        producer.join();
+        throw;
+    }
+    producer.join();
+
+    if (!readError.empty()) {
+        if (error) *error = readError;
+        return ReadStatus::Corrupt;
+    }
+    return ReadStatus::Ok;
+}
+
+// 整个花名册的只读内存视图
+// 普通 CSV 以 mmap 映射（Windows 上整体读入内存），.lz4 文件整体解压到内存
+class MappedRoster {
+public:
+    MappedRoster() = default;
+    MappedRoster(const MappedRoster&) = delete;
+    MappedRoster& operator=(const MappedRoster&) = delete;
+    ~MappedRoster() { close(); }
+
+    ReadStatus open(const std::string& path, std::string* error = nullptr) {
+        close();
+        if (isCompressedPath(path)) return openCompressed(path, error);
+#ifndef _WIN32
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return ReadStatus::NotFound;
+        struct stat st;
+        if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+            void* p = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p != MAP_FAILED) {
+                data_ = static_cast<const char*>(p);
+                size_ = static_cast<size_t>(st.st_size);
+                mapped_ = true;
+            }
+        }
+        ::close(fd);
+        if (mapped_ || st.st_size == 0) return ReadStatus::Ok;
+#endif
+        // 映射不可用时整体读入
+        std::ifstream in(path, std::ios::binary);
+        if (!in.is_open()) return ReadStatus::NotFound;
+        buffer_.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        data_ = buffer_.data();
+        size_ = buffer_.size();
+        return ReadStatus::Ok;
+    }
+
+    void close() {
+#ifndef _WIN32
+        if (mapped_) ::munmap(const_cast<char*>(data_), size_);
+#endif
+        mapped_ = false;
+        data_ = nullptr;
+        size_ = 0;
+        buffer_.clear();
+        buffer_.shrink_to_fit();
+    }
+
+    // 对每一行调用 fn(const char* begin, size_t length)（不含换行符），行指针在 close() 前有效
+    template <typename Fn>
+    void forEachLine(Fn fn) const {
+        const char* p = data_;
+        const char* end = data_ + size_;
+        while (p < end) {
+            const char* nl = static_cast<const char*>(std::memchr(p, '\n', end - p));
+            const char* stop = nl ? nl : end;
+            fn(p, static_cast<size_t>(stop - p));
+            p = stop + 1;
+        }
+    }
+
+    const char* data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+    bool mapped_ = false;
+    std::string buffer_;
+
+    ReadStatus openCompressed(const std::string& path, std::string* error) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in.is_open()) return ReadStatus::NotFound;
+        lz4::FrameReader reader(in);
+        std::string chunk;
+        while (reader.next(chunk)) buffer_ += chunk;
+        data_ = buffer_.data();
+        size_ = buffer_.size();
+        if (!reader.error().empty()) {
+            if (error) *error = reader.error();
+            return ReadStatus::Corrupt;
+        }
+        return ReadStatus::Ok;
+    }
+};
+
+// 花名册写入器：普通文本或 LZ4 帧
+// 普通文本经 async_io::FileWriter 批量异步写入；两种格式都先写临时文件，成功后再替换目标文件
+class RosterWriter {
+public:
+    bool open(const std::string& path) {
+        compressed_ = isCompressedPath(path);
+        if (!compressed_) return file_.open(path);
+        path_ = path;
+        out_.open(path + ".tmp", std::ios::binary | std::ios::trunc);
+        if (!out_.is_open()) return false;
+        frame_.reset(new lz4::FrameWriter(out_));
+        return true;
+    }
+
+    void write(const std::string& s) {
+        if (frame_) frame_->write(s);
+        else file_.write(s);
+    }
+
+    // 结束写入，返回是否成功
+    bool close() {
+        if (!compressed_) {
+            bytes_ = file_.bytesWritten();
+            return file_.commit();
+        }
+        if (frame_) frame_->finish();
+        bytes_ = frame_ ? frame_->bytesWritten() : 0;
+        frame_.reset();
+        out_.close();
+        std::string tmp = path_ + ".tmp";
+        bool ok = !out_.fail() && async_io::detail::replaceFile(tmp, path_);
+        if (!ok) std::remove(tmp.c_str());
+        return ok;
+    }
+
+    // 实际写入磁盘的字节数（压缩后）
+    uint64_t bytesWritten() const { return bytes_; }
+
+private:
+    bool compressed_ = false;
+    std::string path_;
+    async_io::FileWriter file_;
+    std::ofstream out_;
+    std::unique_ptr<lz4::FrameWriter> frame_;
+    uint64_t bytes_ = 0;
+};
+
+} // namespace roster_io
+
+#endif // ROSTERIO_H
@@ -0,0 +1,709 @@
+#ifndef ROSTERVALIDATOR_H
+#define ROSTERVALIDATOR_H
+
+#include <array>
+#include <string>
+#include <vector>
+#include <memory>
+#include <ostream>
+#include <ctime>
+#include <cstring>
+#include <cstdint>
+#include <algorithm>
+#include <unordered_set>
+
+#include "BitOps.h"
+#include "RoleRegistry.h"
+#include "RosterIO.h"
+#include "ShardedStore.h"
+
+/**
+ * 花名册校验与修复 (RosterValidator)
+ * - 直接扫描原始字节（单文件、.lz4 或分片目录），不构造员工对象，也不用异常处理解析失败：
+ *   每 64 字节用 matchMask64 一次找出全部逗号与换行，按位遍历得到各列边界，
+ *   再用无异常的整数/小数/日期解析逐列检查
+ * - 检查项：列数、编号（正整数、不重复）、姓名、岗位、级别范围、性别、
+ *   生日（与 Employee::isValidDate 规则一致，且不晚于今天）、各岗位参数列的数值与范围
+ *   （范围来自岗位类的 kParamRanges，见 RoleRegistry）、上级编号（非负整数、不是本人、在花名册中存在）
+ * - 列错位：旧格式（无生日列）的行被新程序读写后，生日列里是数字、参数整体右移一列；
+ *   末列为 0 时可确定地移回，缺生日列的 8 列旧行同样可补齐
+ * - 只含可修复问题的行自动修复；含其他问题的行需要人工处理，修复输出时单独写入 .rejects 文件
+ * - 按 4MB 切块并行校验，各块的问题按行号合并；重复编号与不存在的上级在并行扫描后统一检查
+ */
+namespace validate {
+
+enum class Issue : uint8_t {
+    ColumnCount, BadId, DuplicateId, EmptyName, UnknownRole, BadLevel, BadGender,
+    BadDate, FutureBirthday, ColumnShift, BadNumber, OutOfRange, BadManager, UnknownManager,
+    Count_
+};
+
+inline const char* issueName(Issue issue) {
+    static const char* const names[] = {
+        "column_count", "bad_id", "duplicate_id", "empty_name", "unknown_role", "bad_level", "bad_gender",
+        "bad_date", "future_birthday", "column_shift", "bad_number", "out_of_range", "bad_manager", "unknown_manager",
+    };
+    return names[static_cast<int>(issue)];
+}
+
+inline const char* issueLabel(Issue issue) {
+    static const char* const labels[] = {
+        "列数不符", "编号无效", "编号重复", "姓名为空", "岗位未知", "级别无效", "性别无效",
+        "生日格式错误", "生日晚于今天", "列错位", "数值无效", "数值超出范围", "上级编号无效", "上级不存在",
+    };
+    return labels[static_cast<int>(issue)];
+}
+
+static constexpr int kColumns = 10;  // id,name,role,level,gender,birthday,param1,param2,param3,managerId
+static constexpr int kManagerColumn = static_cast<int>(Employee::kManagerColumn);  // 末列，可省略
+static constexpr int kMinLevel = 1;
+static constexpr int kMaxLevel = 100;
+
+inline const char* columnName(int column) {
+    static const char* const names[] = {
+        "id", "name", "role", "level", "gender", "birthday", "param1", "param2", "param3", "managerId",
+    };
+    return column >= 0 && column < kColumns ? names[column] : "";
+}
+
+// 一个问题：行号从 1 开始（含表头行）
+struct Finding {
+    uint64_t line = 0;
+    int id = 0;
+    Issue issue = Issue::ColumnCount;
+    int8_t column = -1;  // -1 表示整行
+    bool repairable = false;
+    std::string value;
+};
+
+struct Report {
+    uint64_t lines = 0;      // 扫描的行数（含表头与空行）
+    uint64_t rows = 0;       // 数据行数
+    uint64_t cleanRows = 0;
+    uint64_t repairedRows = 0;
+    uint64_t rejectedRows = 0;
+    std::array<uint64_t, static_cast<size_t>(Issue::Count_)> counts{};
+    std::vector<Finding> findings;  // 按行号排序，最多 Options::maxFindings 条
+    bool truncated = false;         // findings 是否因上限被截断
+
+    bool clean() const { return cleanRows == rows; }
+
+    void print(std::ostream& os, size_t limit) const {
+        os << "\n========== 数据校验 ==========" << std::endl;
+        os << "数据行: " << rows << "，无问题 " << cleanRows << "，可自动修复 " << repairedRows
+           << "，需人工处理 " << rejectedRows << std::endl;
+        for (size_t i = 0; i < counts.size(); ++i) {
+            if (counts[i]) os << "  " << issueLabel(static_cast<Issue>(i)) << ": " << counts[i] << std::endl;
+        }
+        size_t shown = std::min(limit, findings.size());
+        if (shown) os << "\n问题明细（前 " << shown << " 条）:" << std::endl;
+        for (size_t i = 0; i < shown; ++i) {
+            const Finding& f = findings[i];
+            os << "  第 " << f.line << " 行";
+            if (f.id) os << "（编号 " << f.id << "）";
+            os << ": " << issueLabel(f.issue);
+            if (f.column >= 0) os << " [" << columnName(f.column) << "=" << f.value << "]";
+            else if (!f.value.empty()) os << " [" << f.value << "]";
+            os << (f.repairable ? "，可自动修复" : "，需人工处理") << std::endl;
+        }
+        os << "==============================" << std::endl;
+    }
+
+    // 全部问题写成 CSV：line,id,issue,column,value,repairable
+    bool writeCSV(const std::string& path) const {
+        roster_io::RosterWriter out;
+        if (!out.open(path)) return false;
+        out.write("line,id,issue,column,value,repairable\n");
+        for (const Finding& f : findings) {
+            out.write(std::to_string(f.line) + "," + std::to_string(f.id) + "," + issueName(f.issue) + ","
+                      + columnName(f.column) + "," + f.value + "," + (f.repairable ? "1" : "0") + "\n");
+        }
+        return out.close();
+    }
+};
+
+struct Options {
+    size_t maxFindings = 1000000;
+    std::string repairPath;  // 非空时写出修复后的花名册，需人工处理的行写入 repairPath + ".rejects"
+};
+
+namespace detail {
+
+struct Field {
+    const char* begin;
+    const char* end;
+    size_t size() const { return static_cast<size_t>(end - begin); }
+    bool equals(const char* s) const { return size() == std::strlen(s) && std::memcmp(begin, s, size()) == 0; }
+    std::string str() const { return std::string(begin, end); }
+};
+
+// 十进制整数（可带负号），不接受空串与多余字符
+inline bool parseInt(Field f, long long& out) {
+    const char* p = f.begin;
+    bool negative = p < f.end && *p == '-';
+    if (negative) ++p;
+    if (p == f.end || f.end - p > 18) return false;
+    long long v = 0;
+    for (; p < f.end; ++p) {
+        if (*p < '0' || *p > '9') return false;
+        v = v * 10 + (*p - '0');
+    }
+    out = negative ? -v : v;
+    return true;
+}
+
+// 小数：[-]digits[.digits][e[-]digits]，精度足以做范围检查
+inline bool parseNumber(Field f, double& out) {
+    static const double kPow10[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10,
+                                    1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18};
+    const char* p = f.begin;
+    bool negative = p < f.end && (*p == '-' || *p == '+');
+    if (negative) negative = (*p++ == '-');
+    uint64_t mantissa = 0;
+    int digits = 0, scale = 0;
+    const char* start = p;
+    for (; p < f.end && *p >= '0' && *p <= '9'; ++p) {
+        if (digits < 19) mantissa = mantissa * 10 + static_cast<uint64_t>(*p - '0'), ++digits;
+        else ++scale;
+    }
+    if (p < f.end && *p == '.') {
+        for (++p; p < f.end && *p >= '0' && *p <= '9'; ++p) {
+            if (digits < 19) mantissa = mantissa * 10 + static_cast<uint64_t>(*p - '0'), ++digits, --scale;
+        }
+    }
+    if (p == start || (p == start + 1 && *start == '.')) return false;
+    if (p < f.end && (*p == 'e' || *p == 'E')) {
+        long long e;
+        if (!parseInt(Field{p + 1, f.end}, e) || e > 400 || e < -400) return false;
+        scale += static_cast<int>(e);
+        p = f.end;
+    }
+    if (p != f.end) return false;
+    double v = static_cast<double>(mantissa);
+    for (; scale > 18; scale -= 18) v *= 1e18;
+    for (; scale < -18; scale += 18) v /= 1e18;
+    v = scale >= 0 ? v * kPow10[scale] : v / kPow10[-scale];
+    out = negative ? -v : v;
+    return true;
+}
+
+inline int digit(char c) { return c >= '0' && c <= '9' ? c - '0' : -1; }
+
+// 与 Employee::isValidDate 相同的规则：YYYY-MM-DD，年 1900-2100，月 1-12，日 1-31；
+// 合法时返回 YYYYMMDD，否则返回 0
+inline int parseDate(Field f) {
+    if (f.size() != 10 || f.begin[4] != '-' || f.begin[7] != '-') return 0;
+    int d[8];
+    static const int pos[8] = {0, 1, 2, 3, 5, 6, 8, 9};
+    for (int i = 0; i < 8; ++i) {
+        d[i] = digit(f.begin[pos[i]]);
+        if (d[i] < 0) return 0;
+    }
+    int year = d[0] * 1000 + d[1] * 100 + d[2] * 10 + d[3];
+    int month = d[4] * 10 + d[5];
+    int day = d[6] * 10 + d[7];
+    if (year < 1900 || year > 2100 || month < 1 || month > 12 || day < 1 || day > 31) return 0;
+    return year * 10000 + month * 100 + day;
+}
+
+inline int today() {
+    std::time_t now = std::time(nullptr);
+    std::tm local{};
+#ifdef _WIN32
+    localtime_s(&local, &now);
+#else
+    localtime_r(&now, &local);
+#endif
+    return (local.tm_year + 1900) * 10000 + (local.tm_mon + 1) * 100 + local.tm_mday;
+}
+
+enum RowState : uint8_t { Clean, Repaired, Rejected };
+
+// 一行的修复动作
+struct Fix {
+    uint32_t row;             // 块内数据行序号
+    bool reject;              // true：移入 .rejects；false：替换为 replacement
+    std::string replacement;
+};
+
+// 一个块的校验结果
+struct ChunkResult {
+    const char* begin = nullptr;
+    const char* end = nullptr;
+    uint64_t lines = 0;
+    Report report;                               // 行号为块内行号，合并时再加上前面各块的行数
+    std::vector<std::pair<int, uint32_t>> ids;   // (编号, 块内数据行序号)，查重用
+    std::vector<std::pair<int, uint32_t>> managers;  // (上级编号, 块内数据行序号)，检查上级是否存在
+    std::vector<uint32_t> rowLines;              // 块内数据行序号 -> 块内行号
+    std::vector<uint8_t> rowStates;              // 块内数据行序号 -> RowState
+    std::vector<Fix> fixes;                      // 按行序号升序
+};
+
+class ChunkValidator {
+public:
+    ChunkValidator(ChunkResult& out, const Options& options, int today, bool firstChunk)
+        : out_(out), options_(options), today_(today), firstChunk_(firstChunk) {}
+
+    void run() {
+        const char* p = out_.begin;
+        const char* end = out_.end;
+        const char* lineStart = p;
+        nfields_ = 0;
+        fieldStart_ = p;
+
+        // 整块按 64 字节取逗号/换行位图；末尾不足 64 字节的部分拷到本地缓冲
+        while (p < end) {
+            char tail[64];
+            const char* block = p;
+            size_t n = static_cast<size_t>(end - p);
+            if (n < 64) {
+                std::memcpy(tail, p, n);
+                std::memset(tail + n, 0, 64 - n);
+                block = tail;
+            }
+            uint64_t mask = bitops::matchMask64(block, ',', '\n');
+            while (mask) {
+                const char* hit = p + bitops::countTrailingZeros64(mask);
+                mask &= mask - 1;
+                if (*hit == ',') {
+                    addField(fieldStart_, hit);
+                    fieldStart_ = hit + 1;
+                } else {
+                    endLine(lineStart, hit);
+                    lineStart = hit + 1;
+                }
+            }
+            p += std::min<size_t>(64, n);
+        }
+        if (lineStart < end) endLine(lineStart, end);
+    }
+
+private:
+    static constexpr int kMaxFields = 16;
+
+    ChunkResult& out_;
+    const Options& options_;
+    int today_;
+    bool firstChunk_;
+    Field fields_[kMaxFields];
+    int nfields_ = 0;
+    const char* fieldStart_ = nullptr;
+    uint32_t dataRow_ = 0;
+
+    // 当前行的问题
+    Finding pending_[12];
+    int npending_ = 0;
+    bool rowRejected_ = false;
+
+    void addField(const char* b, const char* e) {
+        if (nfields_ < kMaxFields) fields_[nfields_] = Field{b, e};
+        ++nfields_;
+    }
+
+    void flag(Issue issue, int column, bool repairable, const std::string& value) {
+        if (!repairable) rowRejected_ = true;
+        if (npending_ < 12) {
+            Finding& f = pending_[npending_++];
+            f.issue = issue;
+            f.column = static_cast<int8_t>(column);
+            f.repairable = repairable;
+            f.value = value;
+        }
+    }
+
+    void endLine(const char* lineStart, const char* lineEnd) {
+        const char* e = lineEnd;
+        if (e > fieldStart_ && e[-1] == '\r') --e;
+        addField(fieldStart_, e);
+        fieldStart_ = lineEnd + 1;
+        ++out_.lines;
+
+        bool header = firstChunk_ && out_.lines == 1 && e - lineStart >= 3 && std::memcmp(lineStart, "id,", 3) == 0;
+        bool blank = e == lineStart;
+        if (!header && !blank) validateRow();
+        nfields_ = 0;
+    }
+
+    void validateRow() {
+        Report& report = out_.report;
+        ++report.rows;
+        npending_ = 0;
+        rowRejected_ = false;
+        uint32_t row = dataRow_++;
+        out_.rowLines.push_back(static_cast<uint32_t>(out_.lines));
+
+        int n = nfields_;
+        int id = 0;
+        long long value;
+        if (n < 5 || n > kColumns) {
+            flag(Issue::ColumnCount, -1, false, std::to_string(n) + " 列");
+        }
+        if (n >= 1) {
+            if (parseInt(fields_[0], value) && value > 0 && value <= 0x7fffffffLL) {
+                id = static_cast<int>(value);
+                out_.ids.emplace_back(id, row);
+            } else {
+                flag(Issue::BadId, 0, false, fields_[0].str());
+            }
+        }
+        uint8_t role = roles::kUnknown;
+        if (n >= 5 && n <= kColumns) {
+            if (fields_[1].size() == 0) flag(Issue::EmptyName, 1, false, "");
+            role = roles::code(std::string_view(fields_[2].begin, fields_[2].size()));
+            if (role == roles::kUnknown) flag(Issue::UnknownRole, 2, false, fields_[2].str());
+            if (!parseInt(fields_[3], value) || value < kMinLevel || value > kMaxLevel) {
+                flag(Issue::BadLevel, 3, false, fields_[3].str());
+            }
+            if (!fields_[4].equals("男") && !fields_[4].equals("女")) flag(Issue::BadGender, 4, false, fields_[4].str());
+        }
+
+        // 还原逻辑上的生日与三个参数列
+        Field empty{fields_[0].begin, fields_[0].begin};
+        Field birthday = empty;
+        Field params[3] = {empty, empty, empty};
+        bool shifted = false;
+        int date = 0;
+        if (n >= 5 && n <= kColumns) {
+            double number;
+            if (n >= 6) date = parseDate(fields_[5]);
+            bool numeric = n >= 8 && date == 0 && parseNumber(fields_[5], number);
+            if (n == 8 && numeric) {
+                // 旧格式：无生日列
+                shifted = true;
+                for (int i = 0; i < 3; ++i) params[i] = fields_[5 + i];
+                flag(Issue::ColumnShift, 5, true, fields_[5].str());
+            } else if (n >= kManagerColumn && numeric) {
+                double last;
+                bool lastZero = parseNumber(fields_[8], last) && last == 0;
+                shifted = true;
+                for (int i = 0; i < 3; ++i) params[i] = fields_[5 + i];
+                flag(Issue::ColumnShift, 5, lastZero, fields_[5].str());
+            } else {
+                if (n >= 6) birthday = fields_[5];
+                for (int i = 0; i < 3 && 6 + i < n; ++i) params[i] = fields_[6 + i];
+                if (n < kManagerColumn) flag(Issue::ColumnCount, -1, true, std::to_string(n) + " 列");
+            }
+        }
+
+        // 上级编号列可省略（视为 0）；存在时须为非负整数且不是本人，是否存在于花名册在扫描后检查
+        Field manager = n == kColumns ? fields_[kManagerColumn] : empty;
+        if (manager.size()) {
+            if (!parseInt(manager, value) || value < 0 || value > 0x7fffffffLL || (id && value == id)) {
+                flag(Issue::BadManager, kManagerColumn, false, manager.str());
+            } else if (value > 0) {
+                out_.managers.emplace_back(static_cast<int>(value), row);
+            }
+        }
+
+        if (birthday.size()) {
+            if (date == 0) flag(Issue::BadDate, 5, false, birthday.str());
+            else if (date > today_) flag(Issue::FutureBirthday, 5, false, birthday.str());
+        }
+
+        if (role != roles::kUnknown) {
+            const auto& keys = roles::paramKeys(role);
+            const auto& ranges = roles::paramRanges(role);
+            for (int i = 0; i < 3; ++i) {
+                if (!keys[i] || params[i].size() == 0) continue;  // 未使用的列；缺失的列按 0 处理
+                double number;
+                int column = shifted ? 5 + i : 6 + i;
+                if (!parseNumber(params[i], number)) {
+                    flag(Issue::BadNumber, column, false, params[i].str());
+                } else if (!(number >= ranges[i].min && number <= ranges[i].max)) {
+                    flag(Issue::OutOfRange, column, false, params[i].str());
+                }
+            }
+        }
+
+        if (npending_ == 0) {
+            ++report.cleanRows;
+            out_.rowStates.push_back(Clean);
+            return;
+        }
+        for (int i = 0; i < npending_; ++i) {
+            Finding& f = pending_[i];
+            ++report.counts[static_cast<size_t>(f.issue)];
+            if (report.findings.size() < options_.maxFindings) {
+                f.line = out_.lines;
+                f.id = id;
+                report.findings.push_back(f);
+            } else {
+                report.truncated = true;
+            }
+        }
+        out_.rowStates.push_back(rowRejected_ ? Rejected : Repaired);
+        if (rowRejected_) {
+            ++report.rejectedRows;
+            if (!options_.repairPath.empty()) out_.fixes.push_back(Fix{row, true, std::string()});
+            return;
+        }
+        ++report.repairedRows;
+        if (!options_.repairPath.empty()) {
+            std::string fixed;
+            for (int i = 0; i < 5; ++i) {
+                fixed.append(fields_[i].begin, fields_[i].end);
+                fixed += ',';
+            }
+            fixed.append(birthday.begin, birthday.end);
+            for (int i = 0; i < 3; ++i) {
+                fixed += ',';
+                if (params[i].size()) fixed.append(params[i].begin, params[i].end);
+                else fixed += '0';
+            }
+            fixed += ',';
+            if (manager.size()) fixed.append(manager.begin, manager.end);
+            else fixed += '0';
+            out_.fixes.push_back(Fix{row, false, std::move(fixed)});
+        }
+    }
+};
+
+} // namespace detail
+
+/**
+ * 校验器：open() 映射花名册，run() 并行校验并按需写出修复结果
+ */
+class RosterValidator {
+public:
+    roster_io::ReadStatus open(const std::string& path, std::string* error = nullptr) {
+        files_.clear();
+        std::vector<std::string> paths;
+        if (ShardedStore::isShardedPath(path)) {
+            ShardedStore store;
+            if (!store.open(path)) {
+                if (error) *error = "分片清单格式错误";
+                return roster_io::ReadStatus::Corrupt;
+            }
+            for (size_t s = 0; s < store.shardCount(); ++s) paths.push_back(store.shardPath(s));
+        } else {
+            paths.push_back(path);
+        }
+        for (const std::string& p : paths) {
+            std::unique_ptr<roster_io::MappedRoster> file(new roster_io::MappedRoster());
+            roster_io::ReadStatus status = file->open(p, error);
+            if (status == roster_io::ReadStatus::NotFound && paths.size() > 1) continue;
+            if (status != roster_io::ReadStatus::Ok) return status;
+            files_.push_back(std::move(file));
+        }
+        return roster_io::ReadStatus::Ok;
+    }
+
+    // 校验全部数据；options.repairPath 非空时写出修复后的花名册（写入失败时返回 false）
+    bool run(const Options& options, Report& report, std::string* error = nullptr) {
+        std::vector<detail::ChunkResult> chunks;
+        std::vector<bool> firstOfFile;
+        for (const auto& file : files_) {
+            const char* p = file->data();
+            const char* end = p + file->size();
+            bool first = true;
+            while (p < end) {
+                const char* stop = p + std::min<size_t>(kChunkBytes, static_cast<size_t>(end - p));
+                if (stop < end) {
+                    const char* nl = static_cast<const char*>(std::memchr(stop, '\n', end - stop));
+                    stop = nl ? nl + 1 : end;
+                }
+                chunks.emplace_back();
+                chunks.back().begin = p;
+                chunks.back().end = stop;
+                firstOfFile.push_back(first);
+                first = false;
+                p = stop;
+            }
+        }
+
+        int date = detail::today();
+        ShardedStore::forEachShardParallel(chunks.size(), [&](size_t c) {
+            detail::ChunkValidator(chunks[c], options, date, firstOfFile[c]).run();
+        });
+
+        IdSet ids;
+        findDuplicates(chunks, options, ids);
+        findUnknownManagers(chunks, options, ids);
+        merge(chunks, options, report);
+        if (!options.repairPath.empty() && !writeRepaired(chunks, options.repairPath, error)) return false;
+        return true;
+    }
+
+private:
+    static constexpr size_t kChunkBytes = 4 << 20;
+    std::vector<std::unique_ptr<roster_io::MappedRoster>> files_;
+
+    // 编号集合：编号不超过 kBitmapLimit 时用位图（最多 16MB），否则用散列集合
+    class IdSet {
+    public:
+        // 加入编号，返回是否是第一次出现
+        bool insert(int id) {
+            if (id >= kBitmapLimit) return large_.insert(id).second;
+            size_t word = static_cast<size_t>(id) >> 6;
+            if (word >= bits_.size()) bits_.resize(std::max(word + 1, bits_.size() * 2), 0);
+            uint64_t bit = 1ULL << (id & 63);
+            bool first = (bits_[word] & bit) == 0;
+            bits_[word] |= bit;
+            return first;
+        }
+
+        bool contains(int id) const {
+            if (id >= kBitmapLimit) return large_.count(id) != 0;
+            size_t word = static_cast<size_t>(id) >> 6;
+            return word < bits_.size() && (bits_[word] >> (id & 63) & 1) != 0;
+        }
+
+    private:
+        static constexpr int kBitmapLimit = 1 << 27;
+        std::vector<uint64_t> bits_;
+        std::unordered_set<int> large_;
+    };
+
+    // 按文件顺序查重：编号再次出现的行记为重复（修复时保留第一次出现的行）；全部编号记入 ids
+    static void findDuplicates(std::vector<detail::ChunkResult>& chunks, const Options& options, IdSet& ids) {
+        for (detail::ChunkResult& chunk : chunks) {
+            std::vector<detail::Fix> extra;
+            for (const auto& entry : chunk.ids) {
+                int id = entry.first;
+                if (ids.insert(id)) continue;
+                // 修复时移入 .rejects，由人工决定保留哪一行
+                reject(chunk, options, entry.second, id, Issue::DuplicateId, 0, std::to_string(id), extra);
+            }
+            mergeRejects(chunk, extra);
+        }
+    }
+
+    // 上级编号不在花名册中的行需要人工处理
+    static void findUnknownManagers(std::vector<detail::ChunkResult>& chunks, const Options& options, const IdSet& ids) {
+        for (detail::ChunkResult& chunk : chunks) {
+            std::vector<detail::Fix> extra;
+            size_t next = 0;  // chunk.ids 与 chunk.managers 均按行序号升序
+            for (const auto& entry : chunk.managers) {
+                if (ids.contains(entry.first)) continue;
+                while (next < chunk.ids.size() && chunk.ids[next].second < entry.second) ++next;
+                int id = next < chunk.ids.size() && chunk.ids[next].second == entry.second ? chunk.ids[next].first : 0;
+                reject(chunk, options, entry.second, id, Issue::UnknownManager, kManagerColumn,
+                       std::to_string(entry.first), extra);
+            }
+            mergeRejects(chunk, extra);
+        }
+    }
+
+    // 记录一条跨行检查发现的问题，并把该行改记为需人工处理
+    static void reject(detail::ChunkResult& chunk, const Options& options, uint32_t row, int id, Issue issue,
+                       int column, std::string value, std::vector<detail::Fix>& extra) {
+        Report& report = chunk.report;
+        ++report.counts[static_cast<size_t>(issue)];
+        Finding f;
+        f.line = chunk.rowLines[row];
+        f.id = id;
+        f.issue = issue;
+        f.column = static_cast<int8_t>(column);
+        f.repairable = false;
+        f.value = std::move(value);
+        if (report.findings.size() < options.maxFindings) report.findings.push_back(std::move(f));
+        else report.truncated = true;
+        if (!options.repairPath.empty()) extra.push_back(detail::Fix{row, true, std::string()});
+        rescore(chunk, row);
+    }
+
+    // 被拒绝的行整体移入 .rejects，覆盖该行原有的修复动作（两个列表均按行序号升序）
+    static void mergeRejects(detail::ChunkResult& chunk, std::vector<detail::Fix>& extra) {
+        if (extra.empty()) return;
+        std::vector<detail::Fix> merged;
+        merged.reserve(chunk.fixes.size() + extra.size());
+        size_t i = 0;
+        for (detail::Fix& fix : chunk.fixes) {
+            while (i < extra.size() && extra[i].row < fix.row) merged.push_back(std::move(extra[i++]));
+            if (i < extra.size() && extra[i].row == fix.row) continue;
+            merged.push_back(std::move(fix));
+        }
+        while (i < extra.size()) merged.push_back(std::move(extra[i++]));
+        chunk.fixes.swap(merged);
+    }
+
+    // 该行改记为需人工处理
+    static void rescore(detail::ChunkResult& chunk, uint32_t row) {
+        Report& report = chunk.report;
+        uint8_t& state = chunk.rowStates[row];
+        if (state == detail::Rejected) return;
+        if (state == detail::Repaired) --report.repairedRows;
+        else --report.cleanRows;
+        ++report.rejectedRows;
+        state = detail::Rejected;
+    }
+
+    static void merge(std::vector<detail::ChunkResult>& chunks, const Options& options, Report& report) {
+        report = Report();
+        uint64_t base = 0;
+        for (detail::ChunkResult& chunk : chunks) {
+            Report& part = chunk.report;
+            std::sort(part.findings.begin(), part.findings.end(),
+                      [](const Finding& a, const Finding& b) { return a.line < b.line; });
+            report.lines += chunk.lines;
+            report.rows += part.rows;
+            report.cleanRows += part.cleanRows;
+            report.repairedRows += part.repairedRows;
+            report.rejectedRows += part.rejectedRows;
+            report.truncated = report.truncated || part.truncated;
+            for (size_t i = 0; i < report.counts.size(); ++i) report.counts[i] += part.counts[i];
+            for (Finding& f : part.findings) {
+                if (report.findings.size() >= options.maxFindings) {
+                    report.truncated = true;
+                    break;
+                }
+                f.line += base;
+                report.findings.push_back(std::move(f));
+            }
+            base += chunk.lines;
+        }
+    }
+
+    // 按原顺序写出：无问题的行原样复制，可修复的行写修复后的内容，其余行写入 .rejects
+    static bool writeRepaired(const std::vector<detail::ChunkResult>& chunks, const std::string& path, std::string* error) {
+        roster_io::RosterWriter out, rejects;
+        if (!out.open(path) || !rejects.open(path + ".rejects")) {
+            if (error) *error = "无法写入 " + path;
+            return false;
+        }
+        out.write(ShardedStore::kHeader);
+        rejects.write(ShardedStore::kHeader);
+        std::string buffer;
+        for (const detail::ChunkResult& chunk : chunks) {
+            size_t next = 0;
+            uint32_t row = 0;
+            uint64_t lineNo = 0;
+            const char* p = chunk.begin;
+            while (p < chunk.end) {
+                const char* nl = static_cast<const char*>(std::memchr(p, '\n', chunk.end - p));
+                const char* stop = nl ? nl : chunk.end;
+                const char* e = (stop > p && stop[-1] == '\r') ? stop - 1 : stop;
+                ++lineNo;
+                bool isData = e > p && (row < chunk.rowLines.size() && chunk.rowLines[row] == lineNo);
+                if (isData) {
+                    if (next < chunk.fixes.size() && chunk.fixes[next].row == row) {
+                        const detail::Fix& fix = chunk.fixes[next++];
+                        if (fix.reject) {
+                            rejects.write(std::string(p, e) + "\n");
+                        } else {
+                            buffer += fix.replacement;
+                            buffer += '\n';
+                        }
+                    } else {
+                        buffer.append(p, e);
+                        buffer += '\n';
+                    }
+                    ++row;
+                }
+                if (buffer.size() >= (1 << 20)) {
+                    out.write(buffer);
+                    buffer.clear();
+                }
+                p = stop + 1;
+            }
+        }
+        out.write(buffer);
+        bool ok = out.close() && rejects.close();
+        if (!ok && error) *error = "写入 " + path + " 失败";
+        return ok;
+    }
+};
+
+} // namespace validate
+
+#endif // ROSTERVALIDATOR_H
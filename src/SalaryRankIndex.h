@@ -0,0 +1,107 @@
+#ifndef SALARYRANKINDEX_H
+#define SALARYRANKINDEX_H
+
+#include <vector>
+#include <memory>
+#include <climits>
+
+#include "Employee.h"
+#include "ColumnSnapshot.h"
+#include "OrderStatisticTree.h"
+
+/**
+ * 月薪排名索引 (SalaryRankIndex)
+ * - 以 (月薪, 编号) 为键维护全员及各岗位的顺序统计树，排序规则与业绩排名一致：
+ *   月薪从高到低，同薪按编号从小到大
+ * - 由 EmployeeManager 在增删改时同步维护（全员提级不影响月薪，无需更新）
+ * - 员工名次、第 k 名、月薪区间人数均为 O(log n)，分页排名为 O(log n + 每页条数)，无需重新排序
+ * - 名次从 1 开始；role 参数为 ColumnSnapshot::RoleCode，-1 表示全员
+ */
+class SalaryRankIndex {
+public:
+    struct Key {
+        double salary;
+        int id;
+    };
+
+private:
+    struct RankOrder {
+        bool operator()(const Key& a, const Key& b) const {
+            return a.salary > b.salary || (a.salary == b.salary && a.id < b.id);
+        }
+    };
+    using Tree = OrderStatisticTree<Key, RankOrder>;
+
+    Tree all_;
+    Tree roles_[roles::kCount];
+
+    const Tree& tree(int role) const { return role >= 0 && role < static_cast<int>(roles::kCount) ? roles_[role] : all_; }
+
+    static Key keyOf(const Employee& emp) { return {emp.calculateSalary(), emp.getId()}; }
+
+public:
+    void build(const std::vector<const Employee*>& employees) {
+        std::vector<Key> all;
+        std::vector<Key> byRole[roles::kCount];
+        all.reserve(employees.size());
+        for (const Employee* emp : employees) {
+            Key key = keyOf(*emp);
+            all.push_back(key);
+            uint8_t role = ColumnSnapshot::roleCode(emp->getRoleName());
+            if (role < roles::kCount) byRole[role].push_back(key);
+        }
+        all_.build(std::move(all));
+        for (size_t r = 0; r < roles::kCount; ++r) roles_[r].build(std::move(byRole[r]));
+    }
+
+    // 须在员工月薪或岗位变化之前调用 remove，变化之后调用 add
+    void add(const Employee& emp) {
+        Key key = keyOf(emp);
+        all_.insert(key);
+        uint8_t role = ColumnSnapshot::roleCode(emp.getRoleName());
+        if (role < roles::kCount) roles_[role].insert(key);
+    }
+
+    void remove(const Employee& emp) {
+        Key key = keyOf(emp);
+        all_.erase(key);
+        uint8_t role = ColumnSnapshot::roleCode(emp.getRoleName());
+        if (role < roles::kCount) roles_[role].erase(key);
+    }
+
+    size_t size(int role = -1) const { return tree(role).size(); }
+
+    // 员工的名次（从 1 开始）
+    size_t rankOf(const Employee& emp, int role = -1) const {
+        return tree(role).countLess(keyOf(emp)) + 1;
+    }
+
+    // 第 rank 名（从 1 开始，须不超过 size(role)）
+    const Key& at(size_t rank, int role = -1) const { return tree(role).at(rank - 1); }
+
+    // 月薪高于等于 salary 的人数
+    size_t countAtLeast(double salary, int role = -1) const {
+        return tree(role).countLess({salary, INT_MAX});
+    }
+
+    // 月薪严格高于 salary 的人数
+    size_t countAbove(double salary, int role = -1) const {
+        return tree(role).countLess({salary, INT_MIN});
+    }
+
+    // 月薪在 [low, high] 内的人数
+    size_t countBetween(double low, double high, int role = -1) const {
+        if (low > high) return 0;
+        return countAtLeast(low, role) - countAbove(high, role);
+    }
+
+    // 第 first 名起（从 1 开始）的 count 个键
+    std::vector<Key> page(size_t first, size_t count, int role = -1) const {
+        std::vector<Key> result;
+        if (first == 0) first = 1;
+        tree(role).forEachInRange(first - 1, count, [&](size_t, const Key& key) { result.push_back(key); });
+        return result;
+    }
+};
+
+#endif // SALARYRANKINDEX_H
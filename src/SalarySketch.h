@@ -0,0 +1,272 @@
+#ifndef SALARYSKETCH_H
+#define SALARYSKETCH_H
+
+#include <array>
+#include <map>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <ostream>
+#include <sstream>
+#include <iomanip>
+#include <cstdint>
+#include <algorithm>
+
+#include "RoleRegistry.h"
+
+/**
+ * 薪资分位数草图 (SalarySketch)
+ * - 对数分桶直方图：第 i 桶覆盖 (γ^(i-1), γ^i]，γ = (1+α)/(1-α)，取桶的代表值作答，
+ *   任意分位数的相对误差不超过 α（0.5%）；低于 1 元的值（含 0）单独计入零桶
+ * - 桶数固定（2048 桶覆盖到约 7.8 亿元，超出者计入最后一桶），内存约 8KB，与人数无关
+ * - 计数可加可减：员工增删改时增量维护；两份草图逐桶相加即合并，可分片/分线程并行构建
+ * - 每 64 桶另记块计数，求分位数先按块跳过，再在块内定位，耗时为固定的常数
+ */
+class SalarySketch {
+public:
+    static constexpr double kRelativeError = 0.005;
+    static constexpr double kMinValue = 1.0;
+    static constexpr size_t kBuckets = 2048;
+    static constexpr size_t kBlockSize = 64;
+    static constexpr size_t kBlocks = kBuckets / kBlockSize;
+
+    void add(double value) { adjust(value, 1); }
+
+    // 移除一个此前加入过的值（计数为 0 时忽略）
+    void remove(double value) { adjust(value, -1); }
+
+    void merge(const SalarySketch& other) {
+        zeroCount_ += other.zeroCount_;
+        count_ += other.count_;
+        for (size_t i = 0; i < kBuckets; ++i) counts_[i] += other.counts_[i];
+        for (size_t b = 0; b < kBlocks; ++b) blockCounts_[b] += other.blockCounts_[b];
+    }
+
+    void clear() { *this = SalarySketch(); }
+
+    uint64_t count() const { return count_; }
+    bool empty() const { return count_ == 0; }
+
+    // q ∈ [0, 1]；返回第 floor(q * (n-1)) 小的值的近似（空草图返回 0）
+    double quantile(double q) const {
+        if (count_ == 0) return 0.0;
+        q = std::min(1.0, std::max(0.0, q));
+        uint64_t rank = static_cast<uint64_t>(q * static_cast<double>(count_ - 1));
+
+        if (rank < zeroCount_) return 0.0;
+        rank -= zeroCount_;
+        size_t b = 0;
+        while (rank >= blockCounts_[b]) rank -= blockCounts_[b++];
+        size_t i = b * kBlockSize;
+        while (rank >= counts_[i]) rank -= counts_[i++];
+        return representative(i);
+    }
+
+    // 按给定分界统计人数：第 k 个结果为代表值落在 [edges[k], edges[k+1]) 的人数（edges 升序）
+    std::vector<uint64_t> histogram(const std::vector<double>& edges) const {
+        std::vector<uint64_t> bins(edges.size() < 2 ? 0 : edges.size() - 1, 0);
+        if (bins.empty()) return bins;
+        auto place = [&](double value, uint64_t n) {
+            auto it = std::upper_bound(edges.begin(), edges.end(), value);
+            if (it == edges.begin() || it == edges.end()) return;
+            bins[static_cast<size_t>(it - edges.begin()) - 1] += n;
+        };
+        place(0.0, zeroCount_);
+        for (size_t b = 0; b < kBlocks; ++b) {
+            if (blockCounts_[b] == 0) continue;
+            for (size_t i = b * kBlockSize; i < (b + 1) * kBlockSize; ++i) {
+                if (counts_[i]) place(representative(i), counts_[i]);
+            }
+        }
+        return bins;
+    }
+
+    // 最大值的近似（空草图返回 0）
+    double maxValue() const { return quantile(1.0); }
+
+    static constexpr size_t memoryBytes() { return sizeof(SalarySketch); }
+
+private:
+    std::array<uint32_t, kBuckets> counts_{};
+    std::array<uint32_t, kBlocks> blockCounts_{};
+    uint64_t zeroCount_ = 0;
+    uint64_t count_ = 0;
+
+    static double gamma() {
+        static const double g = (1 + kRelativeError) / (1 - kRelativeError);
+        return g;
+    }
+
+    static double logGamma() {
+        static const double lg = std::log(gamma());
+        return lg;
+    }
+
+    static size_t bucketOf(double value) {
+        double i = std::ceil(std::log(value) / logGamma());
+        return i >= static_cast<double>(kBuckets) ? kBuckets - 1 : static_cast<size_t>(i);
+    }
+
+    // 桶内任一值与代表值的相对误差不超过 α
+    static double representative(size_t i) {
+        return 2.0 * std::pow(gamma(), static_cast<double>(i)) / (gamma() + 1.0);
+    }
+
+    void adjust(double value, int delta) {
+        if (!(value >= kMinValue)) {
+            if (delta < 0 && zeroCount_ == 0) return;
+            zeroCount_ += delta;
+        } else {
+            size_t i = bucketOf(value);
+            if (delta < 0 && counts_[i] == 0) return;
+            counts_[i] += delta;
+            blockCounts_[i / kBlockSize] += delta;
+        }
+        count_ += delta;
+    }
+};
+
+/**
+ * 薪资分布 (SalaryDistribution)
+ * - 全员、各岗位（按 ColumnSnapshot::RoleCode）、各级别各一份 SalarySketch
+ * - 由 EmployeeManager 随二级索引一起维护，流式统计模式按分片并行构建后合并
+ * - 报告给出中位数 / P90 / P99 及全员月薪的对数分段直方图
+ */
+class SalaryDistribution {
+public:
+    SalarySketch all;
+    SalarySketch byRole[roles::kCount];
+    std::map<int, SalarySketch> levels;
+
+    void clear() {
+        all.clear();
+        for (auto& r : byRole) r.clear();
+        levels.clear();
+    }
+
+    // role 不是已登记的岗位编码时只计入全员与级别
+    void add(int role, int level, double salary) {
+        all.add(salary);
+        if (role >= 0 && role < static_cast<int>(roles::kCount)) byRole[role].add(salary);
+        levels[level].add(salary);
+    }
+
+    void remove(int role, int level, double salary) {
+        all.remove(salary);
+        if (role >= 0 && role < static_cast<int>(roles::kCount)) byRole[role].remove(salary);
+        auto it = levels.find(level);
+        if (it != levels.end()) {
+            it->second.remove(salary);
+            if (it->second.empty()) levels.erase(it);
+        }
+    }
+
+    void merge(const SalaryDistribution& other) {
+        all.merge(other.all);
+        for (size_t r = 0; r < roles::kCount; ++r) byRole[r].merge(other.byRole[r]);
+        for (const auto& kv : other.levels) levels[kv.first].merge(kv.second);
+    }
+
+    // 全员级别统一增加 delta：只需整体平移级别键
+    void shiftLevels(int delta) {
+        std::map<int, SalarySketch> shifted;
+        for (auto& kv : levels) shifted.emplace(kv.first + delta, std::move(kv.second));
+        levels.swap(shifted);
+    }
+
+    size_t memoryBytes() const { return (1 + roles::kCount + levels.size()) * SalarySketch::memoryBytes(); }
+
+    void print(std::ostream& os) const {
+        os << std::fixed << std::setprecision(2);
+        os << "\n========== 薪资分布 ==========" << std::endl;
+        os << "（分位数为近似值，相对误差不超过 " << SalarySketch::kRelativeError * 100 << "%）" << std::endl;
+        printLine(os, "全员", all);
+        os << "\n按岗位:" << std::endl;
+        for (uint8_t r = 0; r < roles::kCount; ++r) printLine(os, std::string("  ") + roles::label(r), byRole[r]);
+        os << "\n按级别:" << std::endl;
+        for (const auto& kv : levels) printLine(os, "  " + std::to_string(kv.first) + " 级", kv.second);
+
+        std::vector<double> edges = histogramEdges();
+        if (!edges.empty()) {
+            std::vector<uint64_t> bins = all.histogram(edges);
+            uint64_t peak = std::max<uint64_t>(1, *std::max_element(bins.begin(), bins.end()));
+            os << "\n月薪分布（全员）:" << std::endl;
+            for (size_t k = 0; k < bins.size(); ++k) {
+                std::ostringstream range;
+                range << std::fixed << std::setprecision(0) << "[" << edges[k] << ", " << edges[k + 1] << ")";
+                os << "  " << std::left << std::setw(20) << range.str() << std::right
+                   << std::setw(10) << bins[k] << "  "
+                   << bar(40 * bins[k] / peak) << std::endl;
+            }
+        }
+        os << "==============================" << std::endl;
+    }
+
+    std::string toJSON() const {
+        std::ostringstream oss;
+        oss << std::fixed << std::setprecision(2);
+        oss << "{\"relativeError\":" << SalarySketch::kRelativeError << ",\"all\":";
+        writeSummary(oss, all);
+        oss << ",\"roles\":{";
+        for (uint8_t r = 0; r < roles::kCount; ++r) {
+            if (r) oss << ',';
+            oss << '"' << roles::name(r) << "\":";
+            writeSummary(oss, byRole[r]);
+        }
+        oss << "},\"levels\":{";
+        bool first = true;
+        for (const auto& kv : levels) {
+            if (!first) oss << ',';
+            first = false;
+            oss << '"' << kv.first << "\":";
+            writeSummary(oss, kv.second);
+        }
+        oss << "},\"histogram\":[";
+        std::vector<double> edges = histogramEdges();
+        std::vector<uint64_t> bins = all.histogram(edges);
+        for (size_t k = 0; k < bins.size(); ++k) {
+            if (k) oss << ',';
+            oss << "{\"min\":" << edges[k] << ",\"max\":" << edges[k + 1] << ",\"count\":" << bins[k] << '}';
+        }
+        oss << "]}";
+        return oss.str();
+    }
+
+private:
+    static void printLine(std::ostream& os, const std::string& label, const SalarySketch& s) {
+        os << label << ": " << s.count() << " 人";
+        if (!s.empty()) {
+            os << ", 中位数 " << s.quantile(0.5) << ", P90 " << s.quantile(0.9)
+               << ", P99 " << s.quantile(0.99) << " 元";
+        }
+        os << std::endl;
+    }
+
+    static void writeSummary(std::ostream& os, const SalarySketch& s) {
+        os << "{\"count\":" << s.count() << ",\"p50\":" << s.quantile(0.5)
+           << ",\"p90\":" << s.quantile(0.9) << ",\"p99\":" << s.quantile(0.99) << '}';
+    }
+
+    // 直方图分界：0, 1000, 2000, 4000, ... 倍增至覆盖最高月薪
+    std::vector<double> histogramEdges() const {
+        std::vector<double> edges;
+        if (all.empty()) return edges;
+        double top = all.maxValue();
+        edges.push_back(0.0);
+        double edge = 1000.0;
+        edges.push_back(edge);
+        while (edge <= top) {
+            edge *= 2;
+            edges.push_back(edge);
+        }
+        return edges;
+    }
+
+    static std::string bar(uint64_t width) {
+        std::string s;
+        for (uint64_t i = 0; i < width; ++i) s += "█";
+        return s;
+    }
+};
+
+#endif // SALARYSKETCH_H
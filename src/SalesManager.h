@@ -24,26 +24,48 @@ public:
           fixedSalary_(fixedSalary), commissionRate_(commissionRate), salesAmount_(salesAmount) {}
 
     // ========== 访问器 ==========
-    double getFixedSalary() const { return fixedSalary_; }
-    void setFixedSalary(double salary) { fixedSalary_ = salary; }
+    double getFixedSalary() const { ensureSpecific(); return fixedSalary_; }
+    void setFixedSalary(double salary) { ensureSpecific(); fixedSalary_ = salary; }
     
-    double getCommissionRate() const { return commissionRate_; }
-    void setCommissionRate(double rate) { commissionRate_ = rate; }
+    double getCommissionRate() const { ensureSpecific(); return commissionRate_; }
+    void setCommissionRate(double rate) { ensureSpecific(); commissionRate_ = rate; }
     
-    double getSalesAmount() const { return salesAmount_; }
-    void setSalesAmount(double amount) { salesAmount_ = amount; }
+    double getSalesAmount() const { ensureSpecific(); return salesAmount_; }
+    void setSalesAmount(double amount) { ensureSpecific(); salesAmount_ = amount; }
+
+    // ========== 岗位登记信息（见 RoleRegistry） ==========
+    static constexpr const char* kRoleName = "SalesManager";
+    static constexpr const char* kLabel = "销售经理";
+    static constexpr const char* kFullLabel = "销售经理";
+    static constexpr const char* kSalaryHint = "固定月薪 + 销售提成";
+    // CSV 参数列 param1..param3 对应的 JSON 字段（nullptr 表示该列不使用）
+    static constexpr const char* kParamKeys[3] = {"fixedSalary", "commissionRate", "salesAmount"};
+    // 各参数列的合理取值范围（数据校验使用，未使用的列不校验）
+    static constexpr ParamRange kParamRanges[3] = {{0, 1e6}, {0, 1}, {0, 1e10}};
+
+    // 由 CSV 参数列计算月薪（流式统计直接使用，无需构造对象）
+    static double salaryFromParams(double p1, double p2, double p3) {
+        return salaryFormula(p1, p2, p3);
+    }
 
     // ========== 实现纯虚函数 ==========
     
     std::string getRoleName() const override {
-        return "SalesManager";
+        return kRoleName;
+    }
+
+    // 薪资公式
+    static double salaryFormula(double fixedSalary, double commissionRate, double salesAmount) {
+        return fixedSalary + salesAmount * commissionRate;
     }
 
     double calculateSalary() const override {
-        return fixedSalary_ + salesAmount_ * commissionRate_;
+        ensureSpecific();
+        return salaryFormula(fixedSalary_, commissionRate_, salesAmount_);
     }
 
     void display() const override {
+        ensureSpecific();
         std::cout << "========== 销售经理信息 ==========" << std::endl;
         displayBasic();
         std::cout << std::fixed << std::setprecision(2);
@@ -55,6 +77,7 @@ public:
     }
 
     void inputSpecificInfo() override {
+        ensureSpecific();
         std::string s;
         
         std::cout << "固定月薪: ";
@@ -74,26 +97,55 @@ public:
     }
 
     std::string toCSV() const override {
+        ensureSpecific();
         // 格式: id,name,role,level,gender,fixedSalary,commissionRate,salesAmount
         // 为兼容统一格式，这里用: baseSalary=fixedSalary, hours=commissionRate, sales=salesAmount
         std::ostringstream oss;
         oss << basicToCSV() << ","
             << std::fixed << std::setprecision(2) << fixedSalary_ << ","
             << std::fixed << std::setprecision(4) << commissionRate_ << ","
-            << std::fixed << std::setprecision(2) << salesAmount_;
+            << std::fixed << std::setprecision(2) << salesAmount_
+            << managerToCSV();
         return oss.str();
     }
 
+    std::string toJSON() const override {
+        ensureSpecific();
+        std::ostringstream oss;
+        oss << basicToJSON()
+            << ",\"fixedSalary\":" << std::fixed << std::setprecision(2) << fixedSalary_
+            << ",\"commissionRate\":" << std::fixed << std::setprecision(4) << commissionRate_
+            << ",\"salesAmount\":" << std::fixed << std::setprecision(2) << salesAmount_ << "}";
+        return oss.str();
+    }
+
+    std::unique_ptr<Employee> clone() const override {
+        materialize();
+        return std::unique_ptr<Employee>(new SalesManager(*this));
+    }
+
+    std::array<double, 3> getParams() const override {
+        ensureSpecific();
+        return {fixedSalary_, commissionRate_, salesAmount_};
+    }
+
+    void setParams(const std::array<double, 3>& params) override {
+        ensureSpecific();
+        fixedSalary_ = params[0];
+        commissionRate_ = params[1];
+        salesAmount_ = params[2];
+    }
+
     void parseCSV(const std::vector<std::string>& cols) override {
         // cols[6] = fixedSalary, cols[7] = commissionRate, cols[8] = salesAmount
         if (cols.size() > 6) {
-            try { fixedSalary_ = std::stod(cols[6]); } catch (...) { fixedSalary_ = 0; }
+            try { fixedSalary_ = std::stod(cols[6]); } catch (...) { fixedSalary_ = 0; HR_METRIC_ADD(ParseFailures, 1); }
         }
         if (cols.size() > 7) {
-            try { commissionRate_ = std::stod(cols[7]); } catch (...) { commissionRate_ = 0; }
+            try { commissionRate_ = std::stod(cols[7]); } catch (...) { commissionRate_ = 0; HR_METRIC_ADD(ParseFailures, 1); }
         }
         if (cols.size() > 8) {
-            try { salesAmount_ = std::stod(cols[8]); } catch (...) { salesAmount_ = 0; }
+            try { salesAmount_ = std::stod(cols[8]); } catch (...) { salesAmount_ = 0; HR_METRIC_ADD(ParseFailures, 1); }
         }
     }
 };
@@ -0,0 +1,227 @@
+#ifndef SHARDEDSTORE_H
+#define SHARDEDSTORE_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <cstdio>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#include <direct.h>
+#endif
+
+#include "Employee.h"
+#include "RosterIO.h"
+
+/**
+ * 分片存储 (ShardedStore)
+ * - 目录布局：
+ *     <dir>/manifest.txt        分片清单（分片数、分区方式）
+ *     <dir>/shard-000.csv ...   各分片，格式与单文件 CSV 相同
+ * - 分区方式：hash（编号散列）或 range（编号区间，每片 rangeWidth 个编号，超出归入最后一片）
+ * - 加载与保存按分片并行；修改时只标记所在分片为脏，保存时只重写脏分片，
+ *   单人修改的写入量约为 N/分片数
+ * - 分片经 async_io 先写入临时文件，fsync 后再 rename，避免写到一半时损坏原数据
+ */
+class ShardedStore {
+public:
+    enum class Partition { Hash, Range };
+
+    static constexpr const char* kManifestName = "manifest.txt";
+    static constexpr const char* kHeader = "id,name,role,level,gender,birthday,param1,param2,param3,managerId\n";
+
+private:
+    std::string dir_;
+    size_t shards_ = 0;
+    Partition partition_ = Partition::Hash;
+    long long rangeWidth_ = 0;
+    std::vector<char> dirty_;  // 每个分片的脏标记（不用 vector<bool>，便于并行读写各元素）
+
+public:
+    // 判断路径是否为分片目录（含清单文件）
+    static bool isShardedPath(const std::string& path) {
+        std::ifstream in(manifestPath(path));
+        return in.is_open();
+    }
+
+    // 用不超过硬件线程数的线程池处理 [0, n) 的任务
+    template <typename Fn>
+    static void forEachShardParallel(size_t n, Fn fn) {
+        size_t threads = std::max<size_t>(1, std::min<size_t>(n, std::thread::hardware_concurrency()));
+        if (threads <= 1) {
+            for (size_t i = 0; i < n; ++i) fn(i);
+            return;
+        }
+        std::atomic<size_t> next(0);
+        std::vector<std::thread> pool;
+        for (size_t t = 0; t < threads; ++t) {
+            pool.emplace_back([&] {
+                for (size_t i = next++; i < n; i = next++) fn(i);
+            });
+        }
+        for (auto& th : pool) th.join();
+    }
+
+    // 打开已有分片目录，清单缺失或格式错误时返回 false
+    bool open(const std::string& dir) {
+        std::ifstream in(manifestPath(dir));
+        if (!in.is_open()) return false;
+
+        dir_ = dir;
+        shards_ = 0;
+        partition_ = Partition::Hash;
+        rangeWidth_ = 0;
+
+        std::string line;
+        while (std::getline(in, line)) {
+            if (line.empty() || line[0] == '#') continue;
+            size_t eq = line.find('=');
+            if (eq == std::string::npos) continue;
+            std::string key = line.substr(0, eq);
+            std::string value = line.substr(eq + 1);
+            try {
+                if (key == "shards") shards_ = static_cast<size_t>(std::stoul(value));
+                else if (key == "partition") partition_ = (value == "range") ? Partition::Range : Partition::Hash;
+                else if (key == "range_width") rangeWidth_ = std::stoll(value);
+            } catch (...) {
+                return false;
+            }
+        }
+        if (shards_ == 0) return false;
+        if (partition_ == Partition::Range && rangeWidth_ <= 0) return false;
+        dirty_.assign(shards_, 0);
+        return true;
+    }
+
+    // 新建分片目录并写入清单（不写分片数据）
+    bool create(const std::string& dir, size_t shards, Partition partition, long long rangeWidth) {
+        if (shards == 0) return false;
+        if (partition == Partition::Range && rangeWidth <= 0) return false;
+        makeDirectory(dir);
+
+        std::ofstream out(manifestPath(dir));
+        if (!out.is_open()) return false;
+        out << "# 员工数据分片清单\n"
+            << "version=1\n"
+            << "shards=" << shards << "\n"
+            << "partition=" << (partition == Partition::Range ? "range" : "hash") << "\n"
+            << "range_width=" << rangeWidth << "\n";
+        out.close();
+        return open(dir);
+    }
+
+    size_t shardCount() const { return shards_; }
+    const std::string& directory() const { return dir_; }
+    Partition partition() const { return partition_; }
+
+    // 员工编号所在分片
+    size_t shardOf(int id) const {
+        if (partition_ == Partition::Range) {
+            long long idx = (static_cast<long long>(id) - 1) / rangeWidth_;
+            if (idx < 0) idx = 0;
+            return std::min(static_cast<size_t>(idx), shards_ - 1);
+        }
+        // Fibonacci 散列，使连续编号均匀分布
+        uint32_t h = static_cast<uint32_t>(id) * 2654435761u;
+        return static_cast<size_t>(h) % shards_;
+    }
+
+    std::string shardPath(size_t shard) const {
+        char name[32];
+        std::snprintf(name, sizeof(name), "shard-%03zu.csv", shard);
+        return dir_ + "/" + name;
+    }
+
+    void markDirty(int id) { dirty_[shardOf(id)] = 1; }
+    void markAllDirty() { std::fill(dirty_.begin(), dirty_.end(), 1); }
+
+    // 并行加载所有分片。parse 将一行 CSV 解析为员工对象（失败返回 nullptr）
+    template <typename Parser>
+    std::vector<std::unique_ptr<Employee>> loadAll(Parser parse) {
+        std::vector<std::vector<std::unique_ptr<Employee>>> parts(shards_);
+        forEachShardParallel(shards_, [&](size_t shard) {
+            roster_io::forEachLine(shardPath(shard), [&](const std::string& line) {
+                if (line.empty() || line.compare(0, 3, "id,") == 0) return;
+                std::unique_ptr<Employee> emp = parse(line);
+                if (emp) parts[shard].push_back(std::move(emp));
+            });
+        });
+
+        size_t total = 0;
+        for (const auto& p : parts) total += p.size();
+        std::vector<std::unique_ptr<Employee>> all;
+        all.reserve(total);
+        for (auto& p : parts) {
+            for (auto& emp : p) all.push_back(std::move(emp));
+        }
+        std::fill(dirty_.begin(), dirty_.end(), 0);
+        return all;
+    }
+
+    // 并行重写所有脏分片，返回写入的分片数；写入失败的分片保持脏标记
+    size_t saveDirty(const std::vector<std::unique_ptr<Employee>>& employees) {
+        std::vector<size_t> targets;
+        for (size_t i = 0; i < shards_; ++i) {
+            if (dirty_[i]) targets.push_back(i);
+        }
+        if (targets.empty()) return 0;
+
+        // 一次遍历把脏分片的员工分桶（只取指针，不序列化非脏分片）
+        std::vector<std::vector<const Employee*>> buckets(shards_);
+        for (const auto& emp : employees) {
+            size_t s = shardOf(emp->getId());
+            if (dirty_[s]) buckets[s].push_back(emp.get());
+        }
+
+        std::atomic<size_t> written(0);
+        forEachShardParallel(targets.size(), [&](size_t i) {
+            size_t shard = targets[i];
+            if (writeShard(shard, buckets[shard])) {
+                dirty_[shard] = 0;
+                written++;
+            }
+        });
+        return written;
+    }
+
+    // 写入全部分片（迁移时使用）
+    size_t saveAll(const std::vector<std::unique_ptr<Employee>>& employees) {
+        markAllDirty();
+        return saveDirty(employees);
+    }
+
+private:
+    static std::string manifestPath(const std::string& dir) {
+        return dir + "/" + kManifestName;
+    }
+
+    static void makeDirectory(const std::string& dir) {
+#ifdef _WIN32
+        _mkdir(dir.c_str());
+#else
+        ::mkdir(dir.c_str(), 0755);
+#endif
+    }
+
+    bool writeShard(size_t shard, const std::vector<const Employee*>& rows) const {
+        std::string buf = kHeader;
+        for (const Employee* emp : rows) {
+            buf += emp->toCSV();
+            buf += '\n';
+        }
+        HR_METRIC_ADD(BytesWritten, buf.size());
+
+        async_io::FileWriter out;
+        if (!out.open(shardPath(shard))) return false;
+        out.write(buf);
+        return out.commit();
+    }
+};
+
+#endif // SHARDEDSTORE_H
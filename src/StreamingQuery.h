@@ -0,0 +1,250 @@
+#ifndef STREAMINGQUERY_H
+#define STREAMINGQUERY_H
+
+#include <string>
+#include <vector>
+#include <queue>
+#include <climits>
+#include <charconv>
+#include <cstring>
+#include <algorithm>
+
+#include "EmployeeManager.h"
+#include "RosterIO.h"
+
+/**
+ * 流式统计 (StreamingQuery)
+ * - 用于一次性审计超大花名册：行从分词器直接流入 过滤 → 聚合 / 前 K 名 算子，
+ *   不构造 Employee 对象，内存只与 K 有关，与文件行数无关
+ * - 岗位经 RoleRegistry 查表分派，薪资计算复用各岗位类的 salaryFromParams()，
+ *   报告格式与 statistics()/ranking() 一致
+ * - 同时累积月薪分位数草图（SalarySketch，内存固定），报告附中位数 / P90 / P99
+ * - 支持普通 CSV 与 .lz4 压缩文件（经 RosterIO 边解压边解析）
+ * - 分片目录按分片并行扫描，各分片的部分结果最后合并
+ */
+class StreamingQuery {
+public:
+    // 行过滤条件（空字符串 / 默认范围表示不过滤）
+    struct Filter {
+        std::string role;
+        std::string gender;
+        int minLevel = INT_MIN;
+        int maxLevel = INT_MAX;
+    };
+
+    struct RankEntry {
+        double salary;
+        int id;
+        std::string name;
+        std::string role;
+    };
+
+private:
+    // 一行 CSV 的字段视图（不拷贝）
+    struct RowView {
+        static constexpr size_t kMaxFields = 10;
+        const char* begin[kMaxFields];
+        size_t len[kMaxFields];
+        size_t count = 0;
+
+        bool equals(size_t i, const std::string& s) const {
+            return len[i] == s.size() && std::memcmp(begin[i], s.data(), len[i]) == 0;
+        }
+    };
+
+    // 最小堆比较：薪资低者在堆顶，便于淘汰
+    struct MinSalaryFirst {
+        bool operator()(const RankEntry& a, const RankEntry& b) const {
+            return a.salary > b.salary;
+        }
+    };
+
+    Filter filter_;
+    size_t topK_;
+    EmployeeManager::SalaryStatistics stats_;
+    SalaryDistribution distribution_;
+    std::priority_queue<RankEntry, std::vector<RankEntry>, MinSalaryFirst> top_;
+    size_t rowsScanned_ = 0;
+    size_t rowsSkipped_ = 0;
+    bool sawFirstLine_ = false;
+
+public:
+    StreamingQuery(size_t topK, const Filter& filter) : filter_(filter), topK_(topK) {}
+
+    // 扫描整个文件（或分片目录下的全部分片），返回读取状态
+    roster_io::ReadStatus run(const std::string& path, std::string* error = nullptr) {
+        if (!ShardedStore::isShardedPath(path)) return runFile(path, error);
+
+        ShardedStore store;
+        if (!store.open(path)) return roster_io::ReadStatus::Corrupt;
+        size_t n = store.shardCount();
+        std::vector<StreamingQuery> partials(n, StreamingQuery(topK_, filter_));
+        std::vector<roster_io::ReadStatus> statuses(n, roster_io::ReadStatus::Ok);
+        std::vector<std::string> errors(n);
+        ShardedStore::forEachShardParallel(n, [&](size_t i) {
+            statuses[i] = partials[i].runFile(store.shardPath(i), &errors[i]);
+        });
+
+        roster_io::ReadStatus result = roster_io::ReadStatus::Ok;
+        for (size_t i = 0; i < n; ++i) {
+            merge(partials[i]);
+            if (statuses[i] == roster_io::ReadStatus::Corrupt && result != roster_io::ReadStatus::Corrupt) {
+                result = statuses[i];
+                if (error) *error = errors[i];
+            }
+        }
+        return result;
+    }
+
+    // 合并另一份扫描（通常是另一个分片）的结果
+    void merge(const StreamingQuery& other) {
+        stats_.employees += other.stats_.employees;
+        stats_.total += other.stats_.total;
+        for (size_t r = 0; r < roles::kCount; ++r) {
+            stats_.byRole[r].count += other.stats_.byRole[r].count;
+            stats_.byRole[r].total += other.stats_.byRole[r].total;
+        }
+        distribution_.merge(other.distribution_);
+        for (const RankEntry& e : other.topEntries()) offer(e.salary, e.id, e.name, e.role);
+        rowsScanned_ += other.rowsScanned_;
+        rowsSkipped_ += other.rowsSkipped_;
+    }
+
+    roster_io::ReadStatus runFile(const std::string& path, std::string* error = nullptr) {
+        sawFirstLine_ = false;
+        return roster_io::forEachLine(path, [this](const std::string& line) { consume(line); }, error);
+    }
+
+    // 处理一行
+    void consume(const std::string& line) {
+        if (line.empty()) return;
+        if (!sawFirstLine_) {
+            sawFirstLine_ = true;
+            if (line.compare(0, 3, "id,") == 0) return;  // 表头
+        }
+        ++rowsScanned_;
+
+        RowView row;
+        split(line, row);
+        if (row.count < 5) { ++rowsSkipped_; return; }
+
+        int id = 0;
+        if (!parseInt(row, 0, id)) { ++rowsSkipped_; return; }
+        int level = 1;
+        parseInt(row, 3, level);
+
+        // 过滤
+        if (!filter_.role.empty() && !row.equals(2, filter_.role)) return;
+        if (!filter_.gender.empty() && !row.equals(4, filter_.gender)) return;
+        if (level < filter_.minLevel || level > filter_.maxLevel) return;
+
+        double p1 = parseDouble(row, 6), p2 = parseDouble(row, 7), p3 = parseDouble(row, 8);
+        uint8_t role = roles::code(std::string_view(row.begin[2], row.len[2]));
+        if (role == roles::kUnknown) {
+            ++rowsSkipped_;  // 未知岗位，与 load() 一致地忽略
+            return;
+        }
+        double salary = roles::salaryFromParams(role, p1, p2, p3);
+        EmployeeManager::RoleTotals* bucket = &stats_.byRole[role];
+
+        // 聚合
+        stats_.employees++;
+        stats_.total += salary;
+        bucket->count++;
+        bucket->total += salary;
+        distribution_.add(role, level, salary);
+
+        // 前 K 名：只有进入堆的行才拷贝姓名
+        if (topK_ == 0) return;
+        if (top_.size() < topK_ || salary > top_.top().salary) {
+            offer(salary, id, field(row, 1), field(row, 2));
+        }
+    }
+
+    const EmployeeManager::SalaryStatistics& statistics() const { return stats_; }
+    const SalaryDistribution& distribution() const { return distribution_; }
+    size_t rowsScanned() const { return rowsScanned_; }
+    size_t rowsSkipped() const { return rowsSkipped_; }
+
+    // 前 K 名，按薪资从高到低
+    std::vector<RankEntry> topEntries() const {
+        auto heap = top_;
+        std::vector<RankEntry> result;
+        result.reserve(heap.size());
+        while (!heap.empty()) {
+            result.push_back(heap.top());
+            heap.pop();
+        }
+        std::reverse(result.begin(), result.end());
+        return result;
+    }
+
+    // 输出与 statistics()/ranking() 相同格式的报告
+    void printReport() const {
+        if (stats_.employees == 0) {
+            std::cout << "没有符合条件的员工记录。" << std::endl;
+        } else {
+            EmployeeManager::printStatistics(stats_);
+            distribution_.print(std::cout);
+        }
+        if (topK_ > 0 && !top_.empty()) {
+            std::cout << "\n========== 业绩排名 (按月薪, 前 " << topK_ << " 名) ==========" << std::endl;
+            int rank = 1;
+            for (const auto& e : topEntries()) {
+                EmployeeManager::printRankingLine(rank++, e.name, e.role, e.salary);
+            }
+            std::cout << "=======================================" << std::endl;
+        }
+        std::cout << "扫描 " << rowsScanned_ << " 行，跳过无效行 " << rowsSkipped_ << " 行。" << std::endl;
+    }
+
+private:
+    void offer(double salary, int id, const std::string& name, const std::string& role) {
+        if (topK_ == 0) return;
+        if (top_.size() < topK_) {
+            top_.push({salary, id, name, role});
+        } else if (salary > top_.top().salary) {
+            top_.pop();
+            top_.push({salary, id, name, role});
+        }
+    }
+
+    static void split(const std::string& line, RowView& row) {
+        const char* p = line.data();
+        const char* end = p + line.size();
+        row.count = 0;
+        while (row.count < RowView::kMaxFields) {
+            const char* comma = static_cast<const char*>(std::memchr(p, ',', end - p));
+            const char* stop = comma ? comma : end;
+            row.begin[row.count] = p;
+            row.len[row.count] = static_cast<size_t>(stop - p);
+            row.count++;
+            if (!comma) break;
+            p = comma + 1;
+        }
+    }
+
+    static std::string field(const RowView& row, size_t i) {
+        return std::string(row.begin[i], row.len[i]);
+    }
+
+    static bool parseInt(const RowView& row, size_t i, int& out) {
+        if (i >= row.count) return false;
+        int v = 0;
+        auto r = std::from_chars(row.begin[i], row.begin[i] + row.len[i], v);
+        if (r.ec != std::errc() || r.ptr == row.begin[i]) return false;
+        out = v;
+        return true;
+    }
+
+    // 与 parseCSV 的 stod 语义一致：缺失或非法时取 0
+    static double parseDouble(const RowView& row, size_t i) {
+        if (i >= row.count) return 0.0;
+        double v = 0.0;
+        auto r = std::from_chars(row.begin[i], row.begin[i] + row.len[i], v);
+        if (r.ec != std::errc()) return 0.0;
+        return v;
+    }
+};
+
+#endif // STREAMINGQUERY_H
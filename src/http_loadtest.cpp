@@ -0,0 +1,177 @@
+/**
+ * HTTP 查询服务压测客户端
+ *
+ * 每个线程维持一条 keep-alive 连接，以流水线方式一次发送 depth 个
+ * GET /employees/{id} 请求，再读回全部响应，持续指定秒数后汇总吞吐量。
+ *
+ * 用法: http_loadtest [端口] [线程数] [流水线深度] [秒数] [最大编号]
+ * 示例: http_loadtest 8080 4 32 10 8
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <cstring>
+#include <cstdlib>
+
+#ifdef __linux__
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#endif
+
+struct WorkerResult {
+    unsigned long long ok = 0;
+    unsigned long long notFound = 0;
+    unsigned long long failed = 0;
+    double batchLatencySum = 0.0;  // 秒
+    unsigned long long batches = 0;
+};
+
+#ifdef __linux__
+static int connectTo(int port) {
+    int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(port));
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+        ::close(fd);
+        return -1;
+    }
+    int one = 1;
+    ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    return fd;
+}
+
+// 从 buf 中解析完整响应，返回解析出的个数；status 依次写入 statuses
+static int drainResponses(std::string& buf, std::vector<int>& statuses) {
+    int parsed = 0;
+    size_t pos = 0;
+    while (true) {
+        size_t headerEnd = buf.find("\r\n\r\n", pos);
+        if (headerEnd == std::string::npos) break;
+        size_t cl = buf.find("Content-Length:", pos);
+        if (cl == std::string::npos || cl > headerEnd) break;
+        size_t len = std::strtoul(buf.c_str() + cl + 15, nullptr, 10);
+        size_t end = headerEnd + 4 + len;
+        if (end > buf.size()) break;
+        statuses.push_back(std::atoi(buf.c_str() + pos + 9));  // "HTTP/1.1 " 之后
+        pos = end;
+        ++parsed;
+    }
+    buf.erase(0, pos);
+    return parsed;
+}
+
+static void worker(int port, int depth, int maxId, unsigned seed,
+                   std::atomic<bool>& running, WorkerResult& result) {
+    int fd = connectTo(port);
+    if (fd < 0) {
+        result.failed++;
+        return;
+    }
+
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> pick(1, maxId > 0 ? maxId : 1);
+    std::string request;
+    std::string buf;
+    std::vector<int> statuses;
+    char chunk[64 * 1024];
+
+    while (running) {
+        request.clear();
+        for (int i = 0; i < depth; ++i) {
+            request += "GET /employees/";
+            request += std::to_string(pick(rng));
+            request += " HTTP/1.1\r\nHost: 127.0.0.1\r\n\r\n";
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        size_t sent = 0;
+        while (sent < request.size()) {
+            ssize_t w = ::send(fd, request.data() + sent, request.size() - sent, MSG_NOSIGNAL);
+            if (w <= 0) { result.failed++; ::close(fd); return; }
+            sent += static_cast<size_t>(w);
+        }
+
+        int received = 0;
+        statuses.clear();
+        while (received < depth) {
+            ssize_t r = ::recv(fd, chunk, sizeof(chunk), 0);
+            if (r <= 0) { result.failed++; ::close(fd); return; }
+            buf.append(chunk, static_cast<size_t>(r));
+            received += drainResponses(buf, statuses);
+        }
+        auto end = std::chrono::steady_clock::now();
+
+        for (int s : statuses) {
+            if (s == 200) result.ok++;
+            else if (s == 404) result.notFound++;
+            else result.failed++;
+        }
+        result.batchLatencySum += std::chrono::duration<double>(end - start).count();
+        result.batches++;
+    }
+    ::close(fd);
+}
+#endif
+
+int main(int argc, char* argv[]) {
+#ifdef __linux__
+    int port = argc > 1 ? std::atoi(argv[1]) : 8080;
+    int threads = argc > 2 ? std::atoi(argv[2]) : 4;
+    int depth = argc > 3 ? std::atoi(argv[3]) : 32;
+    int seconds = argc > 4 ? std::atoi(argv[4]) : 10;
+    int maxId = argc > 5 ? std::atoi(argv[5]) : 8;
+    if (threads < 1) threads = 1;
+    if (depth < 1) depth = 1;
+
+    std::cout << "压测 127.0.0.1:" << port << " 线程 " << threads
+              << " 流水线深度 " << depth << " 时长 " << seconds << " 秒" << std::endl;
+
+    std::atomic<bool> running(true);
+    std::vector<WorkerResult> results(threads);
+    std::vector<std::thread> pool;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < threads; ++i) {
+        pool.emplace_back(worker, port, depth, maxId, 1234u + i, std::ref(running), std::ref(results[i]));
+    }
+    std::this_thread::sleep_for(std::chrono::seconds(seconds));
+    running = false;
+    for (auto& t : pool) t.join();
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    WorkerResult total;
+    for (const auto& r : results) {
+        total.ok += r.ok;
+        total.notFound += r.notFound;
+        total.failed += r.failed;
+        total.batchLatencySum += r.batchLatencySum;
+        total.batches += r.batches;
+    }
+    unsigned long long done = total.ok + total.notFound;
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "完成请求: " << done << " (200: " << total.ok << ", 404: " << total.notFound
+              << ", 失败: " << total.failed << ")" << std::endl;
+    std::cout << "吞吐量: " << done / elapsed << " 请求/秒" << std::endl;
+    if (total.batches > 0) {
+        std::cout << "平均批次往返: " << std::setprecision(3)
+                  << total.batchLatencySum / total.batches * 1000 << " 毫秒" << std::endl;
+    }
+    return total.failed > 0 ? 1 : 0;
+#else
+    (void)argc; (void)argv;
+    std::cout << "压测客户端仅支持 Linux。" << std::endl;
+    return 1;
+#endif
+}
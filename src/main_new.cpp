@@ -9,17 +9,383 @@
  *   └── PartTimeSalesperson (兼职推销员 - 按销售提成)
  * - EmployeeManager (员工管理类 - CRUD/统计/持久化)
  * 
- * 数据持久化：CSV 文件
+ * 数据持久化：CSV 文件，按编号分片的 CSV 目录，或 Arrow IPC 列式文件
+ *
+ * 运行方式（均可在最前面加 --data 路径 指定数据文件/分片目录；
+ *          加 --cdc 日志文件 [--cdc-socket 套接字] 记录变更事件，适用于交互式菜单、服务模式与合并）：
+ *   hr                                   交互式菜单（登录期间后台加载数据）
+ *   hr --lazy                            交互式菜单，延迟解析（启动只索引行位置与编号）
+ *   hr --serve [端口] [线程数]            HTTP/JSON 查询服务（默认 8080 端口）
+ *   hr --to-shards 目录 分片数 [hash|range] 将当前数据迁移为分片目录
+ *   hr --to-csv 文件                      将当前数据合并为单个 CSV 文件
+ *   hr --to-arrow 文件                    将当前数据导出为 Arrow IPC 列式文件（--data 指定 .arrow 文件时直接加载/保存）
+ *   hr --stream-stats [--top K] [--role 岗位] [--gender 性别] [--min-level N] [--max-level N]
+ *                                        流式统计（不载入内存，适合超大文件）
+ *   hr --diff 旧花名册 新花名册 [变更集文件]  比对两份花名册，输出新增/删除/变更并可写出变更集
+ *   hr --apply 变更集文件                  将变更集原地应用到当前数据（分片目录只重写涉及的分片）
+ *   hr --merge 新花名册                    比对当前数据与新花名册并原地应用差异
+ *   hr --cdc-tail 日志文件 [起始序号] [--follow]  从指定序号起输出变更事件，--follow 时持续跟随
+ *   hr --validate [--report 文件] [--repair 输出文件] [--limit N]
+ *                                        校验当前数据，可写出问题清单与修复后的花名册
  */
 
 #include <iostream>
 #include <string>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <iomanip>
+#include <csignal>
 
 #ifdef _WIN32
 #include <windows.h>
 #endif
 
 #include "EmployeeManager.h"
+#include "HttpServer.h"
+#include "StreamingQuery.h"
+#include "RosterValidator.h"
+#include "BackgroundLoader.h"
+
+// 确定数据路径：优先 --data 指定的路径，其次分片目录，最后单个 CSV 文件
+// （兼容在仓库根目录或 build 目录下运行）
+std::string resolveDataPath(const std::string& explicitPath) {
+    if (!explicitPath.empty()) return explicitPath;
+    for (const char* dir : {"data/employees.shards", "../data/employees.shards"}) {
+        if (ShardedStore::isShardedPath(dir)) return dir;
+    }
+
+    std::string csvPath = "data/employees.csv";
+    std::ifstream test(csvPath);
+    if (!test.is_open()) {
+        csvPath = "../data/employees.csv";
+    }
+    return csvPath;
+}
+
+static HttpServer* g_server = nullptr;
+
+// 变更数据捕获的目标（--cdc / --cdc-socket），日志为空表示未开启
+struct CdcOptions {
+    std::string logPath;
+    std::string socketPath;
+};
+static CdcOptions g_cdc;
+
+// 按命令行选项为管理器开启变更数据捕获，失败时输出原因
+static bool enableChangeFeed(EmployeeManager& manager) {
+    if (g_cdc.logPath.empty()) return true;
+    std::string error;
+    if (!manager.enableChangeFeed(g_cdc.logPath, g_cdc.socketPath, &error)) {
+        std::cout << error << std::endl;
+        return false;
+    }
+    std::cout << "变更日志: " << g_cdc.logPath << "（下一个序号 "
+              << manager.changeFeed()->lastPublished() + 1 << "）" << std::endl;
+    return true;
+}
+
+static void handleStopSignal(int) {
+    if (g_server) g_server->stop();
+}
+
+// 服务模式：加载数据后启动 HTTP 服务，直到收到 SIGINT/SIGTERM
+int runServer(const std::string& csvPath, const std::vector<std::string>& args) {
+    int port = 8080;
+    int workers = static_cast<int>(std::thread::hardware_concurrency());
+    try {
+        if (args.size() > 1) port = std::stoi(args[1]);
+        if (args.size() > 2) workers = std::stoi(args[2]);
+    } catch (...) {
+        std::cout << "用法: hr --serve [端口] [线程数]" << std::endl;
+        return 1;
+    }
+
+    std::cout << "数据文件: " << csvPath << std::endl;
+
+    EmployeeManager manager(csvPath);
+    manager.load();
+    manager.setVerbose(false);
+    if (!enableChangeFeed(manager)) return 1;
+
+    HttpServer server(manager, port, workers);
+    g_server = &server;
+    std::signal(SIGINT, handleStopSignal);
+    std::signal(SIGTERM, handleStopSignal);
+    bool ok = server.run();
+    g_server = nullptr;
+    return ok ? 0 : 1;
+}
+
+// 布局迁移：单文件 <-> 分片目录，或导出为列式文件
+int runMigration(const std::string& csvPath, const std::vector<std::string>& args) {
+    EmployeeManager manager(csvPath);
+    manager.load();
+
+    if (args[0] == "--to-shards") {
+        size_t shards = 0;
+        try { if (args.size() > 2) shards = std::stoul(args[2]); } catch (...) {}
+        std::string mode = args.size() > 3 ? args[3] : "hash";
+        if (shards == 0 || (mode != "hash" && mode != "range")) {
+            std::cout << "用法: hr --to-shards 目录 分片数 [hash|range]" << std::endl;
+            return 1;
+        }
+        auto partition = (mode == "range") ? ShardedStore::Partition::Range
+                                           : ShardedStore::Partition::Hash;
+        if (!manager.exportSharded(args[1], shards, partition)) {
+            std::cout << "迁移失败: 无法写入 " << args[1] << std::endl;
+            return 1;
+        }
+        std::cout << "已写入分片目录 " << args[1] << " (" << shards << " 个分片, " << mode << ")" << std::endl;
+        return 0;
+    }
+
+    if (args[0] == "--to-arrow") {
+        if (args.size() < 2) {
+            std::cout << "用法: hr --to-arrow 文件" << std::endl;
+            return 1;
+        }
+        if (!manager.exportArrow(args[1])) {
+            std::cout << "导出失败: 无法写入 " << args[1] << std::endl;
+            return 1;
+        }
+        std::cout << "已写入列式文件 " << args[1] << std::endl;
+        return 0;
+    }
+
+    if (args.size() < 2) {
+        std::cout << "用法: hr --to-csv 文件" << std::endl;
+        return 1;
+    }
+    if (!manager.exportCSV(args[1])) {
+        std::cout << "迁移失败: 无法写入 " << args[1] << std::endl;
+        return 1;
+    }
+    std::cout << "已写入单文件 " << args[1] << std::endl;
+    return 0;
+}
+
+// 流式统计：逐行扫描数据文件，输出与菜单统计/排名相同的报告
+int runStreamingStats(const std::string& csvPath, const std::vector<std::string>& args) {
+    StreamingQuery::Filter filter;
+    size_t topK = 10;
+    try {
+        for (size_t i = 1; i + 1 < args.size(); i += 2) {
+            const std::string& key = args[i];
+            const std::string& value = args[i + 1];
+            if (key == "--top") topK = std::stoul(value);
+            else if (key == "--role") filter.role = value;
+            else if (key == "--gender") filter.gender = value;
+            else if (key == "--min-level") filter.minLevel = std::stoi(value);
+            else if (key == "--max-level") filter.maxLevel = std::stoi(value);
+            else throw std::invalid_argument(key);
+        }
+        if (args.size() % 2 == 0) throw std::invalid_argument("参数不成对");
+    } catch (...) {
+        std::cout << "用法: hr --stream-stats [--top K] [--role 岗位] [--gender 性别] "
+                     "[--min-level N] [--max-level N]" << std::endl;
+        return 1;
+    }
+
+    std::cout << "数据文件: " << csvPath << std::endl;
+    StreamingQuery query(topK, filter);
+    std::string error;
+    roster_io::ReadStatus status = query.run(csvPath, &error);
+    if (status == roster_io::ReadStatus::NotFound) {
+        std::cout << "数据文件不存在: " << csvPath << std::endl;
+        return 1;
+    }
+    query.printReport();
+    if (status == roster_io::ReadStatus::Corrupt) {
+        std::cout << "数据文件损坏（" << error << "），以上为可读部分的结果。" << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+// 打开一份花名册快照，失败时输出原因
+static bool openSnapshot(roster_diff::Snapshot& snapshot, const std::string& path) {
+    std::string error;
+    roster_io::ReadStatus status = snapshot.open(path, &error);
+    if (status == roster_io::ReadStatus::NotFound) {
+        std::cout << "花名册不存在: " << path << std::endl;
+        return false;
+    }
+    if (status == roster_io::ReadStatus::Corrupt) {
+        std::cout << "花名册损坏（" << error << "）: " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+static double millisecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// 比对两份花名册并输出摘要；outPath 非空时写出变更集
+static bool diffRosters(const std::string& beforePath, const std::string& afterPath,
+                        roster_diff::ChangeSet& changes, const std::string& outPath) {
+    auto start = std::chrono::steady_clock::now();
+    roster_diff::Snapshot before, after;
+    if (!openSnapshot(before, beforePath) || !openSnapshot(after, afterPath)) return false;
+    roster_diff::DiffSummary summary;
+    changes = roster_diff::diff(before, after, &summary);
+
+    std::cout << std::fixed << std::setprecision(1)
+              << "比对完成（" << summary.before << " -> " << summary.after << " 人，耗时 "
+              << millisecondsSince(start) << " ms）: 新增 " << changes.added.size()
+              << "，删除 " << changes.removed.size() << "，变更 " << changes.changed.size()
+              << "，未变 " << summary.unchanged << std::endl;
+    if (!outPath.empty()) {
+        if (!changes.write(outPath)) {
+            std::cout << "无法写入变更集: " << outPath << std::endl;
+            return false;
+        }
+        std::cout << "变更集已写入 " << outPath << std::endl;
+    }
+    return true;
+}
+
+// 花名册比对：hr --diff 旧花名册 新花名册 [变更集文件]
+int runDiff(const std::vector<std::string>& args) {
+    if (args.size() < 3 || args.size() > 4) {
+        std::cout << "用法: hr --diff 旧花名册 新花名册 [变更集文件]" << std::endl;
+        return 1;
+    }
+    roster_diff::ChangeSet changes;
+    return diffRosters(args[1], args[2], changes, args.size() > 3 ? args[3] : "") ? 0 : 1;
+}
+
+// 原地合并：hr --apply 变更集文件，或 hr --merge 新花名册（先与当前数据比对）
+int runMerge(const std::string& csvPath, const std::vector<std::string>& args) {
+    if (args.size() != 2) {
+        std::cout << "用法: hr --apply 变更集文件 | hr --merge 新花名册" << std::endl;
+        return 1;
+    }
+
+    roster_diff::ChangeSet changes;
+    if (args[0] == "--merge") {
+        if (!diffRosters(csvPath, args[1], changes, "")) return 1;
+    } else {
+        std::string error;
+        roster_io::ReadStatus status = changes.read(args[1], &error);
+        if (status != roster_io::ReadStatus::Ok) {
+            std::cout << (status == roster_io::ReadStatus::NotFound ? "变更集不存在: " + args[1]
+                                                                    : "变更集格式错误（" + error + "）")
+                      << std::endl;
+            return 1;
+        }
+    }
+    if (changes.empty()) {
+        std::cout << "没有需要应用的变更。" << std::endl;
+        return 0;
+    }
+
+    EmployeeManager manager(csvPath);
+    manager.load();
+    if (!enableChangeFeed(manager)) return 1;
+    auto start = std::chrono::steady_clock::now();
+    EmployeeManager::ApplyResult result = manager.applyChanges(changes);
+    std::cout << std::fixed << std::setprecision(1)
+              << "已应用变更集（耗时 " << millisecondsSince(start) << " ms）: 新增 " << result.added
+              << "，删除 " << result.removed << "，变更 " << result.changed;
+    if (result.failed) std::cout << "，失败 " << result.failed;
+    std::cout << std::endl;
+    manager.save();
+    return result.failed ? 1 : 0;
+}
+
+// 变更日志跟随：hr --cdc-tail 日志文件 [起始序号] [--follow]
+int runChangeTail(const std::vector<std::string>& args) {
+    uint64_t from = 1;
+    bool follow = false;
+    bool ok = args.size() >= 2;
+    for (size_t i = 2; ok && i < args.size(); ++i) {
+        if (args[i] == "--follow") {
+            follow = true;
+        } else {
+            try { from = std::stoull(args[i]); } catch (...) { ok = false; }
+        }
+    }
+    ChangeLogReader reader;
+    if (!ok) {
+        std::cout << "用法: hr --cdc-tail 日志文件 [起始序号] [--follow]" << std::endl;
+        return 1;
+    }
+    if (!reader.open(args[1]) && !follow) {
+        std::cout << "变更日志不存在: " << args[1] << std::endl;
+        return 1;
+    }
+
+    reader.seek(from);
+    auto print = [](uint64_t, const std::string& line) { std::cout << line << '\n'; };
+    while (true) {
+        reader.poll(print);
+        std::cout.flush();
+        if (!follow) return 0;
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    }
+}
+
+// 数据校验：hr --validate [--report 文件] [--repair 输出文件] [--limit N]
+int runValidate(const std::string& csvPath, const std::vector<std::string>& args) {
+    validate::Options options;
+    std::string reportPath;
+    size_t limit = 20;
+    bool ok = args.size() % 2 == 1;
+    for (size_t i = 1; ok && i + 1 < args.size(); i += 2) {
+        const std::string& key = args[i];
+        const std::string& value = args[i + 1];
+        if (key == "--report") reportPath = value;
+        else if (key == "--repair") options.repairPath = value;
+        else if (key == "--limit") {
+            try { limit = std::stoul(value); } catch (...) { ok = false; }
+        } else {
+            ok = false;
+        }
+    }
+    if (!ok) {
+        std::cout << "用法: hr --validate [--report 文件] [--repair 输出文件] [--limit N]" << std::endl;
+        return 1;
+    }
+
+    std::cout << "数据文件: " << csvPath << std::endl;
+    auto start = std::chrono::steady_clock::now();
+    validate::RosterValidator validator;
+    std::string error;
+    roster_io::ReadStatus status = validator.open(csvPath, &error);
+    if (status == roster_io::ReadStatus::NotFound) {
+        std::cout << "数据文件不存在: " << csvPath << std::endl;
+        return 1;
+    }
+    if (status == roster_io::ReadStatus::Corrupt) {
+        std::cout << "数据文件损坏（" << error << "）: " << csvPath << std::endl;
+        return 1;
+    }
+    validate::Report report;
+    if (!validator.run(options, report, &error)) {
+        std::cout << error << std::endl;
+        return 1;
+    }
+    double elapsed = millisecondsSince(start);
+    report.print(std::cout, limit);
+    std::cout << std::fixed << std::setprecision(1) << "耗时 " << elapsed << " ms" << std::endl;
+    if (report.truncated) std::cout << "问题过多，明细只保留前 " << options.maxFindings << " 条。" << std::endl;
+
+    if (!reportPath.empty()) {
+        if (!report.writeCSV(reportPath)) {
+            std::cout << "无法写入问题清单: " << reportPath << std::endl;
+            return 1;
+        }
+        std::cout << "问题清单已写入 " << reportPath << std::endl;
+    }
+    if (!options.repairPath.empty()) {
+        std::cout << "修复后的花名册已写入 " << options.repairPath << "（" << report.rows - report.rejectedRows
+                  << " 行），需人工处理的 " << report.rejectedRows << " 行写入 "
+                  << options.repairPath << ".rejects" << std::endl;
+    }
+    return report.clean() ? 0 : 2;
+}
 
 void showMenu() {
     std::cout << "\n╔══════════════════════════════════════╗\n"
@@ -34,19 +400,89 @@ void showMenu() {
               << "║  7. 全员提级                         ║\n"
               << "║  8. 业绩排名                         ║\n"
               << "║  9. 生日提醒                         ║\n"
+              << "║  10. 运行指标                        ║\n"
+              << "║  11. 条件查询                        ║\n"
+              << "║  12. 分组透视报表                    ║\n"
+              << "║  13. 排名与分位查询                  ║\n"
+              << "║  14. 薪资分布                        ║\n"
+              << "║  15. 汇报关系                        ║\n"
               << "║  0. 退出系统                         ║\n"
               << "╚══════════════════════════════════════╝\n"
-              << "请选择(0-9): ";
+              << "请选择(0-15): ";
     std::cout.flush();
 }
 
-int main() {
+// 菜单项 1-15 都要用到员工数据，执行前须等待后台加载完成
+static bool isMenuAction(const std::string& choice) {
+    for (int item = 1; item <= 15; ++item) {
+        if (choice == std::to_string(item)) return true;
+    }
+    return false;
+}
+
+int main(int argc, char* argv[]) {
 #ifdef _WIN32
     // 设置 Windows 控制台使用 UTF-8 编码
     SetConsoleOutputCP(65001);
     SetConsoleCP(65001);
 #endif
 
+    std::vector<std::string> args(argv + 1, argv + argc);
+    std::string dataPath;
+    if (args.size() >= 2 && args[0] == "--data") {
+        dataPath = args[1];
+        args.erase(args.begin(), args.begin() + 2);
+    }
+    while (args.size() >= 2 && (args[0] == "--cdc" || args[0] == "--cdc-socket")) {
+        (args[0] == "--cdc" ? g_cdc.logPath : g_cdc.socketPath) = args[1];
+        args.erase(args.begin(), args.begin() + 2);
+    }
+    if (!g_cdc.socketPath.empty() && g_cdc.logPath.empty()) {
+        std::cout << "--cdc-socket 须与 --cdc 一同使用。" << std::endl;
+        return 1;
+    }
+    bool lazy = false;
+    if (!args.empty() && args[0] == "--lazy") {
+        lazy = true;
+        args.erase(args.begin());
+    }
+    if (lazy && !args.empty()) {
+        std::cout << "--lazy 只用于交互式菜单。" << std::endl;
+        return 1;
+    }
+    if (!args.empty()) {
+        if (args[0] == "--serve") {
+            return runServer(resolveDataPath(dataPath), args);
+        }
+        if (args[0] == "--to-shards" || args[0] == "--to-csv" || args[0] == "--to-arrow") {
+            return runMigration(resolveDataPath(dataPath), args);
+        }
+        if (args[0] == "--stream-stats") {
+            return runStreamingStats(resolveDataPath(dataPath), args);
+        }
+        if (args[0] == "--diff") {
+            return runDiff(args);
+        }
+        if (args[0] == "--apply" || args[0] == "--merge") {
+            return runMerge(resolveDataPath(dataPath), args);
+        }
+        if (args[0] == "--cdc-tail") {
+            return runChangeTail(args);
+        }
+        if (args[0] == "--validate") {
+            return runValidate(resolveDataPath(dataPath), args);
+        }
+        std::cout << "未知参数: " << args[0] << std::endl;
+        return 1;
+    }
+
+    // 确定数据文件路径，登录前即开始后台加载
+    std::string csvPath = resolveDataPath(dataPath);
+    EmployeeManager manager(csvPath);
+    manager.setLazy(lazy);
+    BackgroundLoader loader(manager);
+    loader.start();
+
     std::cout << "╔══════════════════════════════════════╗\n"
               << "║     企业人力管理系统 - 登录          ║\n"
               << "╚══════════════════════════════════════╝\n";
@@ -77,28 +513,23 @@ int main() {
                 std::string dummy;
                 std::getline(std::cin, dummy);
 #endif
-                return 1;
+                return loader.finish(1);
             }
         }
     }
 
-    // 确定数据文件路径
-    std::string csvPath = "data/employees.csv";
-    {
-        std::ifstream test(csvPath);
-        if (!test.is_open()) {
-            csvPath = "../data/employees.csv";
-        }
-    }
-
     std::cout << "╔══════════════════════════════════════╗\n"
               << "║     欢迎使用企业人力管理系统         ║\n"
               << "╚══════════════════════════════════════╝\n";
     std::cout << "数据文件: " << csvPath << std::endl;
 
-    // 创建员工管理器并加载数据
-    EmployeeManager manager(csvPath);
-    manager.load();
+    // 小文件此时早已加载完成，输出与同步加载相同；大文件继续在后台加载，菜单操作前再等待
+    if (loader.waitFor(std::chrono::milliseconds(200))) {
+        loader.wait();
+    } else {
+        std::cout << "数据正在后台加载，可先选择菜单项。" << std::endl;
+    }
+    if (!enableChangeFeed(manager)) return loader.finish(1);
 
     // 主循环
     while (true) {
@@ -113,6 +544,7 @@ int main() {
         }
 
         if (choice.empty()) continue;
+        if (isMenuAction(choice)) loader.wait();
 
         if (choice == "1") {
             manager.addEmployee();
@@ -132,6 +564,18 @@ int main() {
             manager.ranking();
         } else if (choice == "9") {
             manager.birthdayReminder();
+        } else if (choice == "10") {
+            manager.showMetrics();
+        } else if (choice == "11") {
+            manager.queryEmployees();
+        } else if (choice == "12") {
+            manager.pivotReport();
+        } else if (choice == "13") {
+            manager.rankQuery();
+        } else if (choice == "14") {
+            manager.distributionReport();
+        } else if (choice == "15") {
+            manager.reportingReport();
         } else if (choice == "0" || choice == "q" || choice == "Q") {
             break;
         } else {
@@ -147,5 +591,5 @@ int main() {
     std::getline(std::cin, dummy);
 #endif
 
-    return 0;
+    return loader.finish(0);
 }